@@ -25,51 +25,71 @@ AMAppItem::AMAppItem(const QDBusObjectPath &path, QObject *parent)
 }
 
 AMAppItem::AMAppItem(const QDBusObjectPath &path, const ObjectInterfaceMap &source, QObject *parent)
-    : AMAppItem(path, parent)
+    : AMAppItem(parseData(path, source), parent)
 {
+}
+
+AMAppItem::AMAppItem(const AMAppItemData &data, QObject *parent)
+    : AMAppItem(data.path, parent)
+{
+    if (!data.hasAppInfo)
+        return;
+
+    AppItem::setAppName(data.name);
+    AppItem::setGenericName(data.genericName);
+    AppItem::setAppIconName(data.iconName);
+    AppItem::setNoDisPlay(data.noDisplay);
+    AppItem::setDDECategories(data.ddeCategory);
+    AppItem::setLastLaunchedTime(data.lastLaunchedTime);
+    AppItem::setInstalledTime(data.installedTime);
+    AppItem::setStartupWMclass(data.startupWMClass);
+    AppItem::setAutoStart(data.autoStart);
+    AppItem::setOnDesktop(data.onDesktop);
+    if (!data.actions.isEmpty()) {
+        AppItem::setActions(data.actions);
+    }
+}
+
+AMAppItemData AMAppItem::parseData(const QDBusObjectPath &path, const ObjectInterfaceMap &source)
+{
+    AMAppItemData data;
+    data.path = path;
+    data.desktopId = DUtil::unescapeFromObjectPath(path.path().split('/').last());
+
     const QVariantMap appInfo = source.value("org.desktopspec.ApplicationManager1.Application");
     if (appInfo.isEmpty())
-        return;
+        return data;
+    data.hasAppInfo = true;
 
     auto name = getLocaleOrDefaultValue(qdbus_cast<QStringMap>(appInfo.value(u8"Name")), locale, DEFAULT_KEY);
     auto genericName = getLocaleOrDefaultValue(qdbus_cast<QStringMap>(appInfo.value(u8"GenericName")), locale, DEFAULT_KEY);
     auto xDeepinVendor = appInfo.value(u8"X_Deepin_Vendor").toString();
 
     if (QStringLiteral("deepin") == xDeepinVendor && !genericName.isEmpty()) {
-        AppItem::setAppName(genericName);
+        data.name = genericName;
     } else {
-        AppItem::setAppName(name);
+        data.name = name;
     }
+    data.genericName = genericName;
 
-    auto iconName = getLocaleOrDefaultValue(qdbus_cast<QStringMap>(appInfo.value(u8"Icons")), DESKTOP_ENTRY_ICON_KEY, "");
-    AppItem::setAppIconName(iconName);
-
-    auto noDisplay = appInfo.value(u8"NoDisplay").toBool();
-    AppItem::setNoDisPlay(noDisplay);
+    data.iconName = getLocaleOrDefaultValue(qdbus_cast<QStringMap>(appInfo.value(u8"Icons")), DESKTOP_ENTRY_ICON_KEY, "");
+    data.noDisplay = appInfo.value(u8"NoDisplay").toBool();
 
     auto categories = appInfo.value(u8"Categories").toStringList();
-    AppItem::setDDECategories(AppItemModel::DDECategories(CategoryUtils::parseBestMatchedCategory(categories)));
-
-    auto lastLaunchedTime = appInfo.value(u8"LastLaunchedTime").toULongLong();
-    AppItem::setLastLaunchedTime(lastLaunchedTime);
+    data.ddeCategory = AppItemModel::DDECategories(CategoryUtils::parseBestMatchedCategory(categories));
 
-    auto installedTime = appInfo.value(u8"InstalledTime").toULongLong();
-    AppItem::setInstalledTime(installedTime);
-
-    auto startUpWMClass = appInfo.value(u8"StartupWMClass").toString();
-    AppItem::setStartupWMclass(startUpWMClass);
-
-    auto autoStart = appInfo.value(u8"AutoStart").toBool();
-    AppItem::setAutoStart(autoStart);
-
-    auto isOnDesktop = appInfo.value(u8"OnDesktop").toBool();
-    AppItem::setOnDesktop(isOnDesktop);
+    data.lastLaunchedTime = appInfo.value(u8"LastLaunchedTime").toULongLong();
+    data.installedTime = appInfo.value(u8"InstalledTime").toULongLong();
+    data.startupWMClass = appInfo.value(u8"StartupWMClass").toString();
+    data.autoStart = appInfo.value(u8"AutoStart").toBool();
+    data.onDesktop = appInfo.value(u8"OnDesktop").toBool();
 
     PropMap actionName;
     appInfo.value(u8"ActionName").value<QDBusArgument>() >> actionName;
 
     auto actions = appInfo.value(u8"Actions").toStringList();
-    updateActions(actions, actionName);
+    data.actions = actionsToJson(actions, actionName);
+    return data;
 }
 
 void AMAppItem::launch(const QString &action, const QStringList &fields, const QVariantMap &options)
@@ -120,6 +140,7 @@ void AMAppItem::onPropertyChanged(const QDBusMessage &msg)
     } else {
         AppItem::setAppName(name);
     }
+    AppItem::setGenericName(genericName);
 
     auto iconName = getLocaleOrDefaultValue(Application::icons(), DESKTOP_ENTRY_ICON_KEY, "");
     AppItem::setAppIconName(iconName);
@@ -137,8 +158,11 @@ void AMAppItem::onPropertyChanged(const QDBusMessage &msg)
     updateActions(actions, actionName);
 }
 
-void AMAppItem::updateActions(const QStringList &actions, const PropMap &actionName)
+QString AMAppItem::actionsToJson(const QStringList &actions, const PropMap &actionName)
 {
+    if (actions.isEmpty())
+        return QString();
+
     QJsonArray actionsArray;
     for (auto action : actions) {
         auto localeNames = actionName.value(action);
@@ -147,8 +171,14 @@ void AMAppItem::updateActions(const QStringList &actions, const PropMap &actionN
         actionObject.insert(QStringLiteral("name"), getLocaleOrDefaultValue(localeNames, action, DEFAULT_KEY));
         actionsArray.append(actionObject);
     }
-    if (actions.size() > 0) {
-        AppItem::setActions(QJsonDocument(actionsArray).toJson());
+    return QJsonDocument(actionsArray).toJson();
+}
+
+void AMAppItem::updateActions(const QStringList &actions, const PropMap &actionName)
+{
+    const auto json = actionsToJson(actions, actionName);
+    if (!json.isEmpty()) {
+        AppItem::setActions(json);
     }
 }
 }
@@ -9,6 +9,27 @@
 
 namespace apps
 {
+// The static desktop entry data of an application from the managed objects of AM,
+// it's plain data and can be built on a worker thread.
+struct AMAppItemData
+{
+    QDBusObjectPath path;
+    QString desktopId;
+    bool hasAppInfo = false;
+    QString name;
+    QString genericName;
+    QString iconName;
+    bool noDisplay = false;
+    AppItemModel::DDECategories ddeCategory = AppItemModel::Others;
+    quint64 lastLaunchedTime = 0;
+    quint64 installedTime = 0;
+    QString startupWMClass;
+    bool autoStart = false;
+    bool onDesktop = false;
+    // it's empty if the application hasn't any action.
+    QString actions;
+};
+
 class AMAppItem : public Application, public AppItem
 {
     Q_OBJECT
@@ -16,13 +37,17 @@ class AMAppItem : public Application, public AppItem
 public:
     explicit AMAppItem(const QDBusObjectPath &path, QObject *parent = nullptr);
     explicit AMAppItem(const QDBusObjectPath &path, const ObjectInterfaceMap &source, QObject *parent = nullptr);
+    explicit AMAppItem(const AMAppItemData &data, QObject *parent = nullptr);
+
+    static AMAppItemData parseData(const QDBusObjectPath &path, const ObjectInterfaceMap &source);
 
     void launch(const QString &action = {}, const QStringList &fields = {}, const QVariantMap &options = {}) override;
     void setAutoStart(bool autoStart) override;
     void setOnDesktop(bool on) override;
 
 private:
-    QString getLocaleOrDefaultValue(const QStringMap &value, const QString &targetKey, const QString &fallbackKey);
+    static QString getLocaleOrDefaultValue(const QStringMap &value, const QString &targetKey, const QString &fallbackKey);
+    static QString actionsToJson(const QStringList &actions, const PropMap &actionName);
     void updateActions(const QStringList &actions, const PropMap &actionName);
 
 private Q_SLOTS:
@@ -15,9 +15,12 @@ Q_LOGGING_CATEGORY(appsLog, "dde.shell.dde-apps.amappitemmodel")
 
 namespace apps
 {
+static const QString AMService = QStringLiteral("org.desktopspec.ApplicationManager1");
+static const QString AMPath = QStringLiteral("/org/desktopspec/ApplicationManager1");
+
 AMAppItemModel::AMAppItemModel(QObject *parent)
     : AppItemModel(parent)
-    , m_manager(new ObjectManager("org.desktopspec.ApplicationManager1", "/org/desktopspec/ApplicationManager1", QDBusConnection::sessionBus()))
+    , m_manager(new ObjectManager(AMService, AMPath, QDBusConnection::sessionBus(), this))
 {
     qRegisterMetaType<ObjectInterfaceMap>();
     qDBusRegisterMetaType<ObjectInterfaceMap>();
@@ -29,47 +32,79 @@ AMAppItemModel::AMAppItemModel(QObject *parent)
     qDBusRegisterMetaType<PropMap>();
     qDBusRegisterMetaType<QDBusObjectPath>();
 
+    connect(this, &QAbstractItemModel::rowsAboutToBeRemoved, this, [this](const QModelIndex &parent, int first, int last) {
+        if (parent.isValid())
+            return;
+        for (int i = first; i <= last; i++) {
+            m_items.remove(index(i, 0).data(AppItemModel::DesktopIdRole).toString());
+        }
+    });
+
     connect(m_manager, &ObjectManager::InterfacesAdded, this, [this](const QDBusObjectPath &objPath, ObjectInterfaceMap interfacesAndProperties) {
         auto desktopId = DUtil::unescapeFromObjectPath(objPath.path().split('/').last());
-        if (!match(index(0, 0), AppItemModel::DesktopIdRole, desktopId).isEmpty()) {
+        if (m_items.contains(desktopId)) {
             qCWarning(appsLog()) << "desktopId: " << desktopId << " already contains";
             return;
         }
-        appendRow(new AMAppItem(objPath, interfacesAndProperties));
+        auto item = new AMAppItem(objPath, interfacesAndProperties);
+        m_items.insert(desktopId, item);
+        appendRow(item);
     });
 
     connect(m_manager, &ObjectManager::InterfacesRemoved, this, [this](const QDBusObjectPath &objPath, const QStringList &interfaces) {
         auto desktopId = DUtil::unescapeFromObjectPath(objPath.path().split('/').last());
-        auto res = match(index(0, 0), AppItemModel::DesktopIdRole, desktopId);
-        if (res.isEmpty()) {
+        auto item = m_items.value(desktopId);
+        if (!item) {
             qCWarning(appsLog()) << "failed find desktopId: " << desktopId;
             return;
         }
-        removeRow(res.first().row());
+        removeRow(item->row());
     });
 
-    // load static desktop info from am
-    auto future = QtConcurrent::run([this]() {
-        auto apps = m_manager->GetManagedObjects().value();
-
+    // load static desktop info from am, the worker only parses the data, items are created
+    // and inserted on the thread of the model. The worker doesn't touch the model or its manager,
+    // the watcher is owned by the model, so the result is dropped if the model is destroyed meanwhile.
+    auto watcher = new QFutureWatcher<QList<AMAppItemData>>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher]() {
+        watcher->deleteLater();
+        appendItems(watcher->result());
+    });
+    watcher->setFuture(QtConcurrent::run([]() {
+        QList<AMAppItemData> items;
+        ObjectManager manager(AMService, AMPath, QDBusConnection::sessionBus());
+        const auto apps = manager.GetManagedObjects().value();
+        items.reserve(apps.size());
         for (auto app = apps.cbegin(); app != apps.cend(); app++) {
             auto path = app.key();
             if (!path.path().isEmpty()) {
-                auto c = new AMAppItem(path, app.value());
-                appendRow(c);
+                items << AMAppItem::parseData(path, app.value());
             }
         }
-    });
+        return items;
+    }));
 }
 
 AMAppItem * AMAppItemModel::appItem(const QString &id)
 {
-    for (int i = 0; i < rowCount(); i++) {
-        auto app = item(i);
-        if (app->data(AppItemModel::DesktopIdRole).toString() == id)
-            return static_cast<AMAppItem *>(app);
+    return m_items.value(id);
+}
+
+void AMAppItemModel::appendItems(const QList<AMAppItemData> &items)
+{
+    QList<QStandardItem *> rows;
+    rows.reserve(items.size());
+    for (const auto &data : items) {
+        // it may be added by InterfacesAdded before the managed objects are loaded.
+        if (m_items.contains(data.desktopId))
+            continue;
+        auto item = new AMAppItem(data);
+        m_items.insert(data.desktopId, item);
+        rows << item;
     }
-    return nullptr;
+
+    // all the rows are inserted at once.
+    if (!rows.isEmpty())
+        invisibleRootItem()->appendRows(rows);
 }
 
 }
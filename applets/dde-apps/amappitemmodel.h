@@ -10,6 +10,7 @@
 namespace apps
 {
 class AMAppItem;
+struct AMAppItemData;
 class AMAppItemModel : public AppItemModel
 {
     Q_OBJECT
@@ -19,7 +20,12 @@ public:
 
     AMAppItem * appItem(const QString &id);
 
+private:
+    void appendItems(const QList<AMAppItemData> &items);
+
 private:
     ObjectManager *m_manager;
+    // desktopId -> item, it's kept by the insertions and removals of the rows.
+    QHash<QString, AMAppItem *> m_items;
 };
 }
\ No newline at end of file
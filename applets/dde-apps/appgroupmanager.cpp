@@ -8,6 +8,8 @@
 #include "amappitemmodel.h"
 #include "amappitem.h"
 
+#include <QCoreApplication>
+
 #define TOPLEVEL_FOLDERID 0
 
 namespace apps {
@@ -24,18 +26,39 @@ AppGroupManager::AppGroupManager(AMAppItemModel * referenceModel, QObject *paren
     launchpadArrangementConfigMigration();
     loadAppGroupInfo();
 
-    connect(m_referenceModel, &AMAppItemModel::rowsInserted, this, [this](){
-        onReferenceModelChanged();
-        saveAppGroupInfo();
+    connect(m_referenceModel, &AMAppItemModel::rowsInserted, this, [this](const QModelIndex &parent, int first, int last){
+        if (parent.isValid())
+            return;
+        if (!m_appGroupInitialized) {
+            onReferenceModelChanged();
+        } else {
+            onReferenceRowsInserted(first, last);
+        }
+        requestSave();
     });
-    connect(m_referenceModel, &AMAppItemModel::rowsRemoved, this, [this](){
-        onReferenceModelChanged();
-        saveAppGroupInfo();
+    connect(m_referenceModel, &AMAppItemModel::rowsAboutToBeRemoved, this, [this](const QModelIndex &parent, int first, int last){
+        if (parent.isValid() || !m_appGroupInitialized)
+            return;
+        onReferenceRowsAboutToBeRemoved(first, last);
+        requestSave();
     });
     connect(m_dumpTimer, &QTimer::timeout, this, [this](){
         saveAppGroupInfo();
     });
-    connect(this, &AppGroupManager::dataChanged, this, &AppGroupManager::saveAppGroupInfo);
+    connect(qApp, &QCoreApplication::aboutToQuit, this, [this](){
+        if (m_dumpTimer->isActive()) {
+            m_dumpTimer->stop();
+            saveAppGroupInfo();
+        }
+    });
+    connect(this, &AppGroupManager::dataChanged, this, &AppGroupManager::requestSave);
+    // groups are added or removed, the positions of the items are looked up again.
+    connect(this, &AppGroupManager::rowsInserted, this, [this](){
+        m_itemPositionsDirty = true;
+    });
+    connect(this, &AppGroupManager::rowsRemoved, this, [this](){
+        m_itemPositionsDirty = true;
+    });
 }
 
 QVariant AppGroupManager::data(const QModelIndex &index, int role) const
@@ -53,6 +76,11 @@ QVariant AppGroupManager::data(const QModelIndex &index, int role) const
 // Find the item's location. If folderId is -1, search all folders.
 ItemPosition AppGroupManager::findItem(const QString &appId, int folderId)
 {
+    if (folderId < 0) {
+        ensureItemPositions();
+        return m_itemPositions.value(appId);
+    }
+
     int page, idx;
 
     for (int i = 0; i < rowCount(); i++) {
@@ -73,13 +101,21 @@ void AppGroupManager::appendItemToGroup(const QString &appId, int groupId)
 {
     auto folder = group(groupId);
     Q_CHECK_PTR(folder);
-    folder->itemsPage()->appendItem(appId);
+    auto itemsPage = folder->itemsPage();
+    itemsPage->appendItem(appId);
+
+    // an appended item doesn't move the others, the index is kept up to date.
+    if (!m_itemPositionsDirty && !m_itemPositions.contains(appId)) {
+        const int page = itemsPage->pageCount() - 1;
+        m_itemPositions.insert(appId, ItemPosition(folder->folderId(), page, itemsPage->itemCount(page) - 1));
+    }
 }
 
 bool AppGroupManager::removeItemFromGroup(const QString &appId, int groupId)
 {
     auto folder = group(groupId);
     Q_CHECK_PTR(folder);
+    m_itemPositionsDirty = true;
     return folder->itemsPage()->removeItem(appId);
 }
 
@@ -138,8 +174,9 @@ void AppGroupManager::bringToFromt(const QString & id)
 
     auto * topLevel = groupPages(0);
     topLevel->moveItemPosition(origPos.page(), origPos.pos(), 0, 0, false);
+    m_itemPositionsDirty = true;
 
-    saveAppGroupInfo();
+    requestSave();
 
     // TODO: emit signal to refresh the view
 }
@@ -217,8 +254,9 @@ void AppGroupManager::commitRearrangeOperation(const QString & dragId, const QSt
             topLevel->removeItem(dropId);
         }
     }
+    m_itemPositionsDirty = true;
 
-    saveAppGroupInfo();
+    requestSave();
 
     // TODO: emit signal to refresh the view
 }
@@ -245,6 +283,7 @@ void AppGroupManager::onReferenceModelChanged()
         qDebug() << "referenceModel not ready, wait for next time";
         return;
     }
+    m_appGroupInitialized = true;
 
     QSet<QString> appSet;
     for (int i = 0; i < m_referenceModel->rowCount(); i++) {
@@ -267,6 +306,7 @@ void AppGroupManager::onReferenceModelChanged()
         auto folder = group(index(i, 0));
         Q_CHECK_PTR(folder);
         folder->itemsPage()->removeItemsNotIn(appSet);
+        m_itemPositionsDirty = true;
         // check if group itself is also empty, remove them too.
         if (folder->itemsPage()->itemCount() == 0 && folder->folderId() != TOPLEVEL_FOLDERID) {
             QString groupId = folder->appId();
@@ -279,6 +319,86 @@ void AppGroupManager::onReferenceModelChanged()
     // TODO: save item arrangement to user data?
 }
 
+// New apps are appended to the top-level folder.
+void AppGroupManager::onReferenceRowsInserted(int first, int last)
+{
+    for (int i = first; i <= last; i++) {
+        const auto modelIndex = m_referenceModel->index(i, 0);
+        if (m_referenceModel->data(modelIndex, AppItemModel::NoDisplayRole).toBool())
+            continue;
+        const QString desktopId = m_referenceModel->data(modelIndex, AppItemModel::DesktopIdRole).toString();
+        if (findItem(desktopId).group() == -1) {
+            appendItemToGroup(desktopId, TOPLEVEL_FOLDERID);
+        }
+    }
+}
+
+void AppGroupManager::onReferenceRowsAboutToBeRemoved(int first, int last)
+{
+    QStringList appIds;
+    for (int i = first; i <= last; i++) {
+        appIds << m_referenceModel->data(m_referenceModel->index(i, 0), AppItemModel::DesktopIdRole).toString();
+    }
+    removeItems(appIds);
+}
+
+// Removes the apps from their folders, and the folders which become empty.
+// The positions are looked up in the index once, each folder is updated in one pass, and the
+// index is rebuilt once on the next lookup, so removing k apps doesn't rebuild it k times.
+void AppGroupManager::removeItems(const QStringList &appIds)
+{
+    QHash<int, QSet<QString>> folderItems;
+    for (const auto &appId : appIds) {
+        const ItemPosition pos = findItem(appId);
+        if (pos.group() != -1)
+            folderItems[pos.group()].insert(appId);
+    }
+    if (folderItems.isEmpty())
+        return;
+
+    QSet<QString> emptyGroups;
+    for (auto iter = folderItems.cbegin(); iter != folderItems.cend(); ++iter) {
+        auto folder = group(iter.key());
+        Q_CHECK_PTR(folder);
+        folder->itemsPage()->removeItems(iter.value());
+        if (folder->itemsPage()->itemCount() == 0 && folder->folderId() != TOPLEVEL_FOLDERID) {
+            emptyGroups.insert(folder->appId());
+            removeGroup(iter.key());
+        }
+    }
+
+    if (!emptyGroups.isEmpty())
+        group(TOPLEVEL_FOLDERID)->itemsPage()->removeItems(emptyGroups);
+    m_itemPositionsDirty = true;
+}
+
+void AppGroupManager::ensureItemPositions()
+{
+    if (!m_itemPositionsDirty)
+        return;
+
+    m_itemPositions.clear();
+    for (int i = 0; i < rowCount(); i++) {
+        auto folder = group(index(i, 0));
+        const auto pages = folder->itemsPage()->allPagedItems();
+        for (int page = 0; page < pages.count(); page++) {
+            const auto &items = pages.at(page);
+            for (int pos = 0; pos < items.count(); pos++) {
+                // the first one is taken like the scan by group and page order.
+                if (!m_itemPositions.contains(items.at(pos)))
+                    m_itemPositions.insert(items.at(pos), ItemPosition(folder->folderId(), page, pos));
+            }
+        }
+    }
+    m_itemPositionsDirty = false;
+}
+
+// Changes are saved once after they settle down, a DConfig write serializes all of the groups.
+void AppGroupManager::requestSave()
+{
+    m_dumpTimer->start();
+}
+
 void AppGroupManager::launchpadArrangementConfigMigration()
 {
     const QString arrangementSettingBasePath(QStandardPaths::writableLocation(QStandardPaths::GenericConfigLocation));
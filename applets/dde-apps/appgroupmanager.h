@@ -70,6 +70,11 @@ public:
 
 private:
     void onReferenceModelChanged();
+    void onReferenceRowsInserted(int first, int last);
+    void onReferenceRowsAboutToBeRemoved(int first, int last);
+    void removeItems(const QStringList &appIds);
+    void ensureItemPositions();
+    void requestSave();
 
     void launchpadArrangementConfigMigration();
     void loadAppGroupInfo();
@@ -81,9 +86,14 @@ private:
     void removeGroup(int groupId);
 
 private:
-    bool m_appGroupInitialized;
+    // the items are reconciled with the reference model once it's loaded, then they're
+    // updated by the inserted and removed rows.
+    bool m_appGroupInitialized = false;
     AMAppItemModel * m_referenceModel;
     QTimer* m_dumpTimer;
     Dtk::Core::DConfig *m_config;
+    // appId -> position, it's rebuilt on demand after the items are moved or removed.
+    QHash<QString, ItemPosition> m_itemPositions;
+    bool m_itemPositionsDirty = true;
 };
 }
@@ -59,6 +59,16 @@ void AppItem::setAppName(const QString &appName)
     return setData(appName, AppItemModel::NameRole);
 }
 
+QString AppItem::genericName() const
+{
+    return data(AppItemModel::GenericNameRole).toString();
+}
+
+void AppItem::setGenericName(const QString &genericName)
+{
+    return setData(genericName, AppItemModel::GenericNameRole);
+}
+
 QString AppItem::appIconName() const
 {
     return data(AppItemModel::IconNameRole).toString();
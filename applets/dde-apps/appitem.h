@@ -26,6 +26,9 @@ public:
     QString appName() const;
     void setAppName(const QString &name);
 
+    QString genericName() const;
+    void setGenericName(const QString &genericName);
+
     QString appIconName() const;
     void setAppIconName(const QString &appIconName);
 
@@ -26,6 +26,7 @@ QHash<int, QByteArray> AppItemModel::roleNames() const
             {AppItemModel::DockedRole, QByteArrayLiteral("docked")},
             {AppItemModel::OnDesktopRole, QByteArrayLiteral("onDesktop")},
             {AppItemModel::AutoStartRole, QByteArrayLiteral("autoStart")},
-            {AppItemModel::AppTypeRole, QByteArrayLiteral("appType")}};
+            {AppItemModel::AppTypeRole, QByteArrayLiteral("appType")},
+            {AppItemModel::GenericNameRole, QByteArrayLiteral("genericName")}};
 }
 }
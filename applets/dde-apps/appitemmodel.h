@@ -26,6 +26,7 @@ public:
         OnDesktopRole,
         AutoStartRole,
         AppTypeRole,
+        GenericNameRole,
     };
     Q_ENUM(Roles)
 
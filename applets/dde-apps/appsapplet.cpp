@@ -5,6 +5,7 @@
 #include "appsapplet.h"
 #include "amappitemmodel.h"
 #include "appgroupmanager.h"
+#include "appssearchmodel.h"
 #include "pluginfactory.h"
 
 #include <DUtil>
@@ -16,6 +17,7 @@ AppsApplet::AppsApplet(QObject *parent)
     : DApplet(parent)
     , m_appModel(new AMAppItemModel(this))
     , m_groupModel(new AppGroupManager(m_appModel, this))
+    , m_searchModel(new AppsSearchModel(m_appModel, this))
 {
 }
 
@@ -39,6 +41,11 @@ QAbstractItemModel *AppsApplet::appModel() const
     return m_appModel;
 }
 
+QAbstractItemModel *AppsApplet::searchModel() const
+{
+    return m_searchModel;
+}
+
 D_APPLET_CLASS(AppsApplet)
 }
 
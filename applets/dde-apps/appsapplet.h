@@ -19,6 +19,7 @@ class AppsApplet : public DApplet
     Q_OBJECT
     Q_PROPERTY(QAbstractItemModel *appModel READ appModel CONSTANT FINAL)
     Q_PROPERTY(QAbstractItemModel *appGroupModel READ groupModel CONSTANT FINAL)
+    Q_PROPERTY(QAbstractItemModel *searchModel READ searchModel CONSTANT FINAL)
 
 public:
     explicit AppsApplet(QObject *parent = nullptr);
@@ -28,9 +29,11 @@ public:
 
     QAbstractItemModel *appModel() const;
     QAbstractItemModel *groupModel() const;
+    QAbstractItemModel *searchModel() const;
 
 private:
     AMAppItemModel *m_appModel;
     QAbstractItemModel *m_groupModel;
+    QAbstractItemModel *m_searchModel;
 };
 }
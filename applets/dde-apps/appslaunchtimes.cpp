@@ -4,6 +4,8 @@
 
 #include "appslaunchtimes.h"
 
+#include <QCoreApplication>
+
 namespace apps {
 AppsLaunchTimesHelper* AppsLaunchTimesHelper::instance()
 {
@@ -18,18 +20,69 @@ AppsLaunchTimesHelper* AppsLaunchTimesHelper::instance()
 AppsLaunchTimesHelper::AppsLaunchTimesHelper(QObject *parent)
     : QObject(parent)
     , m_launchTimesConfig(DConfig::create("org.deepin.dde.application-manager", "org.deepin.dde.am", "", this))
+    , m_flushTimer(new QTimer(this))
 {
+    // launches are written in batches, every write serializes the whole map to the config daemon.
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(2000);
+    connect(m_flushTimer, &QTimer::timeout, this, &AppsLaunchTimesHelper::flush);
+    connect(qApp, &QCoreApplication::aboutToQuit, this, &AppsLaunchTimesHelper::flush);
+
     if (m_launchTimesConfig ->isValid()) {
-        m_data = m_launchTimesConfig->value("appsLaunchedTimes").toMap();
+        loadData();
     }
 
     connect(m_launchTimesConfig, &DConfig::valueChanged, this, [this](const QString &key){
         if (key == "appsLaunchedTimes") {
-            m_data = m_launchTimesConfig->value("appsLaunchedTimes").toMap();
+            loadData();
         }
     });
 }
 
+void AppsLaunchTimesHelper::loadData()
+{
+    const auto map = m_launchTimesConfig->value("appsLaunchedTimes").toMap();
+    // the echo of our own write.
+    if (!m_lastWritten.isEmpty() && map == m_lastWritten)
+        return;
+
+    m_data.clear();
+    m_data.reserve(map.size());
+    for (auto it = map.cbegin(); it != map.cend(); ++it) {
+        m_data.insert(it.key(), it.value().toULongLong());
+    }
+
+    // the changes which aren't written yet are kept.
+    for (auto it = m_pending.cbegin(); it != m_pending.cend(); ++it) {
+        if (it.value() == 0) {
+            m_data.remove(it.key());
+        } else {
+            m_data.insert(it.key(), it.value());
+        }
+    }
+}
+
+void AppsLaunchTimesHelper::flush()
+{
+    m_flushTimer->stop();
+    if (m_pending.isEmpty())
+        return;
+
+    // the changes are merged into the current value, it may be changed by others.
+    auto map = m_launchTimesConfig->value("appsLaunchedTimes").toMap();
+    for (auto it = m_pending.cbegin(); it != m_pending.cend(); ++it) {
+        if (it.value() == 0) {
+            map.remove(it.key());
+        } else {
+            map.insert(it.key(), it.value());
+        }
+    }
+    m_pending.clear();
+
+    m_lastWritten = map;
+    m_launchTimesConfig->setValue("appsLaunchedTimes", map);
+}
+
 void AppsLaunchTimesHelper::setLaunchTimesFor(const QString &desktopId, quint64 launchTimes)
 {
     if (launchTimes == 0) {
@@ -38,13 +91,14 @@ void AppsLaunchTimesHelper::setLaunchTimesFor(const QString &desktopId, quint64
         m_data[desktopId] = launchTimes;
     }
 
-    // TODO: write list
-    m_launchTimesConfig->setValue("appsLaunchedTimes", m_data);
+    m_pending.insert(desktopId, launchTimes);
+    if (!m_flushTimer->isActive())
+        m_flushTimer->start();
 }
 
 quint64 AppsLaunchTimesHelper::getLaunchedTimesFor(const QString &desktopId)
 {
-    return m_data.value(desktopId, 0).toULongLong();
+    return m_data.value(desktopId, 0);
 }
 
-}
\ No newline at end of file
+}
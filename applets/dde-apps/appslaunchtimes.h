@@ -5,6 +5,7 @@
 #pragma once
 
 #include <QObject>
+#include <QTimer>
 #include <DConfig>
 
 DCORE_USE_NAMESPACE
@@ -22,8 +23,16 @@ public:
 private:
     AppsLaunchTimesHelper(QObject *parent = nullptr);
 
+    void loadData();
+    void flush();
+
 private:
     DConfig* m_launchTimesConfig;
-    QVariantMap m_data;
+    QTimer* m_flushTimer;
+    QHash<QString, quint64> m_data;
+    // launch times changed since the last write, 0 means the record is removed.
+    QHash<QString, quint64> m_pending;
+    // the value of our last write, its valueChanged isn't loaded again.
+    QVariantMap m_lastWritten;
 };
-}
\ No newline at end of file
+}
@@ -0,0 +1,307 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "appssearchindex.h"
+
+#include <DPinyin>
+
+#include <QSet>
+
+#include <algorithm>
+#include <cmath>
+
+namespace apps {
+// polyphonic names have a transliteration for every combination of readings.
+static const int MaxTransliterations = 8;
+// the removed slots are released once they're the most of the index.
+static const int CompactThreshold = 64;
+// a launch count of 1000 weighs about as much as the difference between a prefix and a substring match.
+static const double LaunchedTimesWeight = 3.0;
+
+enum MatchScore {
+    FuzzyScore = 10,
+    DesktopIdScore = 30,
+    GenericNameScore = 40,
+    PinyinScore = 50,
+    SubstringScore = 60,
+    PinyinPrefixScore = 70,
+    InitialsScore = 75,
+    WordPrefixScore = 80,
+    PrefixScore = 90,
+    ExactScore = 100,
+};
+
+static QString compacted(const QString &text)
+{
+    QString result;
+    result.reserve(text.size());
+    for (const QChar ch : text) {
+        if (!ch.isSpace())
+            result.append(ch);
+    }
+    return result;
+}
+
+static bool hasHanCharacters(const QString &text)
+{
+    return std::any_of(text.cbegin(), text.cend(), [](const QChar ch) {
+        return ch.script() == QChar::Script_Han;
+    });
+}
+
+static void appendTransliterations(QStringList &target, const QStringList &source)
+{
+    for (const auto &text : source.mid(0, MaxTransliterations)) {
+        const auto value = compacted(text.toLower());
+        if (!value.isEmpty() && !target.contains(value))
+            target.append(value);
+    }
+}
+
+// whether the characters of `query` appear in order in `text`.
+static bool isSubsequence(const QString &query, const QString &text)
+{
+    qsizetype pos = 0;
+    for (const QChar ch : query) {
+        pos = text.indexOf(ch, pos);
+        if (pos < 0)
+            return false;
+        ++pos;
+    }
+    return true;
+}
+
+static int matchScore(const AppsSearchIndex::Entry &entry, const QString &query, const QString &compactQuery)
+{
+    if (entry.name == query)
+        return ExactScore;
+    if (entry.name.startsWith(query))
+        return PrefixScore;
+    if (entry.name.contains(QLatin1Char(' ') + query))
+        return WordPrefixScore;
+
+    for (const auto &initials : entry.initials) {
+        if (initials.startsWith(compactQuery))
+            return InitialsScore;
+    }
+    for (const auto &pinyin : entry.pinyins) {
+        if (pinyin.startsWith(compactQuery))
+            return PinyinPrefixScore;
+    }
+    if (entry.compactName.contains(compactQuery))
+        return SubstringScore;
+    for (const auto &pinyin : entry.pinyins) {
+        if (pinyin.contains(compactQuery))
+            return PinyinScore;
+    }
+    if (entry.genericName.contains(compactQuery))
+        return GenericNameScore;
+    if (entry.id.contains(compactQuery))
+        return DesktopIdScore;
+    return 0;
+}
+
+// the pinyin dictionary is loaded lazily without a lock, `AppsSearchModel` only calls it on one worker thread.
+AppsSearchIndex::Entry AppsSearchIndex::makeEntry(const QString &desktopId, const QString &name, const QString &genericName)
+{
+    Entry entry;
+    entry.desktopId = desktopId;
+    entry.name = name.toLower().simplified();
+    entry.compactName = compacted(entry.name);
+    entry.genericName = compacted(genericName.toLower());
+    entry.id = desktopId.toLower();
+
+    if (hasHanCharacters(name)) {
+        appendTransliterations(entry.pinyins, Dtk::Core::pinyin(name, Dtk::Core::TS_NoneTone));
+        appendTransliterations(entry.initials, Dtk::Core::firstLetters(name));
+    } else {
+        // the initials of words, e.g. "vsc" of "Visual Studio Code".
+        QString initials;
+        const auto words = entry.name.split(QLatin1Char(' '), Qt::SkipEmptyParts);
+        for (const auto &word : words)
+            initials.append(word.front());
+        if (initials.size() > 1)
+            entry.initials.append(initials);
+    }
+    return entry;
+}
+
+void AppsSearchIndex::insert(const Entry &entry)
+{
+    remove(entry.desktopId);
+
+    const int slot = m_entries.size();
+    m_entries.append(entry);
+    m_alive.append(true);
+    m_slots.insert(entry.desktopId, slot);
+    indexSlot(slot);
+}
+
+void AppsSearchIndex::remove(const QString &desktopId)
+{
+    const auto iter = m_slots.constFind(desktopId);
+    if (iter == m_slots.constEnd())
+        return;
+
+    const int slot = iter.value();
+    m_slots.erase(iter);
+    m_alive[slot] = false;
+    m_entries[slot] = Entry();
+    ++m_removedCount;
+
+    if (m_removedCount > CompactThreshold && m_removedCount * 2 > m_entries.size())
+        compact();
+}
+
+void AppsSearchIndex::clear()
+{
+    m_entries.clear();
+    m_alive.clear();
+    m_slots.clear();
+    m_postings.clear();
+    m_removedCount = 0;
+}
+
+bool AppsSearchIndex::contains(const QString &desktopId) const
+{
+    return m_slots.contains(desktopId);
+}
+
+int AppsSearchIndex::count() const
+{
+    return m_slots.size();
+}
+
+QList<AppsSearchIndex::Hit> AppsSearchIndex::search(const QString &text, int maxCount, const LaunchedTimesProvider &launchedTimes) const
+{
+    const auto query = text.simplified().toLower();
+    const auto compactQuery = compacted(query);
+    if (compactQuery.isEmpty() || maxCount <= 0)
+        return {};
+
+    QList<Hit> hits;
+    QSet<int> matched;
+    const auto slots = candidates(compactQuery);
+    for (const int slot : slots) {
+        const int score = matchScore(m_entries.at(slot), query, compactQuery);
+        if (score <= 0)
+            continue;
+        hits.append({m_entries.at(slot).desktopId, double(score)});
+        matched.insert(slot);
+    }
+
+    // it's a typo or an abbreviation not covered by the n-grams, the names are only scanned when the
+    // n-grams give nothing, so a usual query never visits every application.
+    if (hits.isEmpty() && compactQuery.size() > 1) {
+        for (int slot = 0; slot < m_entries.size(); ++slot) {
+            if (!m_alive.at(slot) || matched.contains(slot))
+                continue;
+            if (isSubsequence(compactQuery, m_entries.at(slot).compactName))
+                hits.append({m_entries.at(slot).desktopId, double(FuzzyScore)});
+        }
+    }
+
+    if (launchedTimes) {
+        for (auto &hit : hits)
+            hit.score += LaunchedTimesWeight * std::log2(1.0 + launchedTimes(hit.desktopId));
+    }
+
+    const auto greater = [](const Hit &left, const Hit &right) {
+        if (left.score != right.score)
+            return left.score > right.score;
+        return left.desktopId < right.desktopId;
+    };
+    if (hits.size() > maxCount) {
+        std::partial_sort(hits.begin(), hits.begin() + maxCount, hits.end(), greater);
+        hits.resize(maxCount);
+    } else {
+        std::sort(hits.begin(), hits.end(), greater);
+    }
+    return hits;
+}
+
+// n-grams are at most 3 UTF-16 units, they're packed with their length into one key.
+quint64 AppsSearchIndex::gramKey(QStringView gram)
+{
+    quint64 key = quint64(gram.size()) << 48;
+    for (qsizetype i = 0; i < gram.size(); ++i)
+        key |= quint64(gram.at(i).unicode()) << (32 - 16 * i);
+    return key;
+}
+
+QStringList AppsSearchIndex::keysOf(const Entry &entry)
+{
+    QStringList keys {entry.compactName, entry.genericName, entry.id};
+    keys.append(entry.pinyins);
+    keys.append(entry.initials);
+    return keys;
+}
+
+void AppsSearchIndex::indexSlot(int slot)
+{
+    QSet<quint64> grams;
+    const auto keys = keysOf(m_entries.at(slot));
+    for (const auto &key : keys) {
+        for (qsizetype length = 1; length <= 3; ++length) {
+            for (qsizetype i = 0; i + length <= key.size(); ++i)
+                grams.insert(gramKey(QStringView(key).mid(i, length)));
+        }
+    }
+
+    // slots are only appended, so every posting list stays sorted.
+    for (const auto gram : std::as_const(grams))
+        m_postings[gram].append(slot);
+}
+
+void AppsSearchIndex::compact()
+{
+    QList<Entry> entries;
+    entries.reserve(m_slots.size());
+    for (int slot = 0; slot < m_entries.size(); ++slot) {
+        if (m_alive.at(slot))
+            entries.append(std::move(m_entries[slot]));
+    }
+
+    clear();
+    for (const auto &entry : std::as_const(entries))
+        insert(entry);
+}
+
+// the live slots sharing all the n-grams of `query`, the longest n-grams are used.
+QList<int> AppsSearchIndex::candidates(const QString &query) const
+{
+    const qsizetype length = std::min<qsizetype>(3, query.size());
+    QList<const QList<int> *> postings;
+    QSet<quint64> grams;
+    for (qsizetype i = 0; i + length <= query.size(); ++i) {
+        const auto gram = gramKey(QStringView(query).mid(i, length));
+        if (grams.contains(gram))
+            continue;
+        grams.insert(gram);
+
+        const auto iter = m_postings.constFind(gram);
+        if (iter == m_postings.constEnd())
+            return {};
+        postings.append(&iter.value());
+    }
+
+    // intersects from the rarest n-gram, so the intermediate result is never larger than it.
+    std::sort(postings.begin(), postings.end(), [](const QList<int> *left, const QList<int> *right) {
+        return left->size() < right->size();
+    });
+
+    QList<int> result = *postings.first();
+    for (qsizetype i = 1; i < postings.size() && !result.isEmpty(); ++i) {
+        const auto &other = *postings.at(i);
+        QList<int> intersection;
+        std::set_intersection(result.cbegin(), result.cend(), other.cbegin(), other.cend(), std::back_inserter(intersection));
+        result = std::move(intersection);
+    }
+
+    result.removeIf([this](int slot) {
+        return !m_alive.at(slot);
+    });
+    return result;
+}
+}
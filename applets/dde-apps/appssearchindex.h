@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+
+namespace apps {
+/**
+ * @brief The AppsSearchIndex class
+ * An n-gram index over the searchable texts of applications, the name, the generic name, the desktop id,
+ * and the pinyin and initials of the name. A query only verifies the applications sharing all of its
+ * n-grams, instead of matching every application.
+ */
+class AppsSearchIndex
+{
+public:
+    // the searchable texts of an application, they're lowercased and without whitespaces.
+    // it's plain data and can be built on a worker thread, the transliteration is the expensive part.
+    // The transliteration of DtkCore isn't thread-safe, entries mustn't be built on several threads at once.
+    struct Entry
+    {
+        QString desktopId;
+        // lowercased, the whitespaces are kept for matching the start of words.
+        QString name;
+        QString compactName;
+        QString genericName;
+        QString id;
+        QStringList pinyins;
+        QStringList initials;
+    };
+
+    struct Hit
+    {
+        QString desktopId;
+        double score = 0;
+    };
+
+    using LaunchedTimesProvider = std::function<quint64(const QString &desktopId)>;
+
+    static Entry makeEntry(const QString &desktopId, const QString &name, const QString &genericName);
+
+    // replaces the entry of the same desktop id.
+    void insert(const Entry &entry);
+    void remove(const QString &desktopId);
+    void clear();
+
+    bool contains(const QString &desktopId) const;
+    int count() const;
+
+    // returns at most `maxCount` hits ordered by score, the launched times are blended into the score.
+    QList<Hit> search(const QString &text, int maxCount, const LaunchedTimesProvider &launchedTimes = {}) const;
+
+private:
+    static quint64 gramKey(QStringView gram);
+    static QStringList keysOf(const Entry &entry);
+
+    void indexSlot(int slot);
+    void compact();
+    QList<int> candidates(const QString &query) const;
+
+private:
+    // slots of removed entries are only released by `compact()`, so posting lists stay sorted.
+    QList<Entry> m_entries;
+    QList<bool> m_alive;
+    QHash<QString, int> m_slots;
+    QHash<quint64, QList<int>> m_postings;
+    int m_removedCount = 0;
+};
+}
@@ -0,0 +1,277 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "appssearchmodel.h"
+#include "appitemmodel.h"
+#include "appslaunchtimes.h"
+
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <algorithm>
+
+namespace apps {
+// the pinyin dictionary of DtkCore is loaded lazily without a lock, so the entries are built on one
+// thread at a time, and never on the main thread.
+class EntryBuilderPool : public QThreadPool
+{
+public:
+    EntryBuilderPool()
+    {
+        setMaxThreadCount(1);
+    }
+};
+Q_GLOBAL_STATIC(EntryBuilderPool, entryBuilderPool)
+
+AppsSearchModel::AppsSearchModel(QAbstractItemModel *sourceModel, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_sourceModel(sourceModel)
+{
+    connect(sourceModel, &QAbstractItemModel::rowsInserted, this, &AppsSearchModel::onSourceRowsInserted);
+    connect(sourceModel, &QAbstractItemModel::rowsAboutToBeRemoved, this, &AppsSearchModel::onSourceRowsAboutToBeRemoved);
+    connect(sourceModel, &QAbstractItemModel::dataChanged, this, &AppsSearchModel::onSourceDataChanged);
+    connect(sourceModel, &QAbstractItemModel::modelReset, this, &AppsSearchModel::rebuildIndex);
+    // the persistent indexes of the results follow the rows, only the desktop id table is outdated.
+    const auto markSourceRowsDirty = [this]() {
+        m_sourceRowsDirty = true;
+    };
+    connect(sourceModel, &QAbstractItemModel::rowsRemoved, this, markSourceRowsDirty);
+    connect(sourceModel, &QAbstractItemModel::rowsMoved, this, markSourceRowsDirty);
+    connect(sourceModel, &QAbstractItemModel::layoutChanged, this, markSourceRowsDirty);
+
+    rebuildIndex();
+}
+
+QString AppsSearchModel::searchText() const
+{
+    return m_searchText;
+}
+
+void AppsSearchModel::setSearchText(const QString &searchText)
+{
+    if (m_searchText == searchText)
+        return;
+    m_searchText = searchText;
+    updateResults();
+    emit searchTextChanged();
+}
+
+int AppsSearchModel::maxCount() const
+{
+    return m_maxCount;
+}
+
+void AppsSearchModel::setMaxCount(int maxCount)
+{
+    if (m_maxCount == maxCount)
+        return;
+    m_maxCount = maxCount;
+    updateResults();
+    emit maxCountChanged();
+}
+
+int AppsSearchModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_results.size();
+}
+
+QVariant AppsSearchModel::data(const QModelIndex &index, int role) const
+{
+    if (!checkIndex(index, CheckIndexOption::IndexIsValid | CheckIndexOption::ParentIsInvalid))
+        return QVariant();
+    return m_results.at(index.row()).data(role);
+}
+
+QHash<int, QByteArray> AppsSearchModel::roleNames() const
+{
+    return m_sourceModel->roleNames();
+}
+
+void AppsSearchModel::onSourceRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+    m_sourceRowsDirty = true;
+
+    QList<SourceApp> apps;
+    apps.reserve(last - first + 1);
+    for (int row = first; row <= last; ++row) {
+        const auto index = m_sourceModel->index(row, 0);
+        if (index.data(AppItemModel::NoDisplayRole).toBool())
+            continue;
+        apps.append({index.data(AppItemModel::DesktopIdRole).toString(),
+                     index.data(AppItemModel::NameRole).toString(),
+                     index.data(AppItemModel::GenericNameRole).toString()});
+    }
+    buildEntries(apps);
+}
+
+void AppsSearchModel::onSourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+
+    bool changed = false;
+    for (int row = first; row <= last; ++row) {
+        const auto desktopId = m_sourceModel->index(row, 0).data(AppItemModel::DesktopIdRole).toString();
+        m_pendingBatches.remove(desktopId);
+        changed |= m_index.contains(desktopId);
+        m_index.remove(desktopId);
+    }
+
+    // the results of the removed rows are dropped while the rows still exist.
+    for (int i = m_results.size() - 1; i >= 0; --i) {
+        const int row = m_results.at(i).row();
+        if (row < first || row > last)
+            continue;
+        beginRemoveRows(QModelIndex(), i, i);
+        m_results.removeAt(i);
+        m_resultIds.removeAt(i);
+        endRemoveRows();
+    }
+
+    // the results are refilled once the rows are gone.
+    if (changed && !m_searchText.isEmpty()) {
+        QMetaObject::invokeMethod(this, &AppsSearchModel::updateResults, Qt::QueuedConnection);
+    }
+}
+
+void AppsSearchModel::onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles)
+{
+    static const QList<int> IndexedRoles {
+        AppItemModel::NameRole,
+        AppItemModel::GenericNameRole,
+        AppItemModel::NoDisplayRole
+    };
+    if (topLeft.parent().isValid())
+        return;
+
+    for (int i = 0; i < m_results.size(); ++i) {
+        const int row = m_results.at(i).row();
+        if (row >= topLeft.row() && row <= bottomRight.row())
+            emit dataChanged(index(i, 0), index(i, 0), roles);
+    }
+
+    if (!roles.isEmpty() && std::none_of(roles.cbegin(), roles.cend(), [](int role) {
+            return IndexedRoles.contains(role);
+        }))
+        return;
+
+    QList<SourceApp> apps;
+    bool removed = false;
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        const auto index = m_sourceModel->index(row, 0);
+        const auto desktopId = index.data(AppItemModel::DesktopIdRole).toString();
+        if (index.data(AppItemModel::NoDisplayRole).toBool()) {
+            m_pendingBatches.remove(desktopId);
+            removed |= m_index.contains(desktopId);
+            m_index.remove(desktopId);
+        } else {
+            apps.append({desktopId,
+                         index.data(AppItemModel::NameRole).toString(),
+                         index.data(AppItemModel::GenericNameRole).toString()});
+        }
+    }
+    if (removed)
+        updateResults();
+    buildEntries(apps);
+}
+
+void AppsSearchModel::buildEntries(const QList<SourceApp> &apps)
+{
+    if (apps.isEmpty())
+        return;
+
+    const auto batch = ++m_batch;
+    for (const auto &app : apps)
+        m_pendingBatches.insert(app.desktopId, batch);
+
+    auto watcher = new QFutureWatcher<QList<AppsSearchIndex::Entry>>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, batch]() {
+        watcher->deleteLater();
+
+        bool changed = false;
+        const auto entries = watcher->result();
+        for (const auto &entry : entries) {
+            // the row is removed, or updated by a later batch meanwhile.
+            const auto iter = m_pendingBatches.constFind(entry.desktopId);
+            if (iter == m_pendingBatches.constEnd() || iter.value() != batch)
+                continue;
+            m_pendingBatches.erase(iter);
+            m_index.insert(entry);
+            changed = true;
+        }
+        if (changed)
+            updateResults();
+    });
+    QThreadPool *pool = entryBuilderPool();
+    watcher->setFuture(QtConcurrent::run(pool, [apps]() {
+        QList<AppsSearchIndex::Entry> entries;
+        entries.reserve(apps.size());
+        for (const auto &app : apps)
+            entries.append(AppsSearchIndex::makeEntry(app.desktopId, app.name, app.genericName));
+        return entries;
+    }));
+}
+
+void AppsSearchModel::rebuildIndex()
+{
+    // the entries being built for the previous rows are outdated.
+    m_pendingBatches.clear();
+    m_index.clear();
+    m_sourceRowsDirty = true;
+
+    beginResetModel();
+    m_results.clear();
+    m_resultIds.clear();
+    endResetModel();
+
+    const int count = m_sourceModel->rowCount();
+    if (count > 0)
+        onSourceRowsInserted(QModelIndex(), 0, count - 1);
+}
+
+void AppsSearchModel::ensureSourceRows()
+{
+    if (!m_sourceRowsDirty)
+        return;
+
+    m_sourceRows.clear();
+    const int count = m_sourceModel->rowCount();
+    m_sourceRows.reserve(count);
+    for (int row = 0; row < count; ++row)
+        m_sourceRows.insert(m_sourceModel->index(row, 0).data(AppItemModel::DesktopIdRole).toString(), row);
+    m_sourceRowsDirty = false;
+}
+
+void AppsSearchModel::updateResults()
+{
+    QStringList ids;
+    if (!m_searchText.isEmpty()) {
+        const auto hits = m_index.search(m_searchText, m_maxCount, [](const QString &desktopId) {
+            return AppsLaunchTimesHelper::instance()->getLaunchedTimesFor(desktopId);
+        });
+        ids.reserve(hits.size());
+        for (const auto &hit : hits)
+            ids.append(hit.desktopId);
+    }
+
+    if (ids == m_resultIds)
+        return;
+
+    // at most `maxCount` rows are looked up, the other rows of the source model aren't read.
+    ensureSourceRows();
+    beginResetModel();
+    m_results.clear();
+    m_resultIds.clear();
+    for (const auto &id : std::as_const(ids)) {
+        const int row = m_sourceRows.value(id, -1);
+        if (row < 0)
+            continue;
+        m_results.append(QPersistentModelIndex(m_sourceModel->index(row, 0)));
+        m_resultIds.append(id);
+    }
+    endResetModel();
+}
+}
@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "appssearchindex.h"
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QPersistentModelIndex>
+
+namespace apps {
+/**
+ * @brief The AppsSearchModel class
+ * Exposes the best matched applications of `searchText`, ordered by score. The hits of the search index
+ * are mapped to the rows of the source model through a cached desktop id table, the source rows aren't
+ * filtered one by one. The entries of the index are built on a worker thread.
+ */
+class AppsSearchModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(QString searchText READ searchText WRITE setSearchText NOTIFY searchTextChanged FINAL)
+    Q_PROPERTY(int maxCount READ maxCount WRITE setMaxCount NOTIFY maxCountChanged FINAL)
+
+public:
+    explicit AppsSearchModel(QAbstractItemModel *sourceModel, QObject *parent = nullptr);
+
+    QString searchText() const;
+    void setSearchText(const QString &searchText);
+
+    int maxCount() const;
+    void setMaxCount(int maxCount);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+Q_SIGNALS:
+    void searchTextChanged();
+    void maxCountChanged();
+
+private:
+    struct SourceApp
+    {
+        QString desktopId;
+        QString name;
+        QString genericName;
+    };
+
+    void onSourceRowsInserted(const QModelIndex &parent, int first, int last);
+    void onSourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles);
+    void buildEntries(const QList<SourceApp> &apps);
+    void rebuildIndex();
+    void ensureSourceRows();
+    void updateResults();
+
+private:
+    QAbstractItemModel *m_sourceModel;
+    QString m_searchText;
+    int m_maxCount = 50;
+    AppsSearchIndex m_index;
+    // the batch building the entry of a desktop id, a result is dropped if the row is removed or
+    // updated by a later batch meanwhile.
+    QHash<QString, quint64> m_pendingBatches;
+    quint64 m_batch = 0;
+    // desktop id to source row, it's rebuilt once after the rows of the source model are moved.
+    QHash<QString, int> m_sourceRows;
+    bool m_sourceRowsDirty = true;
+    QStringList m_resultIds;
+    QList<QPersistentModelIndex> m_results;
+};
+}
@@ -196,6 +196,20 @@ bool ItemsPage::removeItem(const QString id, bool removePageIfPageIsEmpty)
     return false;
 }
 
+// Removes the items in one pass over the pages, empty pages are removed afterwards.
+void ItemsPage::removeItems(const QSet<QString> &itemSet)
+{
+    if (itemSet.isEmpty())
+        return;
+
+    for (int i = 0; i < m_pages.count(); i++) {
+        m_pages[i].removeIf([&itemSet](const QString &item) {
+            return itemSet.contains(item);
+        });
+    }
+    removeEmptyPages();
+}
+
 void ItemsPage::removeItemsNotIn(const QSet<QString> &itemSet)
 {
     for (int i = 0; i < m_pages.count(); i++) {
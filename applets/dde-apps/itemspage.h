@@ -40,6 +40,7 @@ public:
     void insertItemToPage(const QString &id, int toPage);
     void moveItemPosition(int fromPage, int fromIndex, int toPage, int toIndex, bool appendToIndexItem);
     bool removeItem(const QString id, bool removePageIfPageIsEmpty = true);
+    void removeItems(const QSet<QString> & itemSet);
     void removeItemsNotIn(const QSet<QString> & itemSet);
     void removeEmptyPages();
 
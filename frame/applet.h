@@ -18,6 +18,7 @@ DS_BEGIN_NAMESPACE
 class DAppletPrivate;
 class DPluginLoader;
 class DAppletBridge;
+class DAppletRegistry;
 class DS_SHARE DApplet : public QObject, public DTK_CORE_NAMESPACE::DObject
 {
     Q_OBJECT
@@ -28,6 +29,7 @@ class DS_SHARE DApplet : public QObject, public DTK_CORE_NAMESPACE::DObject
     D_DECLARE_PRIVATE(DApplet)
     friend class DPluginLoader;
     friend class DAppletBridge;
+    friend class DAppletRegistry;
 public:
     explicit DApplet(QObject *parent = nullptr);
     virtual ~DApplet() override;
@@ -6,9 +6,11 @@
 #include "containment.h"
 #include "private/appletbridge_p.h"
 #include "private/applet_p.h"
+#include "private/appletregistry_p.h"
 
 #include "pluginloader.h"
-#include <QQueue>
+
+#include <QMetaMethod>
 
 DS_BEGIN_NAMESPACE
 
@@ -23,23 +25,23 @@ DAppletBridgePrivate::~DAppletBridgePrivate()
 
 QList<DApplet *> DAppletBridgePrivate::applets() const
 {
-    QList<DApplet *> applets;
-    auto rootApplet = DPluginLoader::instance()->rootApplet();
-    auto root = qobject_cast<DContainment *>(rootApplet);
-
-    QQueue<DContainment *> containments;
-    containments.enqueue(root);
-    while (!containments.isEmpty()) {
-        DContainment *containment = containments.dequeue();
-        for (const auto applet : containment->applets()) {
-            if (auto item = qobject_cast<DContainment *>(applet)) {
-                containments.enqueue(item);
-            }
-            if (applet->pluginId() == m_pluginId)
-                applets << applet;
-        }
-    }
-    return applets;
+    return DAppletRegistry::instance()->applets(m_pluginId);
+}
+
+void DAppletBridgePrivate::watchRegistry()
+{
+    if (m_watchingRegistry)
+        return;
+    m_watchingRegistry = true;
+
+    D_Q(DAppletBridge);
+    auto registry = DAppletRegistry::instance();
+    const auto onChanged = [this](const QString &pluginId) {
+        if (pluginId == m_pluginId)
+            Q_EMIT q_func()->appletsChanged();
+    };
+    QObject::connect(registry, &DAppletRegistry::appletAdded, q, onChanged);
+    QObject::connect(registry, &DAppletRegistry::appletRemoved, q, onChanged);
 }
 
 DAppletBridge::DAppletBridge(const QString &pluginId, QObject *parent)
@@ -61,6 +63,10 @@ DAppletBridge::~DAppletBridge()
 bool DAppletBridge::isValid() const
 {
     D_DC(DAppletBridge);
+    // a live applet implies its plugin is valid, avoid querying the loader.
+    if (DAppletRegistry::instance()->contains(d->m_pluginId))
+        return true;
+
     const auto plugin = DPluginLoader::instance()->plugin(d->m_pluginId);
     return plugin.isValid();
 }
@@ -74,28 +80,23 @@ QString DAppletBridge::pluginId() const
 QList<DAppletProxy *> DAppletBridge::applets() const
 {
     D_DC(DAppletBridge);
-    if (!isValid())
-        return {};
-    QList<DAppletProxy *> ret;
-    for (const auto item : d->applets()) {
-        if (auto proxy = item->d_func()->appletProxy()) {
-            ret << proxy;
-        }
-    }
-    return ret;
+    return DAppletRegistry::instance()->proxies(d->m_pluginId);
 }
 
 DAppletProxy *DAppletBridge::applet() const
 {
     D_DC(DAppletBridge);
-    if (!isValid())
-        return {};
-    for (const auto item : d->applets()) {
-        if (auto proxy = item->d_func()->appletProxy()) {
-            return proxy;
-        }
+    return DAppletRegistry::instance()->proxy(d->m_pluginId);
+}
+
+void DAppletBridge::connectNotify(const QMetaMethod &signal)
+{
+    // only track the registry when somebody listens, most bridges are short-lived.
+    if (signal == QMetaMethod::fromSignal(&DAppletBridge::appletsChanged)) {
+        D_D(DAppletBridge);
+        d->watchRegistry();
     }
-    return nullptr;
+    QObject::connectNotify(signal);
 }
 
 DS_END_NAMESPACE
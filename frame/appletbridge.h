@@ -29,8 +29,12 @@ public:
     QList<DAppletProxy *> applets() const;
     DAppletProxy *applet() const;
 
+Q_SIGNALS:
+    void appletsChanged();
+
 protected:
     explicit DAppletBridge(DAppletBridgePrivate &dd, QObject *parent = nullptr);
+    void connectNotify(const QMetaMethod &signal) override;
 };
 
 DS_END_NAMESPACE
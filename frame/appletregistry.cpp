@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "private/appletregistry_p.h"
+#include "private/applet_p.h"
+
+#include "applet.h"
+
+#include <QCoreApplication>
+#include <QLoggingCategory>
+
+DS_BEGIN_NAMESPACE
+
+Q_DECLARE_LOGGING_CATEGORY(dsLog)
+
+Q_APPLICATION_STATIC(DAppletRegistry, g_appletRegistry)
+
+DAppletRegistry::DAppletRegistry(QObject *parent)
+    : QObject(parent)
+{
+}
+
+DAppletRegistry::~DAppletRegistry()
+{
+}
+
+DAppletRegistry *DAppletRegistry::instance()
+{
+    return g_appletRegistry;
+}
+
+void DAppletRegistry::registerApplet(DApplet *applet)
+{
+    Q_ASSERT(applet);
+    if (m_pluginIds.contains(applet))
+        return;
+
+    const auto pluginId = applet->pluginId();
+    m_pluginIds.insert(applet, pluginId);
+    m_applets[pluginId].append(applet);
+
+    // applets can be destroyed together with their parent containment without removeApplet.
+    QObject::connect(applet, &QObject::destroyed, this, [this, applet]() {
+        unregisterApplet(applet);
+    });
+
+    qCDebug(dsLog) << "Registered applet:" << pluginId << applet->id();
+    Q_EMIT appletAdded(pluginId, applet);
+}
+
+void DAppletRegistry::unregisterApplet(DApplet *applet)
+{
+    const auto it = m_pluginIds.constFind(applet);
+    if (it == m_pluginIds.constEnd())
+        return;
+
+    const auto pluginId = it.value();
+    m_pluginIds.erase(it);
+    QObject::disconnect(applet, &QObject::destroyed, this, nullptr);
+
+    auto appletsIt = m_applets.find(pluginId);
+    if (appletsIt != m_applets.end()) {
+        appletsIt->removeOne(applet);
+        if (appletsIt->isEmpty())
+            m_applets.erase(appletsIt);
+    }
+
+    Q_EMIT appletRemoved(pluginId, applet);
+}
+
+bool DAppletRegistry::contains(const QString &pluginId) const
+{
+    return m_applets.contains(pluginId);
+}
+
+QList<DApplet *> DAppletRegistry::applets(const QString &pluginId) const
+{
+    return m_applets.value(pluginId);
+}
+
+QList<DAppletProxy *> DAppletRegistry::proxies(const QString &pluginId) const
+{
+    QList<DAppletProxy *> ret;
+    const auto it = m_applets.constFind(pluginId);
+    if (it == m_applets.constEnd())
+        return ret;
+
+    ret.reserve(it->size());
+    for (const auto applet : *it) {
+        if (auto proxy = applet->d_func()->appletProxy())
+            ret << proxy;
+    }
+    return ret;
+}
+
+DAppletProxy *DAppletRegistry::proxy(const QString &pluginId) const
+{
+    const auto it = m_applets.constFind(pluginId);
+    if (it == m_applets.constEnd())
+        return nullptr;
+
+    for (const auto applet : *it) {
+        if (auto proxy = applet->d_func()->appletProxy())
+            return proxy;
+    }
+    return nullptr;
+}
+
+DS_END_NAMESPACE
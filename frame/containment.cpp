@@ -4,6 +4,7 @@
 
 #include "containment.h"
 #include "private/containment_p.h"
+#include "private/appletregistry_p.h"
 #include "appletitemmodel.h"
 
 #include "pluginloader.h"
@@ -59,6 +60,7 @@ DApplet *DContainment::createApplet(const DAppletData &data)
     });
 
     d->m_applets.append(applet);
+    DAppletRegistry::instance()->registerApplet(applet);
     return applet;
 }
 
@@ -69,6 +71,7 @@ void DContainment::removeApplet(DApplet *applet)
     if (d->m_applets.contains(applet)) {
         d->m_applets.removeOne(applet);
     }
+    DAppletRegistry::instance()->unregisterApplet(applet);
     if (auto view = applet->rootObject()) {
         d->model()->remove(view);
     }
@@ -0,0 +1,253 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "iconcache.h"
+
+#include <dobject_p.h>
+#include <DGuiApplicationHelper>
+#include <DIconTheme>
+#include <DPlatformTheme>
+
+#include <QBuffer>
+#include <QCache>
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QIcon>
+#include <QLoggingCategory>
+#include <QMutex>
+#include <QQuickImageProvider>
+#include <QThread>
+#include <QUrl>
+#include <QUrlQuery>
+
+DS_BEGIN_NAMESPACE
+DCORE_USE_NAMESPACE
+DGUI_USE_NAMESPACE
+
+Q_DECLARE_LOGGING_CATEGORY(dsLog)
+
+// costs are in KiB.
+static const int MaxImagesCost = 32 * 1024;
+static const int MaxDataUrlsCost = 8 * 1024;
+static const int MaxIconNames = 1024;
+static const int DefaultIconSize = 64;
+
+static int costOf(qsizetype bytes)
+{
+    return int(qMax<qsizetype>(1, bytes / 1024));
+}
+
+class DIconCachePrivate : public DObjectPrivate
+{
+public:
+    explicit DIconCachePrivate(DIconCache *qq)
+        : DObjectPrivate(qq)
+        , m_images(MaxImagesCost)
+        , m_iconNames(MaxIconNames)
+        , m_dataUrls(MaxDataUrlsCost)
+        , m_themeName(QIcon::themeName())
+    {
+    }
+
+    QString imageKey(const QString &name, const QSize &size, qreal devicePixelRatio) const
+    {
+        return QStringLiteral("%1|%2|%3x%4@%5").arg(name, m_themeName).arg(size.width()).arg(size.height()).arg(devicePixelRatio);
+    }
+
+    static QImage loadImage(const QString &name, const QSize &size, qreal devicePixelRatio)
+    {
+        const auto icon = DIconTheme::findQIcon(name);
+        if (icon.isNull())
+            return QImage();
+        return icon.pixmap(size, devicePixelRatio).toImage();
+    }
+
+    // the cache may be read from the loader thread of the QML engine, and from the workers of the panels.
+    mutable QMutex m_mutex;
+    QCache<QString, QImage> m_images;
+    QCache<QString, QString> m_iconNames;
+    QCache<QByteArray, QString> m_dataUrls;
+    QString m_themeName;
+
+    D_DECLARE_PUBLIC(DIconCache)
+};
+
+// the response is answered on the thread of the cache, the loader thread of the QML engine never
+// waits for it. If the request is cancelled and the response deleted, the queued call is dropped.
+class DIconImageResponse : public QQuickImageResponse
+{
+public:
+    DIconImageResponse(const QString &name, const QSize &size)
+    {
+        auto cache = DIconCache::instance();
+        moveToThread(cache->thread());
+        QMetaObject::invokeMethod(this, [this, cache, name, size]() {
+            m_image = cache->image(name, size);
+            Q_EMIT finished();
+        }, Qt::QueuedConnection);
+    }
+
+    QQuickTextureFactory *textureFactory() const override
+    {
+        return QQuickTextureFactory::textureFactoryForImage(m_image);
+    }
+
+    QString errorString() const override
+    {
+        return m_image.isNull() ? QStringLiteral("The icon isn't found in the icon theme") : QString();
+    }
+
+private:
+    QImage m_image;
+};
+
+class DIconImageProvider : public QQuickAsyncImageProvider
+{
+public:
+    // the requested size is in device pixels already, `?size=<n>` is used if it isn't given.
+    QQuickImageResponse *requestImageResponse(const QString &id, const QSize &requestedSize) override
+    {
+        const auto query = id.lastIndexOf(QLatin1Char('?'));
+        const auto name = QUrl::fromPercentEncoding(id.left(query).toUtf8());
+        int width = requestedSize.width() > 0 ? requestedSize.width() : requestedSize.height();
+        int height = requestedSize.height() > 0 ? requestedSize.height() : requestedSize.width();
+        if ((width <= 0 || height <= 0) && query >= 0)
+            width = height = QUrlQuery(id.mid(query + 1)).queryItemValue(QStringLiteral("size")).toInt();
+        if (width <= 0 || height <= 0)
+            width = height = DefaultIconSize;
+
+        return new DIconImageResponse(name, QSize(width, height));
+    }
+};
+
+DIconCache::DIconCache(QObject *parent)
+    : QObject(parent)
+    , DObject(*new DIconCachePrivate(this))
+{
+    auto helper = DGuiApplicationHelper::instance();
+    connect(helper, &DGuiApplicationHelper::themeTypeChanged, this, &DIconCache::invalidate);
+    connect(helper->applicationTheme(), &DPlatformTheme::iconThemeNameChanged, this, &DIconCache::invalidate);
+}
+
+DIconCache *DIconCache::instance()
+{
+    static DIconCache *g_instance = nullptr;
+    static QMutex mutex;
+    QMutexLocker locker(&mutex);
+    if (!g_instance) {
+        g_instance = new DIconCache();
+        // the first access may come from the loader thread of the QML engine.
+        if (g_instance->thread() != qApp->thread())
+            g_instance->moveToThread(qApp->thread());
+    }
+    return g_instance;
+}
+
+QQuickAsyncImageProvider *DIconCache::createImageProvider()
+{
+    return new DIconImageProvider();
+}
+
+QString DIconCache::iconName(const QString &name, const QString &fallback)
+{
+    D_D(DIconCache);
+    QString key;
+    {
+        QMutexLocker locker(&d->m_mutex);
+        key = QStringLiteral("%1|%2|%3").arg(name, fallback, d->m_themeName);
+        if (auto iconName = d->m_iconNames.object(key))
+            return *iconName;
+    }
+
+    const auto icon = DIconTheme::findQIcon(name, fallback.isEmpty() ? QIcon() : DIconTheme::findQIcon(fallback));
+    const auto iconName = icon.name();
+
+    QMutexLocker locker(&d->m_mutex);
+    d->m_iconNames.insert(key, new QString(iconName));
+    return iconName;
+}
+
+QImage DIconCache::image(const QString &name, const QSize &size, qreal devicePixelRatio)
+{
+    D_D(DIconCache);
+    if (name.isEmpty() || size.isEmpty())
+        return QImage();
+
+    QImage image;
+    if (cachedImage(name, size, devicePixelRatio, &image))
+        return image;
+
+    // icons are rasterized on the thread of the cache, the icon engines aren't thread safe.
+    if (QThread::currentThread() != thread()) {
+        qCWarning(dsLog) << "The icon isn't cached, it's only rasterized on the thread of the cache" << name;
+        return QImage();
+    }
+    image = DIconCachePrivate::loadImage(name, size, devicePixelRatio);
+
+    // an icon not found is cached as well, it's looked up again only after the theme changes.
+    QMutexLocker locker(&d->m_mutex);
+    d->m_images.insert(d->imageKey(name, size, devicePixelRatio), new QImage(image), costOf(image.sizeInBytes()));
+    return image;
+}
+
+bool DIconCache::cachedImage(const QString &name, const QSize &size, qreal devicePixelRatio, QImage *image) const
+{
+    D_DC(DIconCache);
+    QMutexLocker locker(&d->m_mutex);
+    auto cached = d->m_images.object(d->imageKey(name, size, devicePixelRatio));
+    if (!cached)
+        return false;
+    if (image)
+        *image = *cached;
+    return true;
+}
+
+QString DIconCache::imageDataUrl(const QImage &image)
+{
+    D_D(DIconCache);
+    if (image.isNull())
+        return QString();
+
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    for (const int value : {image.width(), image.height(), int(image.format())})
+        hash.addData(QByteArrayView(reinterpret_cast<const char *>(&value), sizeof(value)));
+    hash.addData(QByteArrayView(reinterpret_cast<const char *>(image.constBits()), image.sizeInBytes()));
+    const auto key = hash.result();
+
+    {
+        QMutexLocker locker(&d->m_mutex);
+        if (auto dataUrl = d->m_dataUrls.object(key))
+            return *dataUrl;
+    }
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "PNG");
+    const auto dataUrl = QStringLiteral("data:image/png;base64,") + QString::fromLatin1(buffer.data().toBase64());
+
+    QMutexLocker locker(&d->m_mutex);
+    d->m_dataUrls.insert(key, new QString(dataUrl), costOf(dataUrl.size() * sizeof(QChar)));
+    return dataUrl;
+}
+
+int DIconCache::imageCount() const
+{
+    D_DC(DIconCache);
+    QMutexLocker locker(&d->m_mutex);
+    return d->m_images.count();
+}
+
+void DIconCache::invalidate()
+{
+    D_D(DIconCache);
+    {
+        QMutexLocker locker(&d->m_mutex);
+        d->m_images.clear();
+        d->m_iconNames.clear();
+        d->m_themeName = QIcon::themeName();
+    }
+    Q_EMIT invalidated();
+}
+
+DS_END_NAMESPACE
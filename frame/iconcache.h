@@ -0,0 +1,54 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "dsglobal.h"
+
+#include <DObject>
+#include <QImage>
+#include <QObject>
+
+class QQuickAsyncImageProvider;
+
+DS_BEGIN_NAMESPACE
+
+/**
+ * @brief 进程内共享的图标缓存
+ *
+ * 图标按 (名称, 图标主题, 尺寸, 缩放比) 缓存，按最近最少使用淘汰，图标主题或主题类型变化时清空。
+ * 图标在 QML 中以 image://dsicon/<name> 访问，图标在缓存所在线程异步光栅化，不阻塞 QML 的加载线程；
+ * 无法指定 sourceSize 的场景（如 Drag.imageSource）可用 image://dsicon/<name>?size=<n> 指定尺寸。
+ */
+class DIconCachePrivate;
+class DS_SHARE DIconCache : public QObject, public DTK_CORE_NAMESPACE::DObject
+{
+    Q_OBJECT
+    D_DECLARE_PRIVATE(DIconCache)
+public:
+    static DIconCache *instance();
+    static QQuickAsyncImageProvider *createImageProvider();
+
+    // the name of the icon found for `name` in the icon theme, or `fallback` if it isn't found.
+    QString iconName(const QString &name, const QString &fallback = QString());
+    // `size` is in device independent pixels, a miss is rasterized, so it's called on the thread of the cache.
+    QImage image(const QString &name, const QSize &size, qreal devicePixelRatio = 1.0);
+    // looks up the cached image only, it can be called from any thread. Returns false on a miss.
+    bool cachedImage(const QString &name, const QSize &size, qreal devicePixelRatio, QImage *image) const;
+    // the "data:image/png;base64," url of `image`, the same pixels are encoded only once.
+    QString imageDataUrl(const QImage &image);
+
+    int imageCount() const;
+
+public Q_SLOTS:
+    void invalidate();
+
+Q_SIGNALS:
+    void invalidated();
+
+protected:
+    explicit DIconCache(QObject *parent = nullptr);
+};
+
+DS_END_NAMESPACE
@@ -21,8 +21,10 @@ public:
     ~DAppletBridgePrivate() override;
 
     QList<DApplet *> applets() const;
+    void watchRegistry();
 
     QString m_pluginId;
+    bool m_watchingRegistry = false;
 
     D_DECLARE_PUBLIC(DAppletBridge);
 };
@@ -0,0 +1,46 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "dsglobal.h"
+
+#include <QHash>
+#include <QObject>
+
+DS_BEGIN_NAMESPACE
+class DApplet;
+class DAppletProxy;
+
+/**
+ * @brief 已创建插件的索引，由 DContainment 维护，供 DAppletBridge 查找
+ */
+class DAppletRegistry : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DAppletRegistry(QObject *parent = nullptr);
+    ~DAppletRegistry() override;
+
+    static DAppletRegistry *instance();
+
+    void registerApplet(DApplet *applet);
+    void unregisterApplet(DApplet *applet);
+
+    bool contains(const QString &pluginId) const;
+    QList<DApplet *> applets(const QString &pluginId) const;
+    QList<DAppletProxy *> proxies(const QString &pluginId) const;
+    DAppletProxy *proxy(const QString &pluginId) const;
+
+Q_SIGNALS:
+    void appletAdded(const QString &pluginId, DApplet *applet);
+    void appletRemoved(const QString &pluginId, DApplet *applet);
+
+private:
+    QHash<QString, QList<DApplet *>> m_applets;
+    // pluginId is captured on registration, it can't be read back from a destroyed applet.
+    QHash<DApplet *, QString> m_pluginIds;
+};
+
+DS_END_NAMESPACE
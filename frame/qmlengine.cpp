@@ -4,6 +4,7 @@
 
 #include "qmlengine.h"
 #include "applet.h"
+#include "iconcache.h"
 
 #include <dobject_p.h>
 #include <QCoreApplication>
@@ -12,13 +13,75 @@
 #include <QQmlComponent>
 #include <QQmlContext>
 #include <QQmlEngine>
-#include <QTimer>
+#include <QQmlIncubator>
+#include <QQmlIncubationController>
+#include <QQuickImageProvider>
+#include <QBasicTimer>
+#include <QPointer>
+#include <QTimerEvent>
 
 DS_BEGIN_NAMESPACE
 DCORE_USE_NAMESPACE
 
 Q_DECLARE_LOGGING_CATEGORY(dsLog)
 
+// Incubates objects in time-sliced chunks, the GUI thread gets back control between slices.
+class DQmlIncubationController : public QObject, public QQmlIncubationController
+{
+public:
+    explicit DQmlIncubationController(QObject *parent = nullptr)
+        : QObject(parent)
+    {
+    }
+
+protected:
+    void incubatingObjectCountChanged(int count) override
+    {
+        if (count > 0) {
+            if (!m_timer.isActive())
+                m_timer.start(0, this);
+        } else {
+            m_timer.stop();
+        }
+    }
+    void timerEvent(QTimerEvent *event) override
+    {
+        if (event->timerId() != m_timer.timerId())
+            return QObject::timerEvent(event);
+
+        incubateFor(IncubateSliceMs);
+        if (incubatingObjectCount() <= 0)
+            m_timer.stop();
+    }
+
+private:
+    static constexpr int IncubateSliceMs = 5;
+    QBasicTimer m_timer;
+};
+
+class DQmlEnginePrivate;
+class DQmlIncubator : public QQmlIncubator
+{
+public:
+    explicit DQmlIncubator(DQmlEnginePrivate *d)
+        : QQmlIncubator(QQmlIncubator::Asynchronous)
+        , m_d(d)
+    {
+    }
+    // the engine is being destroyed, the remaining status changes aren't reported to it.
+    void detach()
+    {
+        m_d = nullptr;
+    }
+
+protected:
+    void setInitialState(QObject *object) override;
+    void statusChanged(Status status) override;
+
+private:
+    DQmlEnginePrivate *m_d = nullptr;
+};
+
 class DQmlEnginePrivate : public DObjectPrivate
 {
 public:
@@ -26,11 +89,29 @@ public:
         : DObjectPrivate(qq)
     {
 
+    }
+    ~DQmlEnginePrivate() override
+    {
+        if (m_incubator) {
+            m_incubator->detach();
+            if (m_incubator->isLoading()) {
+                // the root object belongs to the applet once it's handed out, it's completed instead of
+                // being destroyed with the incubation.
+                if (m_rootObject) {
+                    m_incubator->forceCompletion();
+                } else {
+                    m_incubator->clear();
+                }
+            }
+            delete m_incubator;
+        }
     }
     DApplet *m_applet = nullptr;
     QQmlContext *m_context = nullptr;
-    QQmlComponent *m_component = nullptr;
+    QPointer<QQmlComponent> m_component;
+    DQmlIncubator *m_incubator = nullptr;
     QObject *m_rootObject = nullptr;
+    bool m_completeRequested = false;
     QQmlEngine *engine()
     {
         static QQmlEngine *s_engine = nullptr;
@@ -46,24 +127,93 @@ public:
                 paths.prepend(pluginDir.absolutePath());
             }
             s_engine->setImportPathList(paths);
+            s_engine->setIncubationController(new DQmlIncubationController(s_engine));
+            s_engine->addImageProvider(QStringLiteral("dsicon"), DIconCache::createImageProvider());
             qCDebug(dsLog()) << "Engine importPaths" << s_engine->importPathList();
         }
         return s_engine;
     }
+    static QHash<QUrl, QPointer<QQmlComponent>> &components()
+    {
+        static QHash<QUrl, QPointer<QQmlComponent>> s_components;
+        return s_components;
+    }
+    // Components are shared by url, so one compilation serves all users of the same url.
+    // Only ready or loading components are cached, a failed url is loaded again by the next user.
+    QQmlComponent *component(const QUrl &url, QQmlComponent::CompilationMode mode = QQmlComponent::Asynchronous)
+    {
+        QQmlComponent *component = components().value(url);
+        if (component && !component->isError() && !(mode == QQmlComponent::PreferSynchronous && component->isLoading()))
+            return component;
+
+        // a synchronous load of an url being compiled waits for that compilation in the type loader
+        // instead of compiling it again, the pending component still finishes for its waiters.
+        auto qmlEngine = engine();
+        component = new QQmlComponent(qmlEngine, qmlEngine);
+        QObject::connect(component, &QQmlComponent::statusChanged, component, [url, component](QQmlComponent::Status status) {
+            if (status != QQmlComponent::Error)
+                return;
+            auto &components = DQmlEnginePrivate::components();
+            if (components.value(url) == component)
+                components.remove(url);
+        });
+        component->loadUrl(url, mode);
+        if (component->isError()) {
+            components().remove(url);
+        } else {
+            components().insert(url, component);
+        }
+        return component;
+    }
     void continueLoading()
     {
         D_Q(DQmlEngine);
+        if (m_incubator)
+            return;
+
         if (m_component->isReady()) {
-            m_rootObject = m_component->beginCreate(m_context);
-            Q_EMIT q->createFinished();
+            QObject::disconnect(m_component, &QQmlComponent::statusChanged, q, nullptr);
+            m_incubator = new DQmlIncubator(this);
+            m_component->create(*m_incubator, m_context);
         } else if (m_component->isError()) {
+            QObject::disconnect(m_component, &QQmlComponent::statusChanged, q, nullptr);
             qCWarning(dsLog()) << "Loading url failed" << m_component->errorString();
             Q_EMIT q->createFinished();
         }
     }
+    void onObjectCreated(QObject *object)
+    {
+        D_Q(DQmlEngine);
+        m_rootObject = object;
+        Q_EMIT q->createFinished();
+    }
+    void onIncubatorStatusChanged(QQmlIncubator::Status status)
+    {
+        D_Q(DQmlEngine);
+        if (status == QQmlIncubator::Ready) {
+            if (m_completeRequested)
+                Q_EMIT q->finished();
+        } else if (status == QQmlIncubator::Error) {
+            qCWarning(dsLog()) << "Creating object failed" << m_incubator->errors();
+            if (!m_rootObject)
+                Q_EMIT q->createFinished();
+        }
+    }
     D_DECLARE_PUBLIC(DQmlEngine)
 };
 
+void DQmlIncubator::setInitialState(QObject *object)
+{
+    if (m_d)
+        m_d->onObjectCreated(object);
+}
+
+void DQmlIncubator::statusChanged(Status status)
+{
+    if (m_d)
+        m_d->onIncubatorStatusChanged(status);
+}
+
 DQmlEngine::DQmlEngine(QObject *parent)
     : DQmlEngine(nullptr, parent)
 {
@@ -85,30 +235,26 @@ DQmlEngine::~DQmlEngine()
 void DQmlEngine::completeCreate()
 {
     D_D(DQmlEngine);
-    if (!d->m_component)
-        return;
-
-    if (!d->m_component->isReady())
+    if (!d->m_incubator)
         return;
 
-    d->m_component->completeCreate();
-    Q_EMIT finished();
+    // the incubator finishes the remaining bindings in later slices, finished is emitted then.
+    d->m_completeRequested = true;
+    if (d->m_incubator->isReady())
+        Q_EMIT finished();
 }
 
 bool DQmlEngine::create()
 {
     D_D(DQmlEngine);
-    std::unique_ptr<QQmlComponent> component(new QQmlComponent(engine(), this));
     const QString url = d->m_applet->pluginMetaData().url();
     if (url.isEmpty())
         return true;
 
-    component->loadUrl(url, QQmlComponent::Asynchronous);
-
     auto context = new QQmlContext(engine(), d->m_applet);
     context->setContextProperty("_ds_applet", d->m_applet);
     d->m_context = context;
-    d->m_component = component.release();
+    d->m_component = d->component(QUrl(url));
     if (d->m_component->isLoading()) {
         QObject::connect(d->m_component, &QQmlComponent::statusChanged, this, [this]() {
             D_D(DQmlEngine);
@@ -127,10 +273,10 @@ QObject *DQmlEngine::createObject(const QUrl &url)
 
 QObject *DQmlEngine::createObject(const QUrl &url, const QVariantMap &initialProperties)
 {
-    QQmlEngine *engine = DQmlEngine().engine();
-    std::unique_ptr<QQmlComponent> component(new QQmlComponent(engine));
-    component->loadUrl(url);
-    if (component->isError()) {
+    DQmlEngine helper;
+    QQmlEngine *engine = helper.engine();
+    QQmlComponent *component = helper.d_func()->component(url, QQmlComponent::PreferSynchronous);
+    if (!component->isReady()) {
         qCWarning(dsLog()) << "Loading url failed" << component->errorString();
         return nullptr;
     }
@@ -143,6 +289,30 @@ QObject *DQmlEngine::createObject(const QUrl &url, const QVariantMap &initialPro
     return object;
 }
 
+void DQmlEngine::preload(const QList<QUrl> &urls)
+{
+    DQmlEngine helper;
+    for (const auto &url : urls) {
+        if (url.isEmpty())
+            continue;
+        qCDebug(dsLog()) << "Preloading url" << url;
+        helper.d_func()->component(url);
+    }
+}
+
+QList<QUrl> DQmlEngine::frameUrls()
+{
+    return {
+        QUrl("qrc:/ddeshell/qml/PanelPopupWindow.qml"),
+        QUrl("qrc:/ddeshell/qml/PanelToolTipWindow.qml"),
+        QUrl("qrc:/ddeshell/qml/PanelMenuWindow.qml"),
+        QUrl("qrc:/ddeshell/qml/PanelPopup.qml"),
+        QUrl("qrc:/ddeshell/qml/PanelToolTip.qml"),
+        QUrl("qrc:/ddeshell/qml/PanelMenu.qml"),
+        QUrl("qrc:/ddeshell/qml/QuickDragWindow.qml"),
+    };
+}
+
 QObject *DQmlEngine::rootObject() const
 {
     D_DC(DQmlEngine);
@@ -31,12 +31,17 @@ public:
 
     static QObject *createObject(const QUrl &url);
     static QObject *createObject(const QUrl &url, const QVariantMap &initialProperties);
+    static void preload(const QList<QUrl> &urls);
+    static QList<QUrl> frameUrls();
 
     bool create();
     void completeCreate();
 
 Q_SIGNALS:
+    // the root object is completed, its bindings are evaluated, it's emitted after `completeCreate()`.
     void finished();
+    // the root object is created but its bindings may not be evaluated yet, its properties aren't
+    // reliable until `finished`. rootObject() is null if the creation failed.
     void createFinished();
 };
 
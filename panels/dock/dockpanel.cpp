@@ -21,6 +21,7 @@
 #include <QQuickWindow>
 #include <QLoggingCategory>
 #include <QGuiApplication>
+#include <QJsonDocument>
 #include <QQuickItem>
 #include <DGuiApplicationHelper>
 
@@ -310,6 +311,11 @@ void DockPanel::callShow()
 // TODO: implement this function
 }
 
+QString DockPanel::TrayPluginLoaderStatistics() const
+{
+    return QString::fromUtf8(QJsonDocument(m_loadTrayPlugins->statistics()).toJson(QJsonDocument::Compact));
+}
+
 bool DockPanel::debugMode() const
 {
 #ifndef QT_DEBUG
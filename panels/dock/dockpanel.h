@@ -45,6 +45,7 @@ public:
 
     void ReloadPlugins();
     void callShow();
+    QString TrayPluginLoaderStatistics() const;
 
     QRect geometry();
     QRect frontendWindowRect();
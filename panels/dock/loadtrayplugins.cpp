@@ -6,19 +6,39 @@
 #include "environments.h"
 
 #include <signal.h>
+#include <unistd.h>
 
 #include <DConfig>
 
 #include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonObject>
 #include <QTimer>
 #include <QGuiApplication>
 
 namespace dock {
 
+static const QString selfMaintenancePluginsKey = "selfMaintenanceTrayPlugins";
+static const QString subprojectPluginsKey = "subprojectTrayPlugins";
+static const QString crashPronePluginsKey = "crashProneTrayPlugins";
+static const QString otherPluginsKey = "otherTrayPlugins";
+
+// restart delay doubles for every consecutive crash, starting from 1s.
+static constexpr int RetryBaseDelayMs = 1000;
+static constexpr int RetryMaxDelayMs = 30 * 1000;
+// a loader running longer than this isn't counted as crash looping anymore.
+static constexpr qint64 StableRunMs = 60 * 1000;
+// crashes of a multi-plugin loader before its plugins are split into separate loaders.
+static constexpr int SplitCrashThreshold = 2;
+
 LoadTrayPlugins::LoadTrayPlugins(QObject *parent)
     : QObject(parent)
+    , m_config(Dtk::Core::DConfig::create("org.deepin.dde.shell", "org.deepin.ds.dock.tray", QString(), this))
 {
-
+    m_processEnv = QProcessEnvironment::systemEnvironment();
+    // TODO: use protocols to determine the environment instead of environment variables
+    m_processEnv.remove("DDE_CURRENT_COMPOSITOR");
 }
 
 LoadTrayPlugins::~LoadTrayPlugins()
@@ -34,20 +54,64 @@ LoadTrayPlugins::~LoadTrayPlugins()
 
 void LoadTrayPlugins::loadDockPlugins()
 {
-    QString validExePath = loaderPath();
-    if (validExePath.isEmpty()) {
+    if (m_loaderPath.isEmpty())
+        m_loaderPath = loaderPath();
+    if (m_loaderPath.isEmpty()) {
         qWarning() << "No valid loader executable path found.";
         return;
     }
 
-    auto pluginGroupMap = groupPlugins(allPluginPaths());
-    for (auto it = pluginGroupMap.begin(); it != pluginGroupMap.end(); ++it) {
-        if (it.value().isEmpty()) continue;
-        qDebug() << "Load plugin:" << it.value() << " group:" << it.key();
-        startProcess(validExePath, it.value(), it.key());
+    if (m_pluginPaths.isEmpty())
+        m_pluginPaths = allPluginPaths();
+
+    for (const auto &group : groupPlugins(m_pluginPaths)) {
+        if (group.pluginPaths.isEmpty()) continue;
+        qDebug() << "Load plugin:" << group.pluginPaths << " group:" << group.name;
+        startProcess(m_loaderPath, group.pluginPaths, group.name);
     }
 }
 
+QJsonArray LoadTrayPlugins::statistics() const
+{
+    static const long clockTicks = sysconf(_SC_CLK_TCK);
+    static const long pageSize = sysconf(_SC_PAGESIZE);
+
+    QJsonArray result;
+    for (const auto &pInfo : m_processes) {
+        QJsonObject item;
+        item["group"] = pInfo.groupName;
+        item["plugins"] = QJsonArray::fromStringList(pInfo.pluginPaths);
+        item["restartCount"] = pInfo.restartCount;
+        item["crashCount"] = pInfo.crashCount;
+
+        const qint64 pid = pInfo.process ? pInfo.process->processId() : 0;
+        item["pid"] = pid;
+        if (pid > 0) {
+            item["uptimeMs"] = pInfo.uptime.isValid() ? pInfo.uptime.elapsed() : 0;
+
+            // utime and stime are the 14th and 15th fields, the command name may contain spaces.
+            QFile stat(QString("/proc/%1/stat").arg(pid));
+            if (stat.open(QIODevice::ReadOnly)) {
+                const QByteArray content = stat.readAll();
+                const auto fields = content.mid(content.lastIndexOf(')') + 2).split(' ');
+                if (fields.size() > 12 && clockTicks > 0) {
+                    const qint64 ticks = fields.at(11).toLongLong() + fields.at(12).toLongLong();
+                    item["cpuTimeMs"] = ticks * 1000 / clockTicks;
+                }
+            }
+
+            QFile statm(QString("/proc/%1/statm").arg(pid));
+            if (statm.open(QIODevice::ReadOnly)) {
+                const auto fields = statm.readAll().split(' ');
+                if (fields.size() > 1)
+                    item["rssBytes"] = fields.at(1).toLongLong() * pageSize;
+            }
+        }
+        result.append(item);
+    }
+    return result;
+}
+
 void LoadTrayPlugins::handleProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
 {
     auto *process = qobject_cast<QProcess*>(sender());
@@ -56,49 +120,114 @@ void LoadTrayPlugins::handleProcessFinished(int exitCode, QProcess::ExitStatus e
     if (exitCode == SIGKILL || exitCode == SIGTERM || exitStatus != QProcess::CrashExit) return;
 
     for (auto it = m_processes.begin(); it != m_processes.end(); ++it) {
-        if (it->process == process) {
-            if (it->retryCount < m_maxRetries) {
-                it->retryCount++;
-                qWarning() << "Plugin exit:" << it->pluginPath << " code:" << exitCode << " exitStatus:" << exitStatus;
-                QTimer::singleShot(1000, process, [ this, process ] {
-                    setProcessEnv(process);
-                    process->start();
-                });
-            } else {
-                qWarning() << "Maximum retries reached for plugin:" << it->pluginPath;
-                process->deleteLater();
-                m_processes.erase(it);
+        if (it->process != process)
+            continue;
+
+        qWarning() << "Plugin exit:" << it->pluginPaths << " code:" << exitCode << " exitStatus:" << exitStatus;
+        if (it->uptime.isValid() && it->uptime.elapsed() > StableRunMs) {
+            it->retryCount = 0;
+            it->recentCrashCount = 0;
+        }
+        it->crashCount++;
+        it->recentCrashCount++;
+
+        if (it->recentCrashCount >= SplitCrashThreshold) {
+            if (it->pluginPaths.size() > 1) {
+                splitProcess(process);
+                break;
             }
-            break;
+            markCrashPronePlugin(it->pluginPaths.first());
+        }
+
+        if (it->retryCount < m_maxRetries) {
+            it->retryCount++;
+            it->restartCount++;
+            restartProcess(process, it->retryCount);
+        } else {
+            qWarning() << "Maximum retries reached for plugin:" << it->pluginPaths;
+            process->deleteLater();
+            m_processes.erase(it);
         }
+        break;
     }
 }
 
-void LoadTrayPlugins::startProcess(const QString &loaderPath, const QString &pluginPath, const QString &groupName)
+void LoadTrayPlugins::startProcess(const QString &loaderPath, const QStringList &pluginPaths, const QString &groupName, int retryCount)
 {
     auto *process = new QProcess(this);
-    setProcessEnv(process);
+    process->setProcessEnvironment(m_processEnv);
 
     connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
             this, &LoadTrayPlugins::handleProcessFinished);
 
-    ProcessInfo pInfo = { process, pluginPath, 0 };
+    ProcessInfo pInfo;
+    pInfo.process = process;
+    pInfo.groupName = groupName;
+    pInfo.pluginPaths = pluginPaths;
+    pInfo.retryCount = retryCount;
+    pInfo.uptime.start();
     m_processes.append(pInfo);
 
     process->setProgram(loaderPath);
-    process->setArguments({"-p", pluginPath, "-g", groupName, "-platform", "wayland"});
-    process->start();
+    process->setArguments({"-p", pluginPaths.join(";"), "-g", groupName, "-platform", "wayland"});
+    if (retryCount > 0) {
+        restartProcess(process, retryCount);
+    } else {
+        process->start();
+    }
 }
 
-void LoadTrayPlugins::setProcessEnv(QProcess *process)
+void LoadTrayPlugins::restartProcess(QProcess *process, int retryCount)
 {
-    if (!process) return;
+    const int delay = qMin(RetryBaseDelayMs << qMin(qMax(0, retryCount - 1), 16), RetryMaxDelayMs);
+    QTimer::singleShot(delay, process, [ this, process ] {
+        for (auto &pInfo : m_processes) {
+            if (pInfo.process == process) {
+                pInfo.uptime.start();
+                break;
+            }
+        }
+        process->start();
+    });
+}
 
-    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
-    // TODO: use protocols to determine the environment instead of environment variables
-    env.remove("DDE_CURRENT_COMPOSITOR");
+// Bisect a crashing loader, repeated crashes eventually leave the faulty plugin alone in its process.
+void LoadTrayPlugins::splitProcess(QProcess *process)
+{
+    auto it = std::find_if(m_processes.begin(), m_processes.end(), [process](const ProcessInfo &pInfo) {
+        return pInfo.process == process;
+    });
+    if (it == m_processes.end())
+        return;
 
-    process->setProcessEnvironment(env);
+    const ProcessInfo pInfo = *it;
+    m_processes.erase(it);
+    process->deleteLater();
+
+    const auto half = pInfo.pluginPaths.size() / 2;
+    qWarning() << "Split crashing plugin loader:" << pInfo.pluginPaths;
+    // the halves back off like a restart of the crashed loader, each one is a group of its own.
+    const int retryCount = qMin(pInfo.retryCount + 1, m_maxRetries);
+    for (const auto &paths : {pInfo.pluginPaths.mid(0, half), pInfo.pluginPaths.mid(half)}) {
+        const QString groupName = QString("%1-split%2").arg(pInfo.groupName).arg(++m_splitSerial);
+        startProcess(m_loaderPath, paths, groupName, retryCount);
+        m_processes.last().restartCount = pInfo.restartCount + 1;
+    }
+}
+
+void LoadTrayPlugins::markCrashPronePlugin(const QString &pluginPath)
+{
+    if (!m_config || !m_config->isValid())
+        return;
+
+    const QString pluginName = pluginPath.section("/", -1);
+    auto crashProneTrayPlugins = m_config->value(crashPronePluginsKey).toStringList();
+    if (crashProneTrayPlugins.contains(pluginName))
+        return;
+
+    qWarning() << "Mark plugin as crash-prone:" << pluginName;
+    crashProneTrayPlugins.append(pluginName);
+    m_config->setValue(crashPronePluginsKey, crashProneTrayPlugins);
 }
 
 QString LoadTrayPlugins::loaderPath() const
@@ -145,28 +274,27 @@ QStringList LoadTrayPlugins::allPluginPaths() const
     return pluginPaths;
 }
 
-QMap<QString, QString> LoadTrayPlugins::groupPlugins(const QStringList &pluginPaths) const
+QList<LoadTrayPlugins::LoaderGroup> LoadTrayPlugins::groupPlugins(const QStringList &pluginPaths) const
 {
-    const QString selfMaintenancePluginsKey = "selfMaintenanceTrayPlugins";
-    const QString subprojectPluginsKey = "subprojectTrayPlugins";
-    const QString crashPronePluginsKey = "crashProneTrayPlugins";
-    const QString otherPluginsKey = "otherTrayPlugins";
-
-    auto dConfig = Dtk::Core::DConfig::create("org.deepin.dde.shell", "org.deepin.ds.dock.tray", QString());
-    QStringList selfMaintenanceTrayPlugins = dConfig->value(selfMaintenancePluginsKey).toStringList();
-    QStringList subprojectTrayPlugins = dConfig->value(subprojectPluginsKey).toStringList();
-    QStringList crashProneTrayPlugins = dConfig->value(crashPronePluginsKey).toStringList();
-    dConfig->deleteLater();
+    QStringList selfMaintenanceTrayPlugins;
+    QStringList subprojectTrayPlugins;
+    QStringList crashProneTrayPlugins;
+    if (m_config && m_config->isValid()) {
+        selfMaintenanceTrayPlugins = m_config->value(selfMaintenancePluginsKey).toStringList();
+        subprojectTrayPlugins = m_config->value(subprojectPluginsKey).toStringList();
+        crashProneTrayPlugins = m_config->value(crashPronePluginsKey).toStringList();
+    }
 
     QStringList selfMaintenancePluginPaths;
     QStringList subprojectPluginPaths;
-    QStringList crashPronePluginPaths;
     QStringList otherPluginPaths;
+    QList<LoaderGroup> pluginGroup;
 
     for (auto &filePath : pluginPaths) {
         QString pluginName = filePath.section("/", -1);
         if (crashProneTrayPlugins.contains(pluginName)) {
-            crashPronePluginPaths.append(filePath);
+            // crash-prone plugins are isolated, each one gets its own loader and group.
+            pluginGroup.append({QString("%1-%2").arg(crashPronePluginsKey, QFileInfo(filePath).completeBaseName()), {filePath}});
         } else if (selfMaintenanceTrayPlugins.contains(pluginName)) {
             selfMaintenancePluginPaths.append(filePath);
         } else if (subprojectTrayPlugins.contains(pluginName)) {
@@ -176,22 +304,16 @@ QMap<QString, QString> LoadTrayPlugins::groupPlugins(const QStringList &pluginPa
         }
     }
 
-    QMap<QString, QString> pluginGroup;
-
     if (!selfMaintenancePluginPaths.isEmpty()) {
-        pluginGroup.insert(selfMaintenancePluginsKey, selfMaintenancePluginPaths.join(";"));
+        pluginGroup.append({selfMaintenancePluginsKey, selfMaintenancePluginPaths});
     }
 
     if (!subprojectPluginPaths.isEmpty()) {
-        pluginGroup.insert(subprojectPluginsKey, subprojectPluginPaths.join(";"));
-    }
-
-    if (!crashPronePluginPaths.isEmpty()) {
-        pluginGroup.insert(crashPronePluginsKey, crashPronePluginPaths.join(";"));
+        pluginGroup.append({subprojectPluginsKey, subprojectPluginPaths});
     }
 
     if (!otherPluginPaths.isEmpty()) {
-        pluginGroup.insert(otherPluginsKey, otherPluginPaths.join(";"));
+        pluginGroup.append({otherPluginsKey, otherPluginPaths});
     }
 
     return pluginGroup;
@@ -4,8 +4,16 @@
 
 #pragma once
 
+#include <QElapsedTimer>
+#include <QJsonArray>
 #include <QProcess>
 
+namespace Dtk {
+namespace Core {
+class DConfig;
+}
+}
+
 namespace dock {
 const QStringList pluginDirs = {
         "/usr/lib/dde-dock/plugins/",
@@ -22,25 +30,47 @@ public:
 
     void loadDockPlugins();
 
+    // per loader process: group, plugins, pid, cpu time, rss and restart counters.
+    QJsonArray statistics() const;
+
 private slots:
     void handleProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
 
 private:
+    struct LoaderGroup {
+        QString name;
+        QStringList pluginPaths;
+    };
+
     QString loaderPath() const;
     QStringList allPluginPaths() const;
-    QMap<QString, QString> groupPlugins(const QStringList &pluginPaths) const;
+    QList<LoaderGroup> groupPlugins(const QStringList &pluginPaths) const;
 
-    void startProcess(const QString &loaderPath, const QString &pluginPath, const QString &groupName);
-    void setProcessEnv(QProcess *process);
+    void startProcess(const QString &loaderPath, const QStringList &pluginPaths, const QString &groupName, int retryCount = 0);
+    void restartProcess(QProcess *process, int retryCount);
+    void splitProcess(QProcess *process);
+    void markCrashPronePlugin(const QString &pluginPath);
 
 private:
     struct ProcessInfo {
         QProcess *process = nullptr;
-        QString pluginPath;
+        QString groupName;
+        QStringList pluginPaths;
+        // consecutive crashes, reset once the loader runs stable.
         int retryCount = 0;
+        int recentCrashCount = 0;
+        int restartCount = 0;
+        int crashCount = 0;
+        QElapsedTimer uptime;
     };
 
     QList<ProcessInfo> m_processes;
+    Dtk::Core::DConfig *m_config = nullptr;
+    QProcessEnvironment m_processEnv;
+    QString m_loaderPath;
+    QStringList m_pluginPaths;
+    // makes the group names of split loaders unique.
+    int m_splitSerial = 0;
     const int m_maxRetries = 5;
 };
 
@@ -7,13 +7,18 @@
 #include "constants.h"
 
 #include <cstdint>
+#include <memory>
 
 #include <QtWaylandCompositor/QWaylandSurface>
 #include <QtWaylandCompositor/QWaylandResource>
 #include <QtWaylandCompositor/QWaylandCompositor>
+#include <QtWaylandCompositor/QWaylandQuickItem>
+#include <QtWaylandCompositor/QWaylandView>
 
 #include <QJsonObject>
 #include <QJsonParseError>
+#include <QQuickWindow>
+#include <QTimer>
 
 PluginScaleManager::PluginScaleManager(QWaylandCompositor *compositor)
     : QWaylandCompositorExtensionTemplate(compositor)
@@ -31,13 +36,17 @@ void PluginScaleManager::setPluginScale(const uint32_t &scale)
 
     auto outputs = m_compositor->outputs();
     std::for_each(outputs.begin(), outputs.end(), [this](auto *output) {
-        // 120 is base of fractional scale.
-        output->setScaleFactor(std::ceil(m_scale / 120));
+        output->setScaleFactor(outputScaleFactor());
     });
 
     Q_EMIT pluginScaleChanged(m_scale);
 }
 
+int PluginScaleManager::outputScaleFactor() const
+{
+    return std::ceil(m_scale / 120);
+}
+
 uint32_t PluginScaleManager::pluginScale()
 {
     return m_scale;
@@ -52,7 +61,7 @@ void PluginScaleManager::initialize()
     init(compositor->display(), 1);
     m_compositor = compositor;
     connect(compositor, &QWaylandCompositor::outputAdded, this, [this](auto *output) {
-        output->setScaleFactor(std::ceil(m_scale / 120));
+        output->setScaleFactor(outputScaleFactor());
     });
 }
 
@@ -375,7 +384,16 @@ void PluginPopup::plugin_popup_source_size(Resource *resource, int32_t width, in
 
 PluginManager::PluginManager(QWaylandCompositor *compositor)
     : QWaylandCompositorExtensionTemplate(compositor)
-{
+    , m_dockSizeTimer(new QTimer(this))
+{
+    m_dockSizeTimer->setSingleShot(true);
+    m_dockSizeTimer->setInterval(100);
+    connect(m_dockSizeTimer, &QTimer::timeout, this, [this]() {
+        if (m_sentDockSize == m_dockSize)
+            return;
+        m_sentDockSize = m_dockSize;
+        sendEventMsg(dockSizeMsg());
+    });
 }
 
 void PluginManager::initialize()
@@ -383,6 +401,11 @@ void PluginManager::initialize()
     QWaylandCompositorExtensionTemplate::initialize();
     QWaylandCompositor *compositor = static_cast<QWaylandCompositor *>(extensionContainer());
     init(compositor->display(), 1);
+
+    // the outputs keep sending frame callbacks, hidden plugin views are taken off them, see updatePluginViews.
+    connect(compositor, &QWaylandCompositor::outputAdded, this, &PluginManager::watchOutput);
+    for (auto output : compositor->outputs())
+        watchOutput(output);
 }
 
 void PluginManager::updateDockOverflowState(int state)
@@ -488,6 +511,7 @@ void PluginManager::plugin_manager_v1_create_plugin(Resource *resource, const QS
 
     auto plugin = new PluginSurface(this, pluginId, itemKey, display_name, plugin_flags, type, size_policy, qwaylandSurface, shellSurfaceResource);
     m_pluginSurfaces << plugin;
+    trackPluginSurface(qwaylandSurface, QString("%1::%2").arg(pluginId, itemKey));
     Q_EMIT pluginSurfaceCreated(plugin);
 
     sendEventMsg(resource, dockSizeMsg());
@@ -502,6 +526,7 @@ void PluginManager::plugin_manager_v1_create_popup_at(Resource *resource, const
 
     auto plugin = new PluginPopup(this, pluginId, itemKey, x, y, type, qwaylandSurface, shellSurfaceResource);
     plugin->setX(x), plugin->setY(y);
+    trackPluginSurface(qwaylandSurface, QString("%1::%2::popup").arg(pluginId, itemKey));
     Q_EMIT pluginPopupCreated(plugin);
 }
 
@@ -563,7 +588,7 @@ void PluginManager::setDockSize(const QSize &newDockSize)
     if (m_dockSize == newDockSize)
         return;
     m_dockSize = newDockSize;
-    sendEventMsg(dockSizeMsg());
+    m_dockSizeTimer->start();
     emit dockSizeChanged();
 }
 
@@ -599,3 +624,71 @@ QString PluginManager::popupMinHeightMsg() const
 
     return toJson(obj);
 }
+
+QVariantList PluginManager::frameStatistics() const
+{
+    QVariantList result;
+    for (auto it = m_frameStates.cbegin(); it != m_frameStates.cend(); ++it) {
+        QQuickItem *item = nullptr;
+        if (auto view = it.key()->primaryView())
+            item = qobject_cast<QQuickItem *>(view->renderObject());
+
+        QVariantMap stats;
+        stats["surface"] = it->name;
+        stats["committedFrames"] = it->committedFrames;
+        stats["hidden"] = m_viewTracker.isHidden(item);
+        stats["hiddenFrames"] = m_viewTracker.hiddenFrames(item);
+        result << stats;
+    }
+    return result;
+}
+
+void PluginManager::trackPluginSurface(QWaylandSurface *surface, const QString &name)
+{
+    m_frameStates.insert(surface, SurfaceFrameState {name});
+
+    connect(surface, &QWaylandSurface::damaged, this, [this, surface](const QRegion &damage) {
+        auto it = m_frameStates.find(surface);
+        if (it == m_frameStates.end() || damage.isEmpty())
+            return;
+        it->committedFrames++;
+    });
+    connect(surface, &QObject::destroyed, this, [this, surface]() {
+        m_frameStates.remove(surface);
+    });
+}
+
+void PluginManager::watchOutput(QWaylandOutput *output)
+{
+    auto connection = std::make_shared<QMetaObject::Connection>();
+    auto connectWindow = [this, output, connection]() {
+        disconnect(*connection);
+        if (auto window = qobject_cast<QQuickWindow *>(output->window())) {
+            // before the frame is synchronized, so a view taken off the output misses its frame callbacks.
+            *connection = connect(window, &QQuickWindow::afterAnimating, output, [this, output]() {
+                updatePluginViews(output);
+            });
+        }
+    };
+    connect(output, &QWaylandOutput::windowChanged, this, connectWindow);
+    connectWindow();
+}
+
+// The output sends the frame callbacks itself, including wl_surface.enter and leave. The primary view of
+// a hidden plugin item is taken off the output, so the client stops drawing until it's shown again,
+// then the view is put back and the output sends the pending callbacks after the next frame.
+void PluginManager::updatePluginViews(QWaylandOutput *output)
+{
+    for (auto it = m_frameStates.cbegin(); it != m_frameStates.cend(); ++it) {
+        QWaylandView *view = it.key()->primaryView();
+        auto item = view ? qobject_cast<QWaylandQuickItem *>(view->renderObject()) : nullptr;
+        if (!item || item->window() != output->window())
+            continue;
+
+        m_viewTracker.update(item);
+        // the item may put its view back when its window changes, so it's applied every frame.
+        QWaylandOutput *target = m_viewTracker.isHidden(item) ? nullptr : output;
+        if (view->output() != target)
+            view->setOutput(target);
+    }
+}
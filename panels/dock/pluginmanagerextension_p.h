@@ -11,9 +11,15 @@
 #include <QtWaylandCompositor/QWaylandResource>
 #include <cstdint>
 
+#include "pluginviewtracker.h"
 #include "qwayland-server-fractional-scale-v1.h"
 #include "qwayland-server-plugin-manager-v1.h"
 
+QT_BEGIN_NAMESPACE
+class QTimer;
+class QWaylandOutput;
+QT_END_NAMESPACE
+
 class PluginSurface;
 class PluginPopup;
 class PluginScale;
@@ -35,7 +41,10 @@ Q_SIGNALS:
     void pluginScaleChanged(uint32_t scale);
 
 private:
-    uint32_t m_scale;
+    int outputScaleFactor() const;
+
+    // 120 is base of fractional scale.
+    uint32_t m_scale = 120;
     QWaylandCompositor *m_compositor;
 };
 
@@ -62,6 +71,8 @@ public:
 
     Q_INVOKABLE void updateDockOverflowState(int state);
     Q_INVOKABLE void setPopupMinHeight(int height);
+    // committed frames of every plugin surface, and the frames rendered while it's hidden.
+    Q_INVOKABLE QVariantList frameStatistics() const;
 
     uint32_t dockPosition() const;
     void setDockPosition(uint32_t dockPosition);
@@ -97,8 +108,21 @@ private:
     QString dockSizeMsg() const;
     QString popupMinHeightMsg() const;
 
+    struct SurfaceFrameState {
+        QString name;
+        quint64 committedFrames = 0;
+    };
+    void trackPluginSurface(QWaylandSurface *surface, const QString &name);
+    void watchOutput(QWaylandOutput *output);
+    void updatePluginViews(QWaylandOutput *output);
+
 private:
     QList<PluginSurface*> m_pluginSurfaces;
+    // dock size is broadcast after resizing settles, every message makes plugins reallocate their buffers.
+    QTimer *m_dockSizeTimer = nullptr;
+    QSize m_sentDockSize;
+    QHash<QWaylandSurface *, SurfaceFrameState> m_frameStates;
+    PluginViewTracker m_viewTracker;
 
     uint32_t m_dockPosition;
     uint32_t m_dockColorTheme;
@@ -0,0 +1,43 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "pluginviewtracker.h"
+
+bool PluginViewTracker::isShown(const QQuickItem *item)
+{
+    return item && item->isVisible() && !qFuzzyIsNull(item->opacity());
+}
+
+bool PluginViewTracker::update(QQuickItem *item)
+{
+    auto it = m_states.find(item);
+    // a reused address is another item.
+    if (it == m_states.end() || it->item != item) {
+        it = m_states.insert(item, State {item});
+    }
+
+    const bool hidden = !isShown(item);
+    if (hidden == it->hidden) {
+        if (hidden)
+            it->hiddenFrames++;
+        return false;
+    }
+    it->hidden = hidden;
+    return true;
+}
+
+bool PluginViewTracker::isHidden(const QQuickItem *item) const
+{
+    return m_states.value(item).hidden;
+}
+
+quint64 PluginViewTracker::hiddenFrames(const QQuickItem *item) const
+{
+    return m_states.value(item).hiddenFrames;
+}
+
+void PluginViewTracker::remove(const QQuickItem *item)
+{
+    m_states.remove(item);
+}
@@ -0,0 +1,38 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QHash>
+#include <QPointer>
+#include <QQuickItem>
+
+/**
+ * @brief The PluginViewTracker class
+ * Follows whether the items showing plugin surfaces are shown, i.e. effectively visible with a non zero
+ * opacity. The view of a hidden item is taken off its output, so the surface gets no frame callbacks
+ * until the item is shown again, the frame callbacks themselves are still sent by the output.
+ */
+class PluginViewTracker
+{
+public:
+    static bool isShown(const QQuickItem *item);
+
+    // updates the state of `item` for the frame being rendered, returns true if it's hidden or shown
+    // since the last update.
+    bool update(QQuickItem *item);
+    bool isHidden(const QQuickItem *item) const;
+    // frames rendered while `item` was hidden.
+    quint64 hiddenFrames(const QQuickItem *item) const;
+    void remove(const QQuickItem *item);
+
+private:
+    struct State
+    {
+        QPointer<QQuickItem> item;
+        bool hidden = false;
+        quint64 hiddenFrames = 0;
+    };
+    QHash<const QQuickItem *, State> m_states;
+};
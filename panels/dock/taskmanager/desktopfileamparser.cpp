@@ -6,6 +6,7 @@
 #include "abstractwindow.h"
 #include "desktopfileamparser.h"
 #include "desktopfileabstractparser.h"
+#include "iconcache.h"
 #include "objectmanager1interface.h"
 
 #include <unistd.h>
@@ -13,6 +14,7 @@
 
 #include <DDBusSender>
 #include <QDBusConnection>
+#include <QDir>
 #include <QLoggingCategory>
 
 Q_LOGGING_CATEGORY(amdesktopfileLog, "dde.shell.dock.amdesktopfile")
@@ -57,6 +59,14 @@ DesktopFileAMParser::DesktopFileAMParser(QString id, QObject* parent)
         Q_EMIT iconChanged();
     });
 
+    // the icon is resolved against the icon theme, it's looked up again after the theme changes.
+    connect(DS_NAMESPACE::DIconCache::instance(), &DS_NAMESPACE::DIconCache::invalidated, this, [this](){
+        if (m_icon.isEmpty())
+            return;
+        m_icon.clear();
+        Q_EMIT iconChanged();
+    });
+
     qCDebug(amdesktopfileLog()) << "create a am desktopfile object: " << m_id;
     m_applicationInterface.reset(new Application(AM_DBUS_PATH, id2dbusPath(id), QDBusConnection::sessionBus(), this));
     m_isValid = !m_id.isEmpty() && (m_applicationInterface->iD() == m_id);
@@ -252,7 +262,14 @@ void DesktopFileAMParser::updateLocalName()
 
 void DesktopFileAMParser::updateDesktopIcon()
 {
-    m_icon = m_applicationInterface->icons().value(DESKTOP_ENTRY_ICON_KEY);
+    const auto icon = m_applicationInterface->icons().value(DESKTOP_ENTRY_ICON_KEY);
+    // an icon missing from the theme falls back to the default one, the lookups are shared with the
+    // other panels through the icon cache.
+    if (icon.isEmpty() || QDir::isAbsolutePath(icon)) {
+        m_icon = icon;
+    } else {
+        m_icon = DS_NAMESPACE::DIconCache::instance()->iconName(icon, DesktopfileAbstractParser::desktopIcon());
+    }
 }
 
 void DesktopFileAMParser::updateLocalGenericName()
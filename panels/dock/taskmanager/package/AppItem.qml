@@ -37,6 +37,15 @@ Item {
     property int statusIndicatorSize: useColumnLayout ? root.width * 0.72 : root.height * 0.72
     property int iconSize: Panel.rootObject.dockItemMaxSize * 9 / 14
 
+    // theme icons are rasterized once by the shared icon cache, instead of grabbing the item on each press.
+    function dragImageSource() {
+        if (root.iconName.startsWith("data:"))
+            return root.iconName
+        if (root.iconName.startsWith("/"))
+            return "file://" + root.iconName
+        return "image://dsicon/" + encodeURIComponent(root.iconName) + "?size=" + root.iconSize
+    }
+
     property var iconGlobalPoint: {
         var a = icon
         var x = 0, y = 0
@@ -303,9 +312,7 @@ Item {
 
         onPressed: function (mouse) {
             if (mouse.button === Qt.LeftButton) {
-                icon.grabToImage(function(result) {
-                    root.Drag.imageSource = result.url;
-                })
+                root.Drag.imageSource = root.dragImageSource()
             }
             toolTip.close()
             closeItemPreview()
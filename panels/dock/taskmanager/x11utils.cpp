@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "x11utils.h"
+#include "iconcache.h"
 
 #include <cstddef>
 #include <unistd.h>
@@ -15,7 +16,6 @@
 
 #include <QList>
 #include <QImage>
-#include <QBuffer>
 #include <QGuiApplication>
 #include <QLoggingCategory>
 
@@ -193,14 +193,9 @@ QString X11Utils::getWindowIcon(const xcb_window_t &window)
 
         if (!wmIconIt.data) break;
 
-        QImage img = QImage((uchar *)wmIconIt.data, wmIconIt.width, wmIconIt.height, QImage::Format_ARGB32).copy();
-
-        QBuffer buffer;
-        buffer.open(QIODevice::WriteOnly);
-        img.save(&buffer, "PNG");
-        QString encode = buffer.data().toBase64();
-        iconContent = QString("%1,%2").arg("data:image/png;base64").arg(encode);
-        buffer.close();
+        // the pixels are wrapped without copying, windows of the same application share the encoded icon.
+        const QImage img((uchar *)wmIconIt.data, wmIconIt.width, wmIconIt.height, QImage::Format_ARGB32);
+        iconContent = DS_NAMESPACE::DIconCache::instance()->imageDataUrl(img);
 
     } while(0);
 
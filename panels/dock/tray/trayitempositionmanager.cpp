@@ -25,6 +25,7 @@ void TrayItemPositionManager::registerVisualItemSize(int index, const QSize &siz
 
     // The registered itemsize may change, and the layout needs to be updated when it does.
     if (oldSize != size) {
+        m_validPrefixCount = qMin(m_validPrefixCount, index);
         emit visualItemSizeChanged();
     }
 }
@@ -37,55 +38,66 @@ QSize TrayItemPositionManager::visualItemSize(int index) const
 
 QSize TrayItemPositionManager::visualSize(int index, bool includeLastSpacing) const
 {
+    const int extent = itemsExtent(index + 1);
+    const int length = (!includeLastSpacing && index > 0) ? (extent - itemSpacing) : extent;
     if (m_orientation == Qt::Horizontal) {
-        int width = 0;
-        for (int i = 0; i <= index; i++) {
-            width += (visualItemSize(i).width() + itemSpacing);
-        }
-        return QSize((!includeLastSpacing && index > 0) ? (width - itemSpacing) : width, m_dockHeight);
+        return QSize(length, m_dockHeight);
     } else {
-        int height = 0;
-        for (int i = 0; i <= index; i++) {
-            height += (visualItemSize(i).height() + itemSpacing);
-        }
-        return QSize(m_dockHeight, (!includeLastSpacing && index > 0) ? (height - itemSpacing) : height);
+        return QSize(m_dockHeight, length);
     }
 }
 
 DropIndex TrayItemPositionManager::itemIndexByPoint(const QPoint point) const
 {
-    if (m_orientation == Qt::Horizontal) {
-        int pos = point.x();
-        int width = 0;
-        for (int i = 0; i < m_visualItemCount; i++) {
-            int visualWidth = visualItemSize(i).width();
-            if (pos < (width + visualWidth + itemSpacing)) {
-                pos -= width;
-                return DropIndex {
-                    .index = i,
-                    .isOnItem = pos <= visualWidth,
-                    .isBefore = pos < (visualWidth / 2)
-                };
-            }
-            width += (visualWidth + itemSpacing);
+    const int pos = m_orientation == Qt::Horizontal ? point.x() : point.y();
+
+    // the first item whose end (including its spacing) is after the point.
+    int low = 0;
+    int high = m_visualItemCount;
+    while (low < high) {
+        const int mid = low + (high - low) / 2;
+        if (pos < itemsExtent(mid + 1)) {
+            high = mid;
+        } else {
+            low = mid + 1;
         }
+    }
+    if (low >= m_visualItemCount) {
         return DropIndex { .index = m_visualItemCount - 1 };
-    } else {
-        int pos = point.y();
-        int height = 0;
-        for (int i = 0; i <= m_visualItemCount; i++) {
-            int visualHeight = visualItemSize(i).height();
-            if (pos < (height + visualHeight + itemSpacing)) {
-                pos -= height;
-                return DropIndex {
-                    .index = i,
-                    .isOnItem = pos <= visualHeight,
-                    .isBefore = pos < (visualHeight / 2)
-                };
-            }
-            height += (visualHeight + itemSpacing);
+    }
+
+    const QSize size = visualItemSize(low);
+    const int visualLength = m_orientation == Qt::Horizontal ? size.width() : size.height();
+    const int offset = pos - itemsExtent(low);
+    return DropIndex {
+        .index = low,
+        .isOnItem = offset <= visualLength,
+        .isBefore = offset < (visualLength / 2)
+    };
+}
+
+int TrayItemPositionManager::itemsExtent(int count) const
+{
+    if (count <= 0) return 0;
+
+    const int registeredCount = m_registeredItemsSize.count();
+    if (m_validPrefixCount < registeredCount) {
+        m_itemsSizePrefix.resize(registeredCount);
+        const QSize spacing(itemSpacing, itemSpacing);
+        for (int i = m_validPrefixCount; i < registeredCount; i++) {
+            const QSize previous = i > 0 ? m_itemsSizePrefix.at(i - 1) : QSize(0, 0);
+            m_itemsSizePrefix[i] = previous + m_registeredItemsSize.at(i) + spacing;
         }
-        return DropIndex { .index = m_visualItemCount - 1 };
+        m_validPrefixCount = registeredCount;
+    }
+
+    // the items which aren't registered yet take the default size.
+    const int prefixCount = qMin(count, registeredCount);
+    const QSize prefix = prefixCount > 0 ? m_itemsSizePrefix.at(prefixCount - 1) : QSize(0, 0);
+    if (m_orientation == Qt::Horizontal) {
+        return prefix.width() + (count - prefixCount) * (itemVisualSize.width() + itemSpacing);
+    } else {
+        return prefix.height() + (count - prefixCount) * (itemVisualSize.height() + itemSpacing);
     }
 }
 
@@ -70,12 +70,18 @@ private:
     explicit TrayItemPositionManager(QObject *parent = nullptr);
 
     void updateVisualSize();
+    // the extent of the first `count` items along the orientation, including their spacing.
+    int itemsExtent(int count) const;
 
-    Qt::Orientation m_orientation;
+    Qt::Orientation m_orientation = Qt::Horizontal;
     QSize m_visualSize;
-    int m_dockHeight;
-    int m_visualItemCount;
+    int m_dockHeight = 0;
+    int m_visualItemCount = 0;
     QList<QSize> m_registeredItemsSize;
+    // prefix sums of (item size + spacing) of the registered items, the ones from
+    // m_validPrefixCount are out of date and rebuilt on demand.
+    mutable QList<QSize> m_itemsSizePrefix;
+    mutable int m_validPrefixCount = 0;
     QSize m_itemVisualSize;
     int m_itemSpacing;
     int m_itemPadding;
@@ -5,7 +5,9 @@
 #include "traysortordermodel.h"
 #include "constants.h"
 
+#include <QCoreApplication>
 #include <QDebug>
+#include <QSet>
 #include <DConfig>
 
 namespace docktray {
@@ -19,7 +21,13 @@ const QString SECTION_PINNED = QLatin1String("pinned");
 TraySortOrderModel::TraySortOrderModel(QObject *parent)
     : QStandardItemModel(parent)
     , m_dconfig(Dtk::Core::DConfig::create("org.deepin.dde.shell", "org.deepin.ds.dock.tray"))
+    , m_saveTimer(new QTimer(this))
 {
+    m_saveTimer->setSingleShot(true);
+    m_saveTimer->setInterval(500);
+    connect(m_saveTimer, &QTimer::timeout, this, &TraySortOrderModel::flushDataToDConfig);
+    connect(qApp, &QCoreApplication::aboutToQuit, this, &TraySortOrderModel::flushDataToDConfig);
+
     QHash<int, QByteArray> defaultRoleNames = roleNames();
     defaultRoleNames.insert({
         {TraySortOrderModel::SurfaceIdRole, QByteArrayLiteral("surfaceId")},
@@ -42,7 +50,13 @@ TraySortOrderModel::TraySortOrderModel(QObject *parent)
 
     connect(m_dconfig.get(), &Dtk::Core::DConfig::valueChanged, this, [this](const QString &key){
         if (key == QLatin1String("hiddenSurfaceIds")) {
-            loadDataFromDConfig();
+            if (m_saveTimer->isActive()) {
+                // the pending sort order isn't written yet, only the hidden list is taken.
+                m_hiddenIds = m_dconfig->value(key).toStringList();
+                m_savedValues.insert(key, m_hiddenIds);
+            } else {
+                loadDataFromDConfig();
+            }
             updateVisualIndexes();
         }
     });
@@ -63,16 +77,14 @@ TraySortOrderModel::TraySortOrderModel(QObject *parent)
 
 TraySortOrderModel::~TraySortOrderModel()
 {
-    // dtor
+    flushDataToDConfig();
 }
 
 bool TraySortOrderModel::dropToStashTray(const QString &draggedSurfaceId, int dropVisualIndex, bool isBefore)
 {
     // Check if the dragged tray surfaceId exists. Reject if not the case
-    QList<QStandardItem *> draggedItems = findItems(draggedSurfaceId);
-    if (draggedItems.isEmpty()) return false;
-    Q_ASSERT(draggedItems.count() == 1);
-    QStandardItem * draggedItem = draggedItems[0];
+    QStandardItem * draggedItem = m_items.value(draggedSurfaceId);
+    if (!draggedItem) return false;
     if (draggedItem->data(ForbiddenSectionsRole).toStringList().contains(SECTION_STASHED)) return false;
     QStringList * sourceSection = getSection(draggedItem->data(SectionTypeRole).toString());
 
@@ -94,11 +106,10 @@ bool TraySortOrderModel::dropToStashTray(const QString &draggedSurfaceId, int dr
 bool TraySortOrderModel::dropToDockTray(const QString &draggedSurfaceId, int dropVisualIndex, bool isBefore)
 {
     // Check if the dragged tray surfaceId exists. Reject if not the case
-    QList<QStandardItem *> draggedItems = findItems(draggedSurfaceId);
-    if (draggedItems.isEmpty()) return false;
-    Q_ASSERT(draggedItems.count() == 1);
-    QStringList * sourceSection = getSection(draggedItems[0]->data(SectionTypeRole).toString());
-    QStringList forbiddenSections(draggedItems[0]->data(ForbiddenSectionsRole).toStringList());
+    QStandardItem * draggedItem = m_items.value(draggedSurfaceId);
+    if (!draggedItem) return false;
+    QStringList * sourceSection = getSection(draggedItem->data(SectionTypeRole).toString());
+    QStringList forbiddenSections(draggedItem->data(ForbiddenSectionsRole).toStringList());
 
     // Find the item attempted to drop on
     QStandardItem * dropOnItem = findItemByVisualIndex(dropVisualIndex, DockTraySection);
@@ -322,102 +333,114 @@ QStandardItem *TraySortOrderModel::createTrayItem(const QString &name,
     item->setData(forbiddenSections, TraySortOrderModel::ForbiddenSectionsRole);
     item->setData(-1, TraySortOrderModel::VisualIndexRole);
     item->setData(pluginFlags, TraySortOrderModel::PluginFlagsRole);
+    m_items.insert(name, item);
 
     return item;
 }
 
-void TraySortOrderModel::updateVisualIndexes()
+// Computes the section, visual index and visibility of every item from the sort order lists,
+// the model isn't changed, items that aren't in any list keep their section and visibility.
+QHash<QStandardItem *, TraySortOrderModel::TrayItemState> TraySortOrderModel::computeVisualStates(int &visualItemCount) const
 {
-    for (int i = 0; i < rowCount(); i++) {
-        item(i)->setData(-1, TraySortOrderModel::VisualIndexRole);
+    QHash<QStandardItem *, TrayItemState> states;
+    states.reserve(m_items.size());
+    for (QStandardItem * item : std::as_const(m_items)) {
+        states.insert(item, {item->data(TraySortOrderModel::SectionTypeRole).toString(),
+                             -1,
+                             item->data(TraySortOrderModel::VisibilityRole).toBool()});
     }
 
+    const QSet<QString> hiddenIds(m_hiddenIds.cbegin(), m_hiddenIds.cend());
+    auto isItemVisible = [&hiddenIds](const QString & id, int flags) {
+        return (flags & Dock::Attribute_ForceDock) || !(flags & Dock::Attribute_CanSetting) || !hiddenIds.contains(id);
+    };
+    auto actionState = [this, &states](const QString & id) -> TrayItemState & {
+        QStandardItem * item = m_items.value(id);
+        Q_ASSERT(item);
+        return states[item];
+    };
+
     // stashed action
     // "internal/action-stash-placeholder"
-    QList<QStandardItem *> results = findItems("internal/action-stash-placeholder");
-    Q_ASSERT(!results.isEmpty());
-    QStandardItem * stashPlaceholder = results[0];
+    QStandardItem * stashPlaceholder = m_items.value("internal/action-stash-placeholder");
+    Q_ASSERT(stashPlaceholder);
 
     // the visual index of stashed items are also for their sort order, but the index
     // number is independently from these non-stashed items.
     int stashedVisualIndex = 0;
     bool showStashActionVisible = m_actionsAlwaysVisible;
     for (const QString & id : std::as_const(m_stashedIds)) {
-        QList<QStandardItem *> results = findItems(id);
-        if (results.isEmpty()) continue;
-        if (results[0]->data(TraySortOrderModel::VisualIndexRole).toInt() != -1) continue;
-        if (stashPlaceholder == results[0]) continue;
+        QStandardItem * item = m_items.value(id);
+        if (!item || item == stashPlaceholder) continue;
+        TrayItemState & state = states[item];
+        if (state.visualIndex != -1) continue;
         // forcedock and can not setting plugin need always set to visible
-        auto pluginFlags = results[0]->data(TraySortOrderModel::PluginFlagsRole).toInt();
-        bool itemVisible = (pluginFlags & Dock::Attribute_ForceDock) || !(pluginFlags & Dock::Attribute_ForceDock) || !m_hiddenIds.contains(id);
-        results[0]->setData(SECTION_STASHED, TraySortOrderModel::SectionTypeRole);
+        auto pluginFlags = item->data(TraySortOrderModel::PluginFlagsRole).toInt();
+        bool itemVisible = (pluginFlags & Dock::Attribute_ForceDock) || !(pluginFlags & Dock::Attribute_ForceDock) || !hiddenIds.contains(id);
+        state.section = SECTION_STASHED;
         if (itemVisible) {
             showStashActionVisible = true;
-            results[0]->setData(stashedVisualIndex, TraySortOrderModel::VisualIndexRole);
+            state.visualIndex = stashedVisualIndex;
             stashedVisualIndex++;
         }
     }
 
-    stashPlaceholder->setData(stashedVisualIndex == 0 && showStashActionVisible, TraySortOrderModel::VisibilityRole);
+    states[stashPlaceholder].visible = stashedVisualIndex == 0 && showStashActionVisible;
 
     int currentVisualIndex = 0;
     // "internal/action-show-stash"
-    results = findItems("internal/action-show-stash");
-    Q_ASSERT(!results.isEmpty());
-    results[0]->setData(showStashActionVisible, TraySortOrderModel::VisibilityRole);
+    TrayItemState & showStashState = actionState("internal/action-show-stash");
+    showStashState.visible = showStashActionVisible;
     if (showStashActionVisible) {
-        results[0]->setData(currentVisualIndex, TraySortOrderModel::VisualIndexRole);
+        showStashState.visualIndex = currentVisualIndex;
         currentVisualIndex++;
     }
 
     // collapsable
     bool toogleCollapseActionVisible = m_actionsAlwaysVisible;
     for (const QString & id : std::as_const(m_collapsableIds)) {
-        QList<QStandardItem *> results = findItems(id);
-        if (results.isEmpty()) continue;
-        if (results[0]->data(TraySortOrderModel::VisualIndexRole).toInt() != -1) continue;
-        auto pluginFlags = results[0]->data(TraySortOrderModel::PluginFlagsRole).toInt();
-        bool itemVisible = (pluginFlags & Dock::Attribute_ForceDock) || !(pluginFlags & Dock::Attribute_CanSetting) || !m_hiddenIds.contains(id);
-        results[0]->setData(SECTION_COLLAPSABLE, TraySortOrderModel::SectionTypeRole);
-        results[0]->setData(itemVisible, TraySortOrderModel::VisibilityRole);
+        QStandardItem * item = m_items.value(id);
+        if (!item) continue;
+        TrayItemState & state = states[item];
+        if (state.visualIndex != -1) continue;
+        bool itemVisible = isItemVisible(id, item->data(TraySortOrderModel::PluginFlagsRole).toInt());
+        state.section = SECTION_COLLAPSABLE;
+        state.visible = itemVisible;
         if (itemVisible) {
             toogleCollapseActionVisible = true;
             if (!m_collapsed) {
-                results[0]->setData(currentVisualIndex++, TraySortOrderModel::VisualIndexRole);
+                state.visualIndex = currentVisualIndex++;
             } else {
-                results[0]->setData(currentVisualIndex-1, TraySortOrderModel::VisualIndexRole);
+                state.visualIndex = currentVisualIndex - 1;
             }
         }
     }
 
     // "internal/action-toggle-collapse"
-    results = findItems("internal/action-toggle-collapse");
-    Q_ASSERT(!results.isEmpty());
-    results[0]->setData(toogleCollapseActionVisible, TraySortOrderModel::VisibilityRole);
+    TrayItemState & toggleCollapseState = actionState("internal/action-toggle-collapse");
+    toggleCollapseState.visible = toogleCollapseActionVisible;
     if (toogleCollapseActionVisible) {
-        results[0]->setData(currentVisualIndex, TraySortOrderModel::VisualIndexRole);
+        toggleCollapseState.visualIndex = currentVisualIndex;
         currentVisualIndex++;
     }
 
     // pinned
     for (const QString & id : std::as_const(m_pinnedIds)) {
-        QList<QStandardItem *> results = findItems(id);
-        if (results.isEmpty()) continue;
-        if (results[0]->data(TraySortOrderModel::VisualIndexRole).toInt() != -1) continue;
-        auto flags = results[0]->data(TraySortOrderModel::PluginFlagsRole).toInt();
-        bool itemVisible = (flags & Dock::Attribute_ForceDock) || !(flags & Dock::Attribute_CanSetting) || !m_hiddenIds.contains(id);
-        results[0]->setData(SECTION_PINNED, TraySortOrderModel::SectionTypeRole);
-        results[0]->setData(itemVisible, TraySortOrderModel::VisibilityRole);
+        QStandardItem * item = m_items.value(id);
+        if (!item) continue;
+        TrayItemState & state = states[item];
+        if (state.visualIndex != -1) continue;
+        bool itemVisible = isItemVisible(id, item->data(TraySortOrderModel::PluginFlagsRole).toInt());
+        state.section = SECTION_PINNED;
+        state.visible = itemVisible;
         if (itemVisible) {
-            results[0]->setData(currentVisualIndex, TraySortOrderModel::VisualIndexRole);
+            state.visualIndex = currentVisualIndex;
             currentVisualIndex++;
         }
     }
 
     // "internal/action-toggle-quick-settings"
-    results = findItems("internal/action-toggle-quick-settings");
-    Q_ASSERT(!results.isEmpty());
-    results[0]->setData(currentVisualIndex, TraySortOrderModel::VisualIndexRole);
+    actionState("internal/action-toggle-quick-settings").visualIndex = currentVisualIndex;
     currentVisualIndex++;
 
     // fixed (not actually 'fixed' since it's just a section next to pinned)
@@ -425,23 +448,50 @@ void TraySortOrderModel::updateVisualIndexes()
     // move to other sections. We archive that by setting the 'forbiddenSections' property
     // to the items in fixed sections.
     for (const QString & id : std::as_const(m_fixedIds)) {
-        QList<QStandardItem *> results = findItems(id);
-        if (results.isEmpty()) continue;
-        if (results[0]->data(TraySortOrderModel::VisualIndexRole).toInt() != -1) continue;
-        auto flags = results[0]->data(TraySortOrderModel::PluginFlagsRole).toInt();
-        bool itemVisible = (flags & Dock::Attribute_ForceDock) || !(flags & Dock::Attribute_CanSetting) || !m_hiddenIds.contains(id);
-        results[0]->setData(SECTION_FIXED, TraySortOrderModel::SectionTypeRole);
-        results[0]->setData(itemVisible, TraySortOrderModel::VisibilityRole);
+        QStandardItem * item = m_items.value(id);
+        if (!item) continue;
+        TrayItemState & state = states[item];
+        if (state.visualIndex != -1) continue;
+        bool itemVisible = isItemVisible(id, item->data(TraySortOrderModel::PluginFlagsRole).toInt());
+        state.section = SECTION_FIXED;
+        state.visible = itemVisible;
         if (itemVisible) {
-            results[0]->setData(currentVisualIndex, TraySortOrderModel::VisualIndexRole);
+            state.visualIndex = currentVisualIndex;
             currentVisualIndex++;
         }
     }
 
+    visualItemCount = currentVisualIndex;
+    return states;
+}
+
+void TraySortOrderModel::updateVisualIndexes()
+{
+    int visualItemCount = 0;
+    const auto states = computeVisualStates(visualItemCount);
+
+    // only the changed roles are set, every setData() emits a dataChanged to the views.
+    for (int i = 0; i < rowCount(); i++) {
+        QStandardItem * rowItem = item(i);
+        const auto iter = states.constFind(rowItem);
+        if (iter == states.cend()) continue;
+
+        const TrayItemState & state = iter.value();
+        if (rowItem->data(TraySortOrderModel::SectionTypeRole).toString() != state.section) {
+            rowItem->setData(state.section, TraySortOrderModel::SectionTypeRole);
+        }
+        if (rowItem->data(TraySortOrderModel::VisibilityRole).toBool() != state.visible) {
+            rowItem->setData(state.visible, TraySortOrderModel::VisibilityRole);
+        }
+        if (rowItem->data(TraySortOrderModel::VisualIndexRole).toInt() != state.visualIndex) {
+            rowItem->setData(state.visualIndex, TraySortOrderModel::VisualIndexRole);
+        }
+    }
+
     // update visible item count property
-    setProperty("visualItemCount", currentVisualIndex);
+    setProperty("visualItemCount", visualItemCount);
 
-    qDebug() << "update" << m_visualItemCount << currentVisualIndex;
+    qDebug() << "update" << m_visualItemCount << visualItemCount;
 }
 
 QString TraySortOrderModel::registerSurfaceId(const QVariantMap & surfaceData)
@@ -452,9 +502,8 @@ QString TraySortOrderModel::registerSurfaceId(const QVariantMap & surfaceData)
     QStringList forbiddenSections(surfaceData.value("forbiddenSections").toStringList());
     int pluginFlas(surfaceData.value("pluginFlags").toInt());
 
-    QList<QStandardItem *> results = findItems(surfaceId);
-    if (!results.isEmpty()) {
-        QStandardItem * result = results[0];
+    QStandardItem * result = m_items.value(surfaceId);
+    if (result) {
         // check if the item is currently in a forbidden zone
         QString currentSection(result->data(SectionTypeRole).toString());
         if (forbiddenSections.contains(currentSection)) {
@@ -474,20 +523,50 @@ void TraySortOrderModel::loadDataFromDConfig()
     m_pinnedIds = m_dconfig->value("pinnedSurfaceIds").toStringList();
     m_hiddenIds = m_dconfig->value("hiddenSurfaceIds").toStringList();
     m_collapsed = m_dconfig->value("isCollapsed").toBool();
+
+    m_savedValues = {
+        {"stashedSurfaceIds", m_stashedIds},
+        {"collapsableSurfaceIds", m_collapsableIds},
+        {"pinnedSurfaceIds", m_pinnedIds},
+        {"hiddenSurfaceIds", m_hiddenIds},
+        {"isCollapsed", m_collapsed}
+    };
 }
 
 void TraySortOrderModel::saveDataToDConfig()
 {
-    m_dconfig->setValue("stashedSurfaceIds", m_stashedIds);
-    m_dconfig->setValue("collapsableSurfaceIds", m_collapsableIds);
-    m_dconfig->setValue("pinnedSurfaceIds", m_pinnedIds);
-    m_dconfig->setValue("hiddenSurfaceIds", m_hiddenIds);
-    m_dconfig->setValue("isCollapsed", m_collapsed);
+    // every setValue() is a D-Bus call to the config daemon, a drag session changes the sort order
+    // many times, so they're written once after the changes settle down.
+    m_saveTimer->start();
+}
+
+void TraySortOrderModel::flushDataToDConfig()
+{
+    m_saveTimer->stop();
+
+    const QVariantMap values {
+        {"stashedSurfaceIds", m_stashedIds},
+        {"collapsableSurfaceIds", m_collapsableIds},
+        {"pinnedSurfaceIds", m_pinnedIds},
+        {"hiddenSurfaceIds", m_hiddenIds},
+        {"isCollapsed", m_collapsed}
+    };
+    // hiddenSurfaceIds is watched for reloading, it's written after the sort order.
+    static const QStringList keys {
+        "stashedSurfaceIds", "collapsableSurfaceIds", "pinnedSurfaceIds", "hiddenSurfaceIds", "isCollapsed"
+    };
+    for (const auto &key : keys) {
+        const auto value = values.value(key);
+        if (m_savedValues.value(key) == value)
+            continue;
+        m_savedValues.insert(key, value);
+        m_dconfig->setValue(key, value);
+    }
 }
 
 void TraySortOrderModel::onAvailableSurfacesChanged()
 {
-    QStringList availableSurfaceIds;
+    QSet<QString> availableSurfaceIds;
     // check if there is any new tray item needs to be registered, and register it.
     for (const QVariantMap & surface : m_availableSurfaces) {
         // already registered items will be checked so this is fine
@@ -500,6 +579,7 @@ void TraySortOrderModel::onAvailableSurfacesChanged()
         const QString surfaceId(data(index(i, 0), TraySortOrderModel::SurfaceIdRole).toString());
         if (availableSurfaceIds.contains(surfaceId)) continue;
         if (surfaceId.startsWith("internal/")) continue;
+        m_items.remove(surfaceId);
         removeRow(i);
     }
     // finally, update visual index
@@ -7,6 +7,7 @@
 #include "constants.h"
 #include <QQmlEngine>
 #include <QStandardItemModel>
+#include <QTimer>
 
 namespace Dtk {
 namespace Core {
@@ -71,6 +72,13 @@ signals:
     void availableSurfacesChanged(const QList<QVariantMap> &);
 
 private:
+    // the computed layout of an item, it's applied by updateVisualIndexes().
+    struct TrayItemState {
+        QString section;
+        int visualIndex = -1;
+        bool visible = true;
+    };
+
     int m_visualItemCount = 0;
     bool m_collapsed = false;
     bool m_isCollapsing = false;
@@ -85,6 +93,12 @@ private:
     QStringList m_fixedIds;
     // surface IDs that should be invisible/hidden from the tray area.
     QStringList m_hiddenIds;
+    // surfaceId -> item of the model, it's kept by createTrayItem() and onAvailableSurfacesChanged().
+    QHash<QString, QStandardItem *> m_items;
+    // the sort order is written behind, changes in the interval are written once.
+    QTimer *m_saveTimer = nullptr;
+    // the values which are known to be in the config, unchanged values aren't written again.
+    QVariantMap m_savedValues;
 
     QStandardItem * findItemByVisualIndex(int visualIndex, VisualSections visualSection) const;
     QStringList * getSection(const QString & sectionType);
@@ -95,10 +109,12 @@ private:
                                   const QString &delegateType,
                                   const QStringList &forbiddenSections = {},
                                   int pluginFlags = Dock::Attribute_Normal);
+    QHash<QStandardItem *, TrayItemState> computeVisualStates(int &visualItemCount) const;
     void updateVisualIndexes();
     QString registerSurfaceId(const QVariantMap &surfaceData);
     void loadDataFromDConfig();
     void saveDataToDConfig();
+    void flushDataToDConfig();
 
 private slots:
     void onAvailableSurfacesChanged();
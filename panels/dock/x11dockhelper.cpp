@@ -8,6 +8,7 @@
 #include "dockpanel.h"
 
 #include <algorithm>
+#include <utility>
 #include <xcb/res.h>
 #include <xcb/xcb.h>
 #include <xcb/xproto.h>
@@ -21,6 +22,7 @@ Q_LOGGING_CATEGORY(dockX11Log, "dde.shell.dock.x11")
 
 const uint16_t monitorSize = 15;
 const uint32_t allWorkspace = 0xffffffff;
+const int windowBucketSize = 64;
 
 // TODO: use taskmanager window data
 struct WindowData
@@ -105,7 +107,15 @@ bool XcbEventFilter::nativeEventFilter(const QByteArray &eventType, void *messag
     }
     case XCB_CONFIGURE_NOTIFY: {
         auto cE = reinterpret_cast<xcb_configure_notify_event_t *>(xcb_event);
-        Q_EMIT windowGeometryChanged(cE->window);
+        // frames and other windows under the root window report it too, only the tracked clients are resolved.
+        if (m_helper->m_windows.contains(cE->window))
+            requestWindowGeometry(cE->window);
+        break;
+    }
+    case XCB_REPARENT_NOTIFY: {
+        // the window is decorated or undecorated, its frame window is looked up again.
+        auto rE = reinterpret_cast<xcb_reparent_notify_event_t *>(xcb_event);
+        m_decorativeWindows.remove(rE->window);
         break;
     }
     }
@@ -196,50 +206,129 @@ QList<xcb_atom_t> XcbEventFilter::getWindowTypes(const xcb_window_t &window)
     return ret;
 }
 
-QRect XcbEventFilter::getWindowGeometry(const xcb_window_t &window)
+void XcbEventFilter::requestWindowGeometry(const xcb_window_t &window)
 {
-    QRect geometry;
-    xcb_get_geometry_cookie_t cookie = xcb_get_geometry(m_connection, window);
-    xcb_get_geometry_reply_t *geom = xcb_get_geometry_reply(m_connection, cookie, nullptr);
-    if (geom) {
-        int x = geom->x, y = geom->y;
-        xcb_translate_coordinates_reply_t *trans = xcb_translate_coordinates_reply(m_connection, xcb_translate_coordinates(m_connection, window, m_rootWindow, 0, 0), nullptr);
-        if (trans) {
-            x = trans->dst_x;
-            y = trans->dst_y;
-            free(trans);
-        }
-        geometry.setRect(x, y, geom->width, geom->height);
+    // a moving window sends a ConfigureNotify for each motion, they're coalesced in one event loop iteration.
+    m_dirtyGeometries.insert(window);
+    if (!m_geometryScheduled) {
+        m_geometryScheduled = true;
+        QMetaObject::invokeMethod(this, &XcbEventFilter::sendGeometryRequests, Qt::QueuedConnection);
+    }
+}
+
+void XcbEventFilter::releaseWindow(const xcb_window_t &window)
+{
+    m_dirtyGeometries.remove(window);
+    m_decorativeWindows.remove(window);
+}
 
-        xcb_window_t dwin = getDecorativeWindow(window);
+xcb_window_t XcbEventFilter::decorativeWindow(const xcb_window_t &window)
+{
+    auto it = m_decorativeWindows.constFind(window);
+    if (it != m_decorativeWindows.cend())
+        return it.value();
+
+    const xcb_window_t dwin = getDecorativeWindow(window);
+    if (dwin != 0)
+        m_decorativeWindows.insert(window, dwin);
+    return dwin;
+}
+
+void XcbEventFilter::sendGeometryRequests()
+{
+    m_geometryScheduled = false;
+
+    // requests of all the windows are sent without waiting for any reply, they're read in the
+    // next event loop iteration, so the replies have usually arrived and reading doesn't block.
+    for (auto window : std::as_const(m_dirtyGeometries)) {
+        const xcb_window_t dwin = decorativeWindow(window);
         if (dwin == 0) {
-            return QRect();
+            Q_EMIT windowGeometryChanged(window, QRect());
+            continue;
         }
-        xcb_get_geometry_reply_t *dgeom = xcb_get_geometry_reply(m_connection, xcb_get_geometry(m_connection, dwin), nullptr);
-        if (dgeom) {
-            if (geometry.x() == dgeom->x && geometry.y() == dgeom->y) {
-                // 无标题栏窗口,比如 deepin-editor, dconf-editor
-                xcb_get_property_reply_t *pro = xcb_get_property_reply(m_connection, xcb_get_property(m_connection, false, window, getAtomByName("_NET_FRAME_EXTENTS"), 6, 0, 4), nullptr);
-                if (pro) {
-                    if (pro->format == 0) {
-                        free(pro);
-                        pro = xcb_get_property_reply(m_connection, xcb_get_property(m_connection, false, window, getAtomByName("_GTK_FRAME_EXTENTS"), 6, 0, 4), nullptr);
-                    }
-                    if (pro && pro->format == 32) {
-                        uint32_t values[4];
-                        memcpy(values, xcb_get_property_value(pro), sizeof(values));
-                        geometry.setRect(geometry.x() + values[0], geometry.y() + values[2], geometry.width() - values[0] - values[1], geometry.height() - values[2] - values[3]);
-                    }
-                    free(pro);
+        m_geometryRequests.append({
+            window,
+            xcb_get_geometry(m_connection, window),
+            xcb_translate_coordinates(m_connection, window, m_rootWindow, 0, 0),
+            xcb_get_geometry(m_connection, dwin)
+        });
+    }
+    m_dirtyGeometries.clear();
+
+    if (m_geometryRequests.isEmpty())
+        return;
+    xcb_flush(m_connection);
+    QMetaObject::invokeMethod(this, &XcbEventFilter::collectGeometryReplies, Qt::QueuedConnection);
+}
+
+void XcbEventFilter::collectGeometryReplies()
+{
+    struct FrameExtentsRequest {
+        xcb_window_t window;
+        QRect geometry;
+        xcb_get_property_cookie_t netExtents;
+        xcb_get_property_cookie_t gtkExtents;
+    };
+
+    const auto requests = std::exchange(m_geometryRequests, {});
+    QList<QPair<xcb_window_t, QRect>> results;
+    QList<FrameExtentsRequest> extentsRequests;
+    for (const auto &request : requests) {
+        QRect geometry;
+        bool undecorated = false;
+        xcb_get_geometry_reply_t *geom = xcb_get_geometry_reply(m_connection, request.geometry, nullptr);
+        xcb_translate_coordinates_reply_t *trans = xcb_translate_coordinates_reply(m_connection, request.translate, nullptr);
+        xcb_get_geometry_reply_t *dgeom = xcb_get_geometry_reply(m_connection, request.decorativeGeometry, nullptr);
+        if (geom) {
+            int x = geom->x, y = geom->y;
+            if (trans) {
+                x = trans->dst_x;
+                y = trans->dst_y;
+            }
+            geometry.setRect(x, y, geom->width, geom->height);
+
+            if (dgeom) {
+                if (geometry.x() == dgeom->x && geometry.y() == dgeom->y) {
+                    // 无标题栏窗口,比如 deepin-editor, dconf-editor
+                    // both of the extents are requested, _GTK_FRAME_EXTENTS is used if there isn't _NET_FRAME_EXTENTS.
+                    undecorated = true;
+                    extentsRequests.append({
+                        request.window,
+                        geometry,
+                        xcb_get_property(m_connection, false, request.window, getAtomByName("_NET_FRAME_EXTENTS"), 6, 0, 4),
+                        xcb_get_property(m_connection, false, request.window, getAtomByName("_GTK_FRAME_EXTENTS"), 6, 0, 4)
+                    });
+                } else {
+                    geometry.setRect(dgeom->x, dgeom->y, dgeom->width, dgeom->height);
                 }
-            } else {
-                geometry.setRect(dgeom->x, dgeom->y, dgeom->width, dgeom->height);
             }
-            free(dgeom);
         }
         free(geom);
+        free(trans);
+        free(dgeom);
+
+        if (!undecorated)
+            results.append({request.window, geometry});
+    }
+
+    for (const auto &request : std::as_const(extentsRequests)) {
+        QRect geometry = request.geometry;
+        xcb_get_property_reply_t *netPro = xcb_get_property_reply(m_connection, request.netExtents, nullptr);
+        xcb_get_property_reply_t *gtkPro = xcb_get_property_reply(m_connection, request.gtkExtents, nullptr);
+        xcb_get_property_reply_t *pro = (netPro && netPro->format == 0) ? gtkPro : netPro;
+        if (pro && pro->format == 32) {
+            uint32_t values[4];
+            memcpy(values, xcb_get_property_value(pro), sizeof(values));
+            geometry.setRect(geometry.x() + values[0], geometry.y() + values[2], geometry.width() - values[0] - values[1], geometry.height() - values[2] - values[3]);
+        }
+        free(netPro);
+        free(gtkPro);
+        results.append({request.window, geometry});
+    }
+
+    for (const auto &result : std::as_const(results)) {
+        Q_EMIT windowGeometryChanged(result.first, result.second);
     }
-    return geometry;
 }
 
 xcb_window_t XcbEventFilter::getDecorativeWindow(const xcb_window_t &window)
@@ -357,10 +446,13 @@ void X11DockHelper::onHideModeChanged(HideMode mode)
 {
     // 会收到重复信号，因此每次都清理下数据
     disconnect(m_xcbHelper, nullptr, this, nullptr);
-    for (auto &&data : m_windows) {
-        delete data;
+    for (auto it = m_windows.cbegin(); it != m_windows.cend(); ++it) {
+        m_xcbHelper->releaseWindow(it.key());
+        delete it.value();
     }
     m_windows.clear();
+    m_windowBuckets.clear();
+    m_overlapCount = 0;
 
     switch (mode) {
     case SmartHide: {
@@ -396,28 +488,96 @@ void X11DockHelper::onHideModeChanged(HideMode mode)
 
 void X11DockHelper::onWindowClientListChanged()
 {
-    QList<xcb_window_t> windows = m_xcbHelper->getWindowClientList();
+    const QList<xcb_window_t> windows = m_xcbHelper->getWindowClientList();
+    const QSet<xcb_window_t> clients(windows.cbegin(), windows.cend());
     for (auto &&window : windows) {
         if (!m_windows.contains(window) && !m_xcbHelper->shouldSkip(window)) {
             m_windows.insert(window, new WindowData());
             onWindowAdded(window);
         }
     }
-    for (auto it = m_windows.cbegin(); it != m_windows.cend();) {
-        if (!windows.contains(it.key())) {
-            delete it.value();
-            it = m_windows.erase(it);
-        } else {
-            it++;
+
+    QList<xcb_window_t> removed;
+    for (auto it = m_windows.cbegin(); it != m_windows.cend(); ++it) {
+        if (!clients.contains(it.key()))
+            removed << it.key();
+    }
+    for (auto window : std::as_const(removed)) {
+        removeWindow(window);
+    }
+}
+
+void X11DockHelper::removeWindow(xcb_window_t window)
+{
+    WindowData *data = m_windows.take(window);
+    if (!data)
+        return;
+
+    m_xcbHelper->releaseWindow(window);
+    indexWindow(window, data->rect, QRect());
+    const bool overlap = data->overlap;
+    setWindowOverlap(data, false);
+    delete data;
+    if (overlap) {
+        Q_EMIT isWindowOverlapChanged(isWindowOverlap());
+    }
+}
+
+void X11DockHelper::setWindowOverlap(WindowData *data, bool overlap)
+{
+    if (data->overlap == overlap)
+        return;
+
+    data->overlap = overlap;
+    m_overlapCount += overlap ? 1 : -1;
+    Q_ASSERT(m_overlapCount >= 0);
+}
+
+QPair<int, int> X11DockHelper::bucketRange(const QRect &rect) const
+{
+    const int first = m_bucketByY ? rect.top() : rect.left();
+    const int last = m_bucketByY ? rect.bottom() : rect.right();
+    auto bucketOf = [](int value) {
+        // rounds towards negative infinity, windows can be placed at negative positions.
+        return value >= 0 ? value / windowBucketSize : (value - windowBucketSize + 1) / windowBucketSize;
+    };
+    return {bucketOf(first), bucketOf(last)};
+}
+
+void X11DockHelper::indexWindow(xcb_window_t window, const QRect &oldRect, const QRect &newRect)
+{
+    if (!oldRect.isEmpty()) {
+        const auto range = bucketRange(oldRect);
+        for (int i = range.first; i <= range.second; i++) {
+            auto it = m_windowBuckets.find(i);
+            if (it == m_windowBuckets.end())
+                continue;
+            it->remove(window);
+            if (it->isEmpty())
+                m_windowBuckets.erase(it);
+        }
+    }
+    if (!newRect.isEmpty()) {
+        const auto range = bucketRange(newRect);
+        for (int i = range.first; i <= range.second; i++) {
+            m_windowBuckets[i].insert(window);
         }
     }
 }
 
+void X11DockHelper::rebuildWindowIndex()
+{
+    m_windowBuckets.clear();
+    for (auto it = m_windows.cbegin(); it != m_windows.cend(); ++it) {
+        indexWindow(it.key(), QRect(), it.value()->rect);
+    }
+}
+
 void X11DockHelper::onWindowAdded(xcb_window_t window)
 {
     m_xcbHelper->monitorWindowChange(window);
     onWindowPropertyChanged(window, m_xcbHelper->getAtomByName("WM_STATE"));
-    onWindowGeometryChanged(window);
+    m_xcbHelper->requestWindowGeometry(window);
     onWindowWorkspaceChanged(window);
 }
 
@@ -433,10 +593,14 @@ void X11DockHelper::onWindowPropertyChanged(xcb_window_t window, xcb_atom_t atom
     }
 }
 
-void X11DockHelper::onWindowGeometryChanged(xcb_window_t window)
+void X11DockHelper::onWindowGeometryChanged(xcb_window_t window, const QRect &geometry)
 {
     if (m_windows.contains(window)) {
-        m_windows[window]->rect = m_xcbHelper->getWindowGeometry(window);
+        WindowData *data = m_windows.value(window);
+        const QRect oldRect = data->rect;
+        data->rect = geometry;
+        if (oldRect != data->rect)
+            indexWindow(window, oldRect, data->rect);
         updateWindowHideState(window);
     }
 }
@@ -456,7 +620,7 @@ void X11DockHelper::updateWindowHideState(xcb_window_t window)
     WindowData *data = m_windows.value(window);
     bool oldOverlap = data->overlap;
     if (!data->isMinimized) {
-        data->overlap = data->rect.intersects(m_dockArea);
+        setWindowOverlap(data, data->rect.intersects(m_dockArea));
     }
 
     if (oldOverlap != data->overlap) {
@@ -502,10 +666,28 @@ void X11DockHelper::updateDockArea()
         rect.moveTo(x, y);
     }
 
+    const auto position = parent()->position();
+    const bool bucketByY = position == Top || position == Bottom;
+    if (m_bucketByY != bucketByY) {
+        m_bucketByY = bucketByY;
+        rebuildWindowIndex();
+    }
+
     if (m_dockArea != rect) {
+        // only the windows touching the old or the new dock area may change their overlap state.
+        QSet<xcb_window_t> candidates;
+        for (const QRect &area : {m_dockArea, rect}) {
+            if (area.isEmpty())
+                continue;
+            const auto range = bucketRange(area);
+            for (int i = range.first; i <= range.second; i++) {
+                candidates.unite(m_windowBuckets.value(i));
+            }
+        }
+
         m_dockArea = rect;
-        for (auto it = m_windows.cbegin(); it != m_windows.cend(); ++it) {
-            updateWindowHideState(it.key());
+        for (auto window : std::as_const(candidates)) {
+            updateWindowHideState(window);
         }
     }
 }
@@ -518,11 +700,7 @@ bool X11DockHelper::currentActiveWindowFullscreened()
 bool X11DockHelper::isWindowOverlap()
 {
     // any widnow overlap
-    bool overlap = false;
-    std::for_each(m_windows.begin(), m_windows.end(), [&overlap](const auto &window) {
-        return overlap |= window->overlap;
-    });
-    return overlap;
+    return m_overlapCount > 0;
 }
 
 X11DockWakeUpArea::X11DockWakeUpArea(QScreen *screen, X11DockHelper *helper)
@@ -5,6 +5,8 @@
 
 #include "dockhelper.h"
 
+#include <QSet>
+
 #include <xcb/xcb.h>
 #include <xcb/xcb_ewmh.h>
 #include <xcb/xproto.h>
@@ -26,7 +28,9 @@ public:
     QList<xcb_window_t> getWindowClientList();
     QList<xcb_atom_t> getWindowState(const xcb_window_t& window);
     QList<xcb_atom_t> getWindowTypes(const xcb_window_t& window);
-    QRect getWindowGeometry(const xcb_window_t& window);
+    // the geometry is resolved asynchronously and reported by windowGeometryChanged.
+    void requestWindowGeometry(const xcb_window_t& window);
+    void releaseWindow(const xcb_window_t& window);
     xcb_window_t getDecorativeWindow(const xcb_window_t& window);
     uint32_t getWindowWorkspace(const xcb_window_t& window);
     uint32_t getCurrentWorkspace();
@@ -38,12 +42,22 @@ public:
 Q_SIGNALS:
     void windowClientListChanged();
     void windowPropertyChanged(xcb_window_t window, xcb_atom_t atom);
-    void windowGeometryChanged(xcb_window_t window);
+    void windowGeometryChanged(xcb_window_t window, const QRect &geometry);
     void currentWorkspaceChanged();
 
 private:
+    struct GeometryRequest {
+        xcb_window_t window;
+        xcb_get_geometry_cookie_t geometry;
+        xcb_translate_coordinates_cookie_t translate;
+        xcb_get_geometry_cookie_t decorativeGeometry;
+    };
+
     bool inTriggerArea(xcb_window_t win) const;
     void processEnterLeave(xcb_window_t win, bool enter);
+    xcb_window_t decorativeWindow(const xcb_window_t& window);
+    void sendGeometryRequests();
+    void collectGeometryReplies();
 
     QPointer<X11DockHelper> m_helper;
     QMap<QString, xcb_atom_t> m_atoms;
@@ -51,6 +65,12 @@ private:
     xcb_window_t m_rootWindow;
     xcb_ewmh_connection_t m_ewmh;
     uint32_t m_currentWorkspace;
+    // windows whose geometry is changed in this event loop iteration.
+    QSet<xcb_window_t> m_dirtyGeometries;
+    QList<GeometryRequest> m_geometryRequests;
+    bool m_geometryScheduled = false;
+    // frame windows of the clients, they're valid until the client is reparented.
+    QHash<xcb_window_t, xcb_window_t> m_decorativeWindows;
 };
 
 class X11DockHelper : public DockHelper
@@ -73,7 +93,7 @@ private Q_SLOTS:
     void onWindowClientListChanged();
     void onWindowAdded(xcb_window_t window);
     void onWindowPropertyChanged(xcb_window_t window, xcb_atom_t atom);
-    void onWindowGeometryChanged(xcb_window_t window);
+    void onWindowGeometryChanged(xcb_window_t window, const QRect &geometry);
     void onWindowWorkspaceChanged(xcb_window_t window);
 
     void updateWindowHideState(xcb_window_t window);
@@ -83,10 +103,22 @@ private Q_SLOTS:
 private:
     friend class XcbEventFilter;
 
+    void removeWindow(xcb_window_t window);
+    void setWindowOverlap(WindowData *data, bool overlap);
+    QPair<int, int> bucketRange(const QRect &rect) const;
+    void indexWindow(xcb_window_t window, const QRect &oldRect, const QRect &newRect);
+    void rebuildWindowIndex();
+
 private:
     QHash<xcb_window_t, X11DockWakeUpArea *> m_areas;
     QRect m_dockArea;
     QHash<xcb_window_t, WindowData*> m_windows;
+    // count of the windows overlapping with the dock.
+    int m_overlapCount = 0;
+    // windows bucketed by their extent across the dock edge, by y for top and bottom docks,
+    // by x for left and right docks, so a change of the dock area only checks the windows near it.
+    QHash<int, QSet<xcb_window_t>> m_windowBuckets;
+    bool m_bucketByY = true;
     XcbEventFilter *m_xcbHelper;
     QTimer *m_updateDockAreaTimer;
 };
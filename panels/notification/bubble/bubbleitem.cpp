@@ -3,155 +3,23 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "bubbleitem.h"
+#include "iconcache.h"
 
-#include <QUrl>
 #include <QTimer>
-#include <QImage>
-#include <QDBusArgument>
-#include <QTemporaryFile>
 #include <QLoggingCategory>
 
-#include <DIconTheme>
-
 namespace notification {
 Q_DECLARE_LOGGING_CATEGORY(notifyLog)
 }
 
 namespace notification {
 
-static inline void copyLineRGB32(QRgb *dst, const char *src, int width)
-{
-    const char *end = src + width * 3;
-    for (; src != end; ++dst, src += 3) {
-        *dst = qRgb(src[0], src[1], src[2]);
-    }
-}
-
-static inline void copyLineARGB32(QRgb *dst, const char *src, int width)
+// image hints and inline images are decoded when the notification is received, see NotifyImageCache.
+static QString iconOfNotification(const QString &appName)
 {
-    const char *end = src + width * 4;
-    for (; src != end; ++dst, src += 4) {
-        *dst = qRgba(src[0], src[1], src[2], src[3]);
-    }
-}
-
-static QImage decodeImageFromDBusArgument(const QDBusArgument &arg)
-{
-    int width, height, rowStride, hasAlpha, bitsPerSample, channels;
-    QByteArray pixels;
-    char *ptr;
-    char *end;
-
-    arg.beginStructure();
-    arg >> width >> height >> rowStride >> hasAlpha >> bitsPerSample >> channels >> pixels;
-    arg.endStructure();
-    //qDebug(notifyLog) << width << height << rowStride << hasAlpha << bitsPerSample << channels;
-
-#define SANITY_CHECK(condition) \
-if (!(condition)) { \
-    qWarning(notifyLog) << "Sanity check failed on" << #condition; \
-    return QImage(); \
-}
-
-    SANITY_CHECK(width > 0);
-    SANITY_CHECK(width < 2048);
-    SANITY_CHECK(height > 0);
-    SANITY_CHECK(height < 2048);
-    SANITY_CHECK(rowStride > 0);
-
-#undef SANITY_CHECK
-
-    QImage::Format format = QImage::Format_Invalid;
-    void (*fcn)(QRgb *, const char *, int) = nullptr;
-    if (bitsPerSample == 8) {
-        if (channels == 4) {
-            format = QImage::Format_ARGB32;
-            fcn = copyLineARGB32;
-        } else if (channels == 3) {
-            format = QImage::Format_RGB32;
-            fcn = copyLineRGB32;
-        }
-    }
-    if (format == QImage::Format_Invalid) {
-        qWarning(notifyLog) << "Unsupported image format (hasAlpha:" << hasAlpha << "bitsPerSample:" << bitsPerSample << "channels:" << channels << ")";
-        return QImage();
-    }
-
-    QImage image(width, height, format);
-    ptr = pixels.data();
-    end = ptr + pixels.length();
-    for (int y = 0; y < height; ++y, ptr += rowStride) {
-        if (ptr + channels * width > end) {
-            qWarning(notifyLog) << "Image data is incomplete. y:" << y << "height:" << height;
-            break;
-        }
-        fcn((QRgb *)image.scanLine(y), ptr, width);
-    }
-
-    return image;
+    return DS_NAMESPACE::DIconCache::instance()->iconName(appName, "application-x-desktop");
 }
 
-static QImage decodeImageFromBase64(const QString &arg)
-{
-    if (arg.startsWith("data:image/")) {
-        // iconPath is a string representing an inline image.
-        QStringList strs = arg.split("base64,");
-        if (strs.length() == 2) {
-            QByteArray data = QByteArray::fromBase64(strs.at(1).toLatin1());
-            return QImage::fromData(data);
-        }
-    }
-    return QImage();
-}
-
-static QIcon decodeIconFromPath(const QString &arg, const QString &fallback)
-{
-    DGUI_USE_NAMESPACE;
-    const QUrl url(arg);
-    const auto iconUrl = url.isLocalFile() ? url.toLocalFile() : url.url();
-    QIcon icon = DIconTheme::findQIcon(iconUrl);
-    if (!icon.isNull()) {
-        return icon;
-    }
-    return DIconTheme::findQIcon(fallback, DIconTheme::findQIcon("application-x-desktop"));
-}
-
-static QString imagePathOfNotification(const QVariantMap &hints, const QString &appIcon, const QString &appName)
-{
-    static const QStringList HintsOrder {
-            "desktop-entry",
-            "image-data",
-            "icon_data"
-    };
-
-    QImage img;
-    QString imageData(appIcon);
-    for (const auto &hint : HintsOrder) {
-        const auto &source = hints[hint];
-        if (source.isNull())
-            continue;
-        if (source.canConvert<QDBusArgument>()) {
-            img = decodeImageFromDBusArgument(source.value<QDBusArgument>());
-            if (!img.isNull())
-                break;
-        }
-        imageData = source.toString();
-    }
-    if (img.isNull()) {
-        img = decodeImageFromBase64(imageData);
-    }
-    if (!img.isNull()) {
-        QTemporaryFile file("notification_icon");
-        img.save(file.fileName());
-        return file.fileName();
-    }
-
-    DGUI_USE_NAMESPACE;
-    auto icon = DIconTheme::findQIcon(appName, DIconTheme::findQIcon("application-x-desktop"));
-    return icon.name();
-}
-
-
 BubbleItem::BubbleItem(QObject *parent)
     : QObject(parent)
     , m_timeTip(tr("just now"))
@@ -168,7 +36,10 @@ BubbleItem::BubbleItem(const NotifyEntity &entity, QObject *parent)
 
 void BubbleItem::setEntity(const NotifyEntity &entity)
 {
+    // items are reused by BubbleModel, all the state is reset for the new entity.
+    reset();
     m_entity = entity;
+    m_timeTip = tr("just now");
     updateActions();
 
     QVariantMap hints = entity.hints();
@@ -177,6 +48,19 @@ void BubbleItem::setEntity(const NotifyEntity &entity)
     }
 }
 
+void BubbleItem::reset()
+{
+    // shared by the recycled items, so releasing the entity doesn't allocate an empty one each time.
+    static const NotifyEntity EmptyEntity;
+    m_entity = EmptyEntity;
+    m_level = 0;
+    m_urgency = NotifyEntity::Normal;
+    m_timeTip.clear();
+    m_enablePreview = true;
+    m_actions.clear();
+    m_defaultAction.clear();
+}
+
 qint64 BubbleItem::id() const
 {
     return m_entity.id();
@@ -198,7 +82,7 @@ QString BubbleItem::appIcon() const
         return m_entity.appIcon();
     }
 
-    return imagePathOfNotification(m_entity.hints(), m_entity.appIcon(), m_entity.appName());
+    return iconOfNotification(m_entity.appName());
 }
 
 QString BubbleItem::summary() const
@@ -21,6 +21,8 @@ public:
 
 public:
     void setEntity(const NotifyEntity &entity);
+    // drops the entity and the state of a recycled item, nothing is allocated.
+    void reset();
 
 public:
     qint64 id() const;
@@ -5,6 +5,7 @@
 #include "bubblemodel.h"
 
 #include <notifysetting.h>
+#include <timeticker.h>
 
 #include "bubbleitem.h"
 
@@ -15,47 +16,62 @@
 #include <QTemporaryFile>
 #include <QUrl>
 
+#include <algorithm>
+
 namespace notification {
 Q_DECLARE_LOGGING_CATEGORY(notifyLog)
 }
 
 namespace notification {
 
+static const int InitialCapacity = 8;
+static const int FreeItemMaxCount = 8;
+
 BubbleModel::BubbleModel(QObject *parent)
     : QAbstractListModel(parent)
-    , m_updateTimeTipTimer(new QTimer(this))
 {
-    m_updateTimeTipTimer->setInterval(1000);
-    m_updateTimeTipTimer->setSingleShot(false);
     BubbleMaxCount = NotifySetting::instance()->bubbleCount();
+    m_ring.resize(InitialCapacity);
 
-    connect(m_updateTimeTipTimer, &QTimer::timeout, this, &BubbleModel::updateBubbleTimeTip);
     connect(NotifySetting::instance(), &NotifySetting::contentRowCountChanged, this, &BubbleModel::updateContentRowCount);
     connect(NotifySetting::instance(), &NotifySetting::bubbleCountChanged, this, &BubbleModel::updateBubbleCount);
 }
 
 BubbleModel::~BubbleModel()
 {
-    qDeleteAll(m_bubbles);
-    m_bubbles.clear();
+    qDeleteAll(items());
+    qDeleteAll(m_freeItems);
+    m_freeItems.clear();
 }
 
-void BubbleModel::push(BubbleItem *bubble)
+BubbleItem *BubbleModel::createItem(const NotifyEntity &entity)
 {
-    if (!m_updateTimeTipTimer->isActive()) {
-        m_updateTimeTipTimer->start();
-    }
+    if (m_freeItems.isEmpty())
+        return new BubbleItem(entity);
 
+    auto bubble = m_freeItems.takeLast();
+    bubble->setEntity(entity);
+    return bubble;
+}
+
+void BubbleModel::push(BubbleItem *bubble)
+{
     bool more = displayRowCount() >= BubbleMaxCount;
     if (more) {
         beginRemoveRows(QModelIndex(), BubbleMaxCount - 1, BubbleMaxCount - 1);
         endRemoveRows();
     }
     beginInsertRows(QModelIndex(), 0, 0);
-    m_bubbles.prepend(bubble);
+    if (m_count >= m_ring.size())
+        grow();
+    m_head = (m_head - 1) & (m_ring.size() - 1);
+    m_ring[m_head] = bubble;
+    m_slots.insert(bubble->bubbleId(), m_head);
+    m_count++;
     endInsertRows();
 
     updateLevel();
+    scheduleBubbleTimeTip();
 }
 
 bool BubbleModel::isReplaceBubble(const BubbleItem *bubble) const
@@ -63,94 +79,108 @@ bool BubbleModel::isReplaceBubble(const BubbleItem *bubble) const
     return replaceBubbleIndex(bubble) >= 0;
 }
 
-BubbleItem *BubbleModel::replaceBubble(BubbleItem *bubble)
+void BubbleModel::replaceBubble(BubbleItem *bubble)
 {
     Q_ASSERT(isReplaceBubble(bubble));
     const auto replaceIndex = replaceBubbleIndex(bubble);
-    const auto oldBubble = m_bubbles[replaceIndex];
-    m_bubbles.replace(replaceIndex, bubble);
+    const auto slot = slotOf(replaceIndex);
+    const auto oldBubble = m_ring[slot];
+    m_ring[slot] = bubble;
+    m_slots.insert(bubble->bubbleId(), slot);
     Q_EMIT dataChanged(index(replaceIndex), index(replaceIndex));
+    scheduleBubbleTimeTip();
 
-    return oldBubble;
+    recycle(oldBubble);
 }
 
 void BubbleModel::clear()
 {
-    if (m_bubbles.count() <= 0)
+    if (m_count <= 0)
         return;
     beginResetModel();
-    qDeleteAll(m_bubbles);
-    m_bubbles.clear();
+    const auto bubbles = items();
+    std::fill(m_ring.begin(), m_ring.end(), nullptr);
+    m_head = 0;
+    m_count = 0;
+    m_slots.clear();
+    for (auto bubble : bubbles)
+        recycle(bubble);
     endResetModel();
     m_delayBubbles.clear();
     m_delayRemovedBubble = -1;
 
     updateLevel();
-    m_updateTimeTipTimer->stop();
+    TimeTicker::instance()->cancel(this);
 }
 
 QList<BubbleItem *> BubbleModel::items() const
 {
-    return m_bubbles;
+    QList<BubbleItem *> ret;
+    ret.reserve(m_count);
+    for (int i = 0; i < m_count; i++)
+        ret << at(i);
+    return ret;
+}
+
+int BubbleModel::bubbleCount() const
+{
+    return m_count;
 }
 
 void BubbleModel::remove(int index)
 {
-    if (index < 0 || index >= m_bubbles.size())
+    if (index < 0 || index >= m_count)
         return;
 
     if (index >= rowCount(QModelIndex())) {
-        auto bubble = m_bubbles.takeAt(index);
-        bubble->deleteLater();
+        recycle(takeAt(index));
         return;
     }
 
     beginRemoveRows(QModelIndex(), index, index);
-    auto bubble = m_bubbles.takeAt(index);
-    bubble->deleteLater();
+    auto bubble = takeAt(index);
     endRemoveRows();
+    recycle(bubble);
 
-    if (m_bubbles.count() >= BubbleMaxCount) {
+    if (m_count >= BubbleMaxCount) {
         beginInsertRows(QModelIndex(), displayRowCount() - 1, displayRowCount() - 1);
         endInsertRows();
     }
     updateLevel();
+    // a hidden bubble may be displayed now.
+    updateBubbleTimeTip();
 }
 
 void BubbleModel::remove(const BubbleItem *bubble)
 {
-    const auto index = m_bubbles.indexOf(bubble);
-    if (index >= 0) {
+    const auto index = indexOf(bubble->bubbleId());
+    if (index >= 0 && at(index) == bubble) {
         remove(index);
     }
 }
 
-BubbleItem *BubbleModel::removeById(qint64 id)
+bool BubbleModel::removeById(qint64 bubbleId)
 {
-    if (id == m_delayRemovedBubble) {
+    if (bubbleId == m_delayRemovedBubble) {
         // Delayed remove
-        if (!m_delayBubbles.contains(id)) {
-            m_delayBubbles.append(id);
-        }
-        return nullptr;
-    }
-    for (const auto &item : m_bubbles) {
-        if (item->bubbleId() == id) {
-            m_delayBubbles.removeAll(id);
-            remove(m_bubbles.indexOf(item));
-            return item;
-        }
+        m_delayBubbles.insert(bubbleId);
+        return false;
     }
+    const auto index = indexOf(bubbleId);
+    if (index < 0)
+        return false;
 
-    return nullptr;
+    m_delayBubbles.remove(bubbleId);
+    remove(index);
+    return true;
 }
 
 BubbleItem *BubbleModel::bubbleItem(int bubbleIndex) const
 {
-    if (bubbleIndex < 0 || bubbleIndex >= items().count())
+    if (bubbleIndex < 0 || bubbleIndex >= m_count)
         return nullptr;
 
-    return items().at(bubbleIndex);
+    return at(bubbleIndex);
 }
 
 int BubbleModel::rowCount(const QModelIndex &parent) const
@@ -162,36 +192,38 @@ int BubbleModel::rowCount(const QModelIndex &parent) const
 QVariant BubbleModel::data(const QModelIndex &index, int role) const
 {
     const int row = index.row();
-    if (row >= m_bubbles.size() || !index.isValid())
+    if (row >= m_count || !index.isValid())
         return {};
 
+    const auto bubble = at(row);
+
     switch (role) {
     case BubbleModel::AppName:
-        return m_bubbles[row]->appName();
+        return bubble->appName();
     case BubbleModel::Id:
-        return m_bubbles[row]->bubbleId();
+        return bubble->bubbleId();
     case BubbleModel::Body:
-        return m_bubbles[row]->body();
+        return bubble->body();
     case BubbleModel::Summary:
-        return m_bubbles[row]->summary();
+        return bubble->summary();
     case BubbleModel::IconName:
-        return m_bubbles[row]->appIcon();
+        return bubble->appIcon();
     case BubbleModel::Level:
-        return m_bubbles[row]->level();
+        return bubble->level();
     case BubbleModel::CTime:
-        return m_bubbles[row]->ctime();
+        return bubble->ctime();
     case BubbleModel::TimeTip:
-        return m_bubbles[row]->timeTip();
+        return bubble->timeTip();
     case BubbleModel::BodyImagePath:
-        return m_bubbles[row]->bodyImagePath();
+        return bubble->bodyImagePath();
     case BubbleModel::OverlayCount:
         return overlayCount();
     case BubbleModel::DefaultAction:
-        return m_bubbles[row]->defaultAction();
+        return bubble->defaultAction();
     case BubbleModel::Actions:
-        return m_bubbles[row]->actions();
+        return bubble->actions();
     case BubbleModel::Urgency:
-        return m_bubbles[row]->urgency();
+        return bubble->urgency();
     case BubbleModel::ContentRowCount:
         return NotifySetting::instance()->contentRowCount();
     default:
@@ -222,12 +254,12 @@ QHash<int, QByteArray> BubbleModel::roleNames() const
 
 int BubbleModel::displayRowCount() const
 {
-    return qMin(m_bubbles.count(), BubbleMaxCount);
+    return qMin(m_count, BubbleMaxCount);
 }
 
 int BubbleModel::overlayCount() const
 {
-    return qMin(m_bubbles.count() - displayRowCount(), OverlayMaxCount);
+    return qMin(m_count - displayRowCount(), OverlayMaxCount);
 }
 
 void BubbleModel::updateBubbleCount(int count)
@@ -241,7 +273,7 @@ void BubbleModel::updateBubbleCount(int count)
         beginRemoveRows(QModelIndex(), count, currentRowCount - 1);
         endRemoveRows();
     } else if (count > currentRowCount) {
-        int maxInsertCount = std::min(count, (int)m_bubbles.size());
+        int maxInsertCount = std::min(count, m_count);
         beginInsertRows(QModelIndex(), currentRowCount, maxInsertCount - 1);
         endInsertRows();
     }
@@ -276,50 +308,141 @@ void BubbleModel::setDelayRemovedBubble(qint64 newDelayRemovedBubble)
 int BubbleModel::replaceBubbleIndex(const BubbleItem *bubble) const
 {
     if (bubble->isReplace()) {
-        for (int i = 0; i < m_bubbles.size(); i++) {
-            auto item = m_bubbles[i];
-            if (item->appName() != bubble->appName())
-                continue;
-
-            if (item->bubbleId() == bubble->bubbleId()) {
-                return i;
-            }
+        const auto index = indexOf(bubble->bubbleId());
+        if (index >= 0 && at(index)->appName() == bubble->appName()) {
+            return index;
         }
     }
     return -1;
 }
 
+int BubbleModel::indexOf(qint64 bubbleId) const
+{
+    const auto iter = m_slots.constFind(bubbleId);
+    if (iter == m_slots.constEnd())
+        return -1;
+    return (iter.value() - m_head) & (m_ring.size() - 1);
+}
+
+// removes like a deque, the shorter side is moved, it's O(1) for the newest and the oldest bubble.
+BubbleItem *BubbleModel::takeAt(int bubbleIndex)
+{
+    auto bubble = at(bubbleIndex);
+    if (m_slots.value(bubble->bubbleId(), -1) == slotOf(bubbleIndex))
+        m_slots.remove(bubble->bubbleId());
+
+    if (bubbleIndex < m_count / 2) {
+        for (int i = bubbleIndex; i > 0; i--) {
+            const auto slot = slotOf(i);
+            m_ring[slot] = m_ring[slotOf(i - 1)];
+            m_slots.insert(m_ring[slot]->bubbleId(), slot);
+        }
+        m_ring[m_head] = nullptr;
+        m_head = (m_head + 1) & (m_ring.size() - 1);
+    } else {
+        for (int i = bubbleIndex; i < m_count - 1; i++) {
+            const auto slot = slotOf(i);
+            m_ring[slot] = m_ring[slotOf(i + 1)];
+            m_slots.insert(m_ring[slot]->bubbleId(), slot);
+        }
+        m_ring[slotOf(m_count - 1)] = nullptr;
+    }
+    m_count--;
+    return bubble;
+}
+
+void BubbleModel::grow()
+{
+    QList<BubbleItem *> ring(m_ring.size() * 2, nullptr);
+    m_slots.clear();
+    for (int i = 0; i < m_count; i++) {
+        ring[i] = at(i);
+        m_slots.insert(ring[i]->bubbleId(), i);
+    }
+    m_ring = ring;
+    m_head = 0;
+}
+
+void BubbleModel::recycle(BubbleItem *bubble)
+{
+    if (!bubble)
+        return;
+    if (m_freeItems.size() >= FreeItemMaxCount) {
+        bubble->deleteLater();
+        return;
+    }
+    // drops the entity's data, it's set again when the item is created again.
+    bubble->reset();
+    m_freeItems.append(bubble);
+}
+
 void BubbleModel::updateLevel()
 {
-    if (m_bubbles.isEmpty())
+    if (m_count <= 0)
         return;
 
     int lastBubbleMaxIndex = BubbleMaxCount - 1;
     for (int i = 0; i < displayRowCount(); i++) {
-        auto item = m_bubbles.at(i);
+        auto item = at(i);
         item->setLevel(i == lastBubbleMaxIndex ? 1 + overlayCount() : 1);
     }
     Q_EMIT dataChanged(index(0), index(displayRowCount() - 1), {BubbleModel::Level});
 }
 
+// the time tip changes every minute, from "just now" to "%1 minutes ago".
+static qint64 nextTimeTipUpdate(qint64 ctime, qint64 now)
+{
+    const auto minutes = std::max<qint64>(0, (now - ctime) / 1000 / 60);
+    return ctime + (minutes + 1) * 60 * 1000;
+}
+
 void BubbleModel::updateBubbleTimeTip()
 {
-    if (m_bubbles.isEmpty()) {
-        m_updateTimeTipTimer->stop();
-        return;
+    const auto now = QDateTime::currentMSecsSinceEpoch();
+    const int displayCount = displayRowCount();
+    int first = -1;
+    for (int i = 0; i <= displayCount; i++) {
+        bool changed = false;
+        if (i < displayCount) {
+            auto item = at(i);
+            qint64 diff = now - item->ctime();
+            diff /= 1000; // secs
+            if (diff >= 60) {
+                const auto timeTip = tr("%1 minutes ago").arg(diff / 60);
+                changed = timeTip != item->timeTip();
+                item->setTimeTip(timeTip);
+            }
+        }
+        if (changed && first < 0) {
+            first = i;
+        } else if (!changed && first >= 0) {
+            Q_EMIT dataChanged(index(first), index(i - 1), {BubbleModel::TimeTip});
+            first = -1;
+        }
     }
 
-    for (auto item : m_bubbles) {
-        qint64 diff = QDateTime::currentMSecsSinceEpoch() - item->ctime();
-        diff /= 1000; // secs
-        if (diff >= 60) {
-            QString timeTip;
-            timeTip = tr("%1 minutes ago").arg(diff / 60);
-            item->setTimeTip(timeTip);
-        };
+    scheduleBubbleTimeTip();
+}
+
+void BubbleModel::scheduleBubbleTimeTip()
+{
+    // hidden bubbles get their time tip once they're displayed.
+    const auto now = QDateTime::currentMSecsSinceEpoch();
+    const int displayCount = displayRowCount();
+    qint64 next = 0;
+    for (int i = 0; i < displayCount; i++) {
+        const auto time = nextTimeTipUpdate(at(i)->ctime(), now);
+        if (next <= 0 || time < next)
+            next = time;
     }
 
-    Q_EMIT dataChanged(index(0), index(m_bubbles.size() - 1), {BubbleModel::TimeTip});
+    if (next <= 0) {
+        TimeTicker::instance()->cancel(this);
+        return;
+    }
+    TimeTicker::instance()->schedule(this, next, [this]() {
+        updateBubbleTimeTip();
+    });
 }
 
 void BubbleModel::updateContentRowCount(int rowCount)
@@ -329,8 +452,8 @@ void BubbleModel::updateContentRowCount(int rowCount)
 
     m_contentRowCount = rowCount;
 
-    if (!m_bubbles.isEmpty()) {
-        Q_EMIT dataChanged(index(0), index(m_bubbles.size() - 1), {BubbleModel::ContentRowCount});
+    if (m_count > 0) {
+        Q_EMIT dataChanged(index(0), index(displayRowCount() - 1), {BubbleModel::ContentRowCount});
     }
 }
 }
@@ -7,12 +7,12 @@
 #include "dsglobal.h"
 
 #include <QAbstractListModel>
-
-class QTimer;
+#include <QSet>
 
 namespace notification {
 
 class BubbleItem;
+class NotifyEntity;
 class BubbleModel : public QAbstractListModel
 {
     Q_OBJECT
@@ -39,16 +39,20 @@ public:
     ~BubbleModel() override;
 
 public:
+    // bubbles are recycled by the model, they're valid until they're removed from the model.
+    BubbleItem *createItem(const NotifyEntity &entity);
     void push(BubbleItem *bubble);
 
-    BubbleItem *replaceBubble(BubbleItem *bubble);
+    void replaceBubble(BubbleItem *bubble);
     bool isReplaceBubble(const BubbleItem *bubble) const;
 
     QList<BubbleItem *> items() const;
+    int bubbleCount() const;
 
     Q_INVOKABLE void remove(int index);
     void remove(const BubbleItem *bubble);
-    BubbleItem *removeById(qint64 id);
+    // bubbles are identified by their bubble id, it's a qint64 as `delayRemovedBubble`, -1 is none.
+    bool removeById(qint64 bubbleId);
     void clear();
 
     BubbleItem *bubbleItem(int bubbleIndex) const;
@@ -71,15 +75,27 @@ private:
     int replaceBubbleIndex(const BubbleItem *bubble) const;
     void updateLevel();
     void updateBubbleTimeTip();
+    void scheduleBubbleTimeTip();
     void updateContentRowCount(int rowCount);
 
+    inline int slotOf(int bubbleIndex) const { return (m_head + bubbleIndex) & (m_ring.size() - 1); }
+    inline BubbleItem *at(int bubbleIndex) const { return m_ring[slotOf(bubbleIndex)]; }
+    int indexOf(qint64 bubbleId) const;
+    BubbleItem *takeAt(int bubbleIndex);
+    void grow();
+    void recycle(BubbleItem *bubble);
+
 private:
-    QTimer *m_updateTimeTipTimer = nullptr;
-    QList<BubbleItem *> m_bubbles;
+    // bubbles in a ring buffer, the newest one is at `m_head`, the capacity is a power of 2.
+    QList<BubbleItem *> m_ring;
+    int m_head{0};
+    int m_count{0};
+    QHash<qint64, int> m_slots;
+    QList<BubbleItem *> m_freeItems;
     int BubbleMaxCount{3};
     int m_contentRowCount{6};
     const int OverlayMaxCount{2};
-    QList<qint64> m_delayBubbles;
+    QSet<qint64> m_delayBubbles;
     qint64 m_delayRemovedBubble{-1};
     const int DelayRemovBubbleTime{1000};
 };
@@ -5,13 +5,15 @@
 #include "bubblepanel.h"
 #include "bubbleitem.h"
 #include "bubblemodel.h"
-#include "dataaccessorproxy.h"
+#include "notifyeventchannel.h"
+#include "notifyimagecache.h"
 #include "pluginfactory.h"
 
 #include <QLoggingCategory>
 #include <QQueue>
 
 #include <appletbridge.h>
+#include <qmlengine.h>
 
 namespace notification {
 Q_DECLARE_LOGGING_CATEGORY(notifyLog)
@@ -38,6 +40,7 @@ bool BubblePanel::load()
 
 bool BubblePanel::init()
 {
+    NotifyImageCache::registerImageProvider(DS_NAMESPACE::DQmlEngine().engine());
     DPanel::init();
     DS_NAMESPACE::DAppletBridge bridge("org.deepin.ds.notificationserver");
     m_notificationServer = bridge.applet();
@@ -46,9 +49,7 @@ bool BubblePanel::init()
         return false;
     }
 
-    m_accessor = DataAccessorProxy::instance();
-
-    connect(m_notificationServer, SIGNAL(notificationStateChanged(qint64, int)), this, SLOT(onNotificationStateChanged(qint64, int)));
+    connect(NotifyEventChannel::instance(), &NotifyEventChannel::entitiesStateChanged, this, &BubblePanel::onEntitiesStateChanged, Qt::QueuedConnection);
 
     connect(m_bubbles, &BubbleModel::rowsInserted, this, &BubblePanel::onBubbleCountChanged);
     connect(m_bubbles, &BubbleModel::rowsRemoved, this, &BubblePanel::onBubbleCountChanged);
@@ -72,8 +73,11 @@ void BubblePanel::invokeAction(int bubbleIndex, const QString &actionId)
     if (!bubble)
         return;
 
+    // the bubble is recycled once it's removed.
+    const auto id = bubble->id();
+    const auto bubbleId = bubble->bubbleId();
     m_bubbles->remove(bubbleIndex);
-    onActionInvoked(bubble->id(), bubble->bubbleId(), actionId);
+    onActionInvoked(id, bubbleId, actionId);
 }
 
 void BubblePanel::close(int bubbleIndex, int reason)
@@ -82,8 +86,10 @@ void BubblePanel::close(int bubbleIndex, int reason)
     if (!bubble)
         return;
 
+    const auto id = bubble->id();
+    const auto bubbleId = bubble->bubbleId();
     m_bubbles->remove(bubbleIndex);
-    onBubbleClosed(bubble->id(), bubble->bubbleId(), reason);
+    onBubbleClosed(id, bubbleId, reason);
 }
 
 void BubblePanel::delayProcess(int bubbleIndex)
@@ -92,63 +98,60 @@ void BubblePanel::delayProcess(int bubbleIndex)
     if (!bubble)
         return;
 
+    const auto id = bubble->id();
+    const auto bubbleId = bubble->bubbleId();
     m_bubbles->remove(bubbleIndex);
-    onBubbleClosed(bubble->id(), bubble->bubbleId(), NotifyEntity::Dismissed);
+    onBubbleClosed(id, bubbleId, NotifyEntity::Dismissed);
 }
 
-void BubblePanel::onNotificationStateChanged(qint64 id, int processedType)
+void BubblePanel::onEntitiesStateChanged(const QList<NotifyEntity> &entities)
 {
-    if (processedType == NotifyEntity::NotProcessed) {
-        qDebug(notifyLog) << "Add bubble for the notification" << id;
-        addBubble(id);
-    } else if (processedType == NotifyEntity::Processed || processedType == NotifyEntity::Removed) {
-        qDebug(notifyLog) << "Close bubble for the notification" << id;
-        closeBubble(id);
+    for (const auto &entity : entities) {
+        const auto processedType = entity.processedType();
+        if (processedType == NotifyEntity::NotProcessed) {
+            qDebug(notifyLog) << "Add bubble for the notification" << entity.id();
+            addBubble(entity);
+        } else if (processedType == NotifyEntity::Processed || processedType == NotifyEntity::Removed) {
+            qDebug(notifyLog) << "Close bubble for the notification" << entity.id();
+            closeBubble(entity);
+        }
     }
 }
 
 void BubblePanel::onBubbleCountChanged()
 {
-    bool isEmpty = m_bubbles->items().isEmpty();
+    bool isEmpty = m_bubbles->bubbleCount() <= 0;
     setVisible(!isEmpty && enabled());
 }
 
-void BubblePanel::addBubble(qint64 id)
+void BubblePanel::addBubble(const NotifyEntity &entity)
 {
-    const auto entity = m_accessor->fetchEntity(id);
-    auto bubble = new BubbleItem(entity);
+    auto bubble = m_bubbles->createItem(entity);
     const auto enabled = enablePreview(entity.appId());
     bubble->setEnablePreview(enabled);
     if (m_bubbles->isReplaceBubble(bubble)) {
-        auto oldBubble = m_bubbles->replaceBubble(bubble);
-        if (oldBubble) {
-            oldBubble->deleteLater();
-        }
+        m_bubbles->replaceBubble(bubble);
     } else {
         m_bubbles->push(bubble);
     }
 }
 
-void BubblePanel::closeBubble(qint64 id)
+void BubblePanel::closeBubble(const NotifyEntity &entity)
 {
-    const auto entity = m_accessor->fetchEntity(id);
     if (!entity.isValid())
         return;
 
-    id = entity.bubbleId();
-    m_bubbles->removeById(id);
+    m_bubbles->removeById(entity.bubbleId());
 }
 
 void BubblePanel::onActionInvoked(qint64 id, uint bubbleId, const QString &actionId)
 {
-    QMetaObject::invokeMethod(m_notificationServer, "actionInvoked", Qt::DirectConnection,
-                              Q_ARG(qint64, id), Q_ARG(uint, bubbleId), Q_ARG(QString, actionId));
+    NotifyEventChannel::instance()->invokeAction(id, bubbleId, actionId);
 }
 
 void BubblePanel::onBubbleClosed(qint64 id, uint bubbleId, uint reason)
 {
-    QMetaObject::invokeMethod(m_notificationServer, "notificationClosed", Qt::DirectConnection,
-                              Q_ARG(qint64, id), Q_ARG(uint, bubbleId), Q_ARG(uint, reason));
+    NotifyEventChannel::instance()->closeNotification(id, bubbleId, reason);
 }
 
 void BubblePanel::setVisible(const bool visible)
@@ -162,17 +165,12 @@ void BubblePanel::setVisible(const bool visible)
 bool BubblePanel::enablePreview(const QString &appId) const
 {
     static const int EnablePreview = 3;
-    QVariant value;
-    QMetaObject::invokeMethod(m_notificationServer, "appValue", Qt::DirectConnection,
-                              Q_RETURN_ARG(QVariant, value), Q_ARG(const QString &, appId), Q_ARG(int, EnablePreview));
-    return value.toBool();
+    return NotifyEventChannel::instance()->appValue(appId, EnablePreview).toBool();
 }
 
 BubbleItem *BubblePanel::bubbleItem(int index)
 {
-    if (index < 0 || index >= m_bubbles->items().count())
-        return nullptr;
-    return m_bubbles->items().at(index);
+    return m_bubbles->bubbleItem(index);
 }
 
 D_APPLET_CLASS(BubblePanel)
@@ -189,7 +187,7 @@ void BubblePanel::setEnabled(bool newEnabled)
     m_enabled = newEnabled;
     emit enabledChanged();
 
-    bool isEmpty = m_bubbles->items().isEmpty();
+    bool isEmpty = m_bubbles->bubbleCount() <= 0;
     setVisible(!isEmpty && enabled());
 }
 
@@ -5,14 +5,13 @@
 #pragma once
 
 #include "panel.h"
-#include "dataaccessor.h"
+#include "notifyentity.h"
 #include <appletproxy.h>
 
 #include <QQuickItem>
 
 namespace notification {
 
-class NotifyEntity;
 class BubbleModel;
 class BubbleItem;
 
@@ -46,9 +45,9 @@ Q_SIGNALS:
     void enabledChanged();
 
 private Q_SLOTS:
-    void onNotificationStateChanged(qint64 id, int processedType);
-    void addBubble(qint64 id);
-    void closeBubble(qint64 id);
+    void onEntitiesStateChanged(const QList<NotifyEntity> &entities);
+    void addBubble(const NotifyEntity &entity);
+    void closeBubble(const NotifyEntity &entity);
     void onBubbleCountChanged();
 
 private:
@@ -64,7 +63,6 @@ private:
     bool m_visible = false;
     BubbleModel *m_bubbles = nullptr;
     DS_NAMESPACE::DAppletProxy *m_notificationServer = nullptr;
-    DataAccessor *m_accessor = nullptr;
     bool m_enabled = true;
 };
 
@@ -75,6 +75,8 @@ DelegateChooser {
             contentRowCount: model.contentRowCount
             defaultAction: model.defaultAction
 
+            Component.onCompleted: notifyModel.fetchMoreApp(index)
+
             Loader {
                 anchors.fill: parent
                 active: normalNotify.activeFocus && NotifyAccessor.debugging
@@ -8,12 +8,15 @@
 #include "notificationcenterdbusadaptor.h"
 #include "notificationcenterproxy.h"
 #include "notifyaccessor.h"
+#include "notifyeventchannel.h"
+#include "notifyimagecache.h"
 
 #include <pluginfactory.h>
 #include <pluginloader.h>
 #include <applet.h>
 #include <containment.h>
 #include <appletbridge.h>
+#include <qmlengine.h>
 
 #include <QQueue>
 #include <QDBusConnection>
@@ -73,6 +76,7 @@ bool NotificationCenterPanel::init()
     }
     new NotificationCenterDBusAdaptor(m_proxy);
 
+    notification::NotifyImageCache::registerImageProvider(DS_NAMESPACE::DQmlEngine().engine());
     DPanel::init();
 
     auto accessor = notification::DataAccessorProxy::instance();
@@ -81,10 +85,10 @@ bool NotificationCenterPanel::init()
     bool valid = false;
     DAppletBridge bridge("org.deepin.ds.notificationserver");
     if (auto server = bridge.applet()) {
-        valid = QObject::connect(server,
-                                 SIGNAL(notificationStateChanged(qint64, int)),
+        valid = QObject::connect(notification::NotifyEventChannel::instance(),
+                                 &notification::NotifyEventChannel::entitiesStateChanged,
                                  notifycenter::NotifyAccessor::instance(),
-                                 SLOT(onNotificationStateChanged(qint64, int)),
+                                 &notifycenter::NotifyAccessor::onEntitiesStateChanged,
                                  Qt::QueuedConnection);
         notifycenter::NotifyAccessor::instance()->setDataUpdater(server);
         notifycenter::NotifyAccessor::instance()->setEnabled(visible());
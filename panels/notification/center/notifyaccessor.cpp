@@ -15,6 +15,7 @@
 #include <DConfig>
 
 #include "dataaccessor.h"
+#include "notifyeventchannel.h"
 
 DCORE_USE_NAMESPACE
 
@@ -129,6 +130,20 @@ QList<NotifyEntity> NotifyAccessor::fetchEntities(const QString &appName, int ma
     return ret;
 }
 
+QList<NotifyEntity> NotifyAccessor::fetchEntities(const QString &appName, const NotifyEntity &last, int maxCount)
+{
+    qDebug(notifyLog) << "Fetch entities for the app" << appName << ", after the entity" << last.id();
+    auto ret = m_accessor->fetchEntities(appName, NotifyEntity::Processed, last.cTime(), last.id(), maxCount);
+    return ret;
+}
+
+QList<AppEntitySummary> NotifyAccessor::fetchAppSummaries() const
+{
+    qDebug(notifyLog) << "Fetch app summaries";
+    auto ret = m_accessor->fetchAppSummaries(NotifyEntity::Processed);
+    return ret;
+}
+
 QStringList NotifyAccessor::fetchApps(int maxCount) const
 {
     qDebug(notifyLog) << "Fetch apps count" << maxCount;
@@ -136,6 +151,13 @@ QStringList NotifyAccessor::fetchApps(int maxCount) const
     return ret;
 }
 
+QList<NotifySearchHit> NotifyAccessor::search(const QString &text, int offset, int maxCount) const
+{
+    qDebug(notifyLog) << "Search entities, offset" << offset << ", count" << maxCount;
+    auto ret = m_accessor->searchEntities(text, NotifyEntity::Processed, offset, maxCount);
+    return ret;
+}
+
 void NotifyAccessor::removeEntity(qint64 id)
 {
     qDebug(notifyLog) << "Remove notify" << id;
@@ -176,7 +198,7 @@ void NotifyAccessor::closeNotify(const NotifyEntity &entity, NotifyEntity::Close
         return;
     const auto id = entity.id();
     const auto bubbleId = entity.bubbleId();
-    QMetaObject::invokeMethod(m_dataUpdater, "notificationClosed", Qt::DirectConnection, Q_ARG(qint64, id), Q_ARG(uint, bubbleId), Q_ARG(uint, reason));
+    NotifyEventChannel::instance()->closeNotification(id, bubbleId, reason);
 }
 
 void NotifyAccessor::invokeNotify(const NotifyEntity &entity, const QString &actionId)
@@ -186,9 +208,7 @@ void NotifyAccessor::invokeNotify(const NotifyEntity &entity, const QString &act
     const auto id = entity.id();
     const auto bubbleId = entity.bubbleId();
     qDebug(notifyLog) << "Invoke notify" << id << actionId;
-    QMetaObject::invokeMethod(m_dataUpdater, "actionInvoked", Qt::DirectConnection,
-                              Q_ARG(qint64, id), Q_ARG(uint, bubbleId), Q_ARG(const QString&, actionId));
-
+    NotifyEventChannel::instance()->invokeAction(id, bubbleId, actionId);
 }
 
 // don't need to emit ActionInvoked of protocol.
@@ -261,7 +281,7 @@ void NotifyAccessor::addNotify(const QString &appName, const QString &content)
     m_accessor->addEntity(entity);
 
     if (auto entity = fetchLastEntity(appName); entity.isValid()) {
-        entityReceived(entity.id());
+        entityReceived(entity);
     }
 }
 
@@ -280,21 +300,27 @@ void NotifyAccessor::fetchDataInfo()
     appsChanged();
 }
 
-void NotifyAccessor::onNotificationStateChanged(qint64 id, int processedType)
+void NotifyAccessor::onEntitiesStateChanged(const QList<NotifyEntity> &entities)
 {
     if (!enabled())
         return;
-    if (processedType == NotifyEntity::Processed) {
-        emit entityReceived(id);
-        emit stagingEntityClosed(id);
-    } else if (processedType == NotifyEntity::NotProcessed) {
-        emit stagingEntityReceived(id);
+    for (const auto &entity : entities) {
+        const auto processedType = entity.processedType();
+        if (processedType == NotifyEntity::Processed) {
+            emit entityReceived(entity);
+            emit stagingEntityClosed(entity);
+        } else if (processedType == NotifyEntity::NotProcessed) {
+            emit stagingEntityReceived(entity);
+        }
     }
 }
 
 void NotifyAccessor::onReceivedRecord(const QString &id)
 {
-    emit entityReceived(id.toLongLong());
+    // the old interface only sends the id.
+    if (auto entity = fetchEntity(id.toLongLong()); entity.isValid()) {
+        emit entityReceived(entity);
+    }
 }
 
 QString NotifyAccessor::dataInfo() const
@@ -12,6 +12,8 @@ class QQmlEngine;
 class QJSEngine;
 namespace notification {
 class DataAccessor;
+struct AppEntitySummary;
+struct NotifySearchHit;
 }
 
 namespace notifycenter {
@@ -47,7 +49,10 @@ public:
     int fetchEntityCount(const QString &appName) const;
     NotifyEntity fetchLastEntity(const QString &appName) const;
     QList<NotifyEntity> fetchEntities(const QString &appName, int maxCount = -1);
+    QList<NotifyEntity> fetchEntities(const QString &appName, const NotifyEntity &last, int maxCount);
+    QList<AppEntitySummary> fetchAppSummaries() const;
     QStringList fetchApps(int maxCount = -1) const;
+    QList<NotifySearchHit> search(const QString &text, int offset, int maxCount) const;
     void removeEntity(qint64 id);
     void removeEntityByApp(const QString &appName);
     void clear();
@@ -56,13 +61,14 @@ public:
     void invokeNotify(const NotifyEntity &entity, const QString &actionId);
 
 signals:
-    void entityReceived(qint64 id);
-    void stagingEntityReceived(qint64 id);
-    void stagingEntityClosed(qint64 id);
+    void entityReceived(const NotifyEntity &entity);
+    void stagingEntityReceived(const NotifyEntity &entity);
+    void stagingEntityClosed(const NotifyEntity &entity);
 
 public slots:
     void addNotify(const QString &appName, const QString &content);
     void fetchDataInfo();
+    void onEntitiesStateChanged(const QList<NotifyEntity> &entities);
 
 signals:
     void dataInfoChanged();
@@ -70,7 +76,6 @@ signals:
     void debuggingChanged();
 
 private slots:
-    void onNotificationStateChanged(qint64 id, int processedType);
     void onReceivedRecord(const QString &id);
 
 private:
@@ -71,15 +71,20 @@ void AppNotifyItem::updateTime()
     QString ret;
     QDateTime currentTime = QDateTime::currentDateTime();
     auto elapsedDay = time.daysTo(currentTime);
+    // the day changes at the next midnight, all labels except the date depend on it.
+    qint64 next = QDateTime(currentTime.date().addDays(1), QTime(0, 0)).toMSecsSinceEpoch();
     if (elapsedDay == 0) {
-        qint64 msec = QDateTime::currentMSecsSinceEpoch() - m_entity.cTime();
+        qint64 msec = currentTime.toMSecsSinceEpoch() - m_entity.cTime();
         auto minute = msec / 1000 / 60;
         if (minute <= 0) {
             ret = tr("Just now");
+            next = std::min(next, m_entity.cTime() + 60 * 1000);
         } else if (minute > 0 && minute < 60) {
             ret = tr("%1 minutes ago").arg(minute);
+            next = std::min(next, m_entity.cTime() + (minute + 1) * 60 * 1000);
         } else {
             ret = tr("%1 hours ago").arg(minute / 60);
+            next = std::min(next, m_entity.cTime() + (minute / 60 + 1) * 60 * 60 * 1000);
         }
     } else if (elapsedDay >= 1 && elapsedDay < 2) {
         ret = tr("Yesterday ") + " " + time.toString("hh:mm");
@@ -87,9 +92,16 @@ void AppNotifyItem::updateTime()
         ret = time.toString("ddd hh:mm");
     } else {
         ret = time.toString("yyyy/MM/dd");
+        next = 0;
     }
 
     m_time = ret;
+    m_nextTimeUpdate = next;
+}
+
+qint64 AppNotifyItem::nextTimeUpdate() const
+{
+    return m_nextTimeUpdate;
 }
 
 bool AppNotifyItem::strongInteractive() const
@@ -33,6 +33,8 @@ public:
     virtual qint64 id() const;
     QString time() const;
     void updateTime();
+    // the time when the text of `time()` changes, 0 if it won't change anymore.
+    qint64 nextTimeUpdate() const;
     bool strongInteractive() const;
     QString contentIcon() const;
 
@@ -49,6 +51,7 @@ public:
 protected:
     QString m_appId;
     QString m_time;
+    qint64 m_nextTimeUpdate = 0;
     QVariantList m_actions;
     QString m_defaultAction;
     NotifyEntity m_entity;
@@ -4,19 +4,25 @@
 
 #include "notifymodel.h"
 
-#include <QTimerEvent>
+#include <QDateTime>
 #include <QLoggingCategory>
 
+#include "dataaccessor.h"
 #include "notifyentity.h"
 #include "notifyitem.h"
 #include "notifyaccessor.h"
 #include "notifysetting.h"
+#include "timeticker.h"
 
 namespace notification {
 Q_DECLARE_LOGGING_CATEGORY(notifyLog)
 }
 namespace notifycenter {
 
+// notifies of an expanded app are loaded by pages, the next page of an app is
+// fetched when the view reaches the last loaded notify of its group.
+static const int PageSize = 20;
+
 NotifyModel::NotifyModel(QObject *parent)
     : QAbstractListModel(parent)
     , m_accessor(NotifyAccessor::instance())
@@ -24,6 +30,8 @@ NotifyModel::NotifyModel(QObject *parent)
     connect(m_accessor, &NotifyAccessor::entityReceived, this, &NotifyModel::doEntityReceived);
     connect(this, &NotifyModel::countChanged, this, &NotifyModel::onCountChanged);
     connect(NotifySetting::instance(), &NotifySetting::contentRowCountChanged, this, &NotifyModel::updateContentRowCount);
+    connect(this, &NotifyModel::rowsInserted, this, &NotifyModel::scheduleTimeUpdate);
+    connect(this, &NotifyModel::modelReset, this, &NotifyModel::scheduleTimeUpdate);
 
     updateCollapseStatus();
 
@@ -59,7 +67,7 @@ void NotifyModel::expandApp(int row)
     endRemoveRows();
     notify->deleteLater();
 
-    auto entities = m_accessor->fetchEntities(appName);
+    auto entities = m_accessor->fetchEntities(appName, PageSize);
     if(entities.size() >= 2) {
         QList<AppNotifyItem *> notifies;
         for (auto entity: entities) {
@@ -79,6 +87,9 @@ void NotifyModel::expandApp(int row)
             m_appNotifies.insert(start + i, item);
         }
         endInsertRows();
+
+        if (entities.size() >= PageSize)
+            m_partialApps.insert(appName);
     }
 }
 
@@ -94,6 +105,7 @@ void NotifyModel::collapseApp(int row)
         return;
 
     const auto appName = notify->appName();
+    m_partialApps.remove(appName);
 
     QList<AppNotifyItem *> notifies;
     for (int i = row; i < m_appNotifies.size(); i++) {
@@ -137,6 +149,7 @@ void NotifyModel::close()
     beginResetModel();
     qDeleteAll(m_appNotifies);
     m_appNotifies.clear();
+    m_partialApps.clear();
     endResetModel();
 }
 
@@ -144,34 +157,33 @@ void NotifyModel::open()
 {
     qDebug(notifyLog) << "Open";
 
-    auto apps = fetchLastApps();
-    for (auto appName : apps) {
-        const auto tmp = m_accessor->fetchEntities(appName, 3);
-        if (tmp.isEmpty())
-            continue;
+    const auto summaries = fetchLastApps();
+    if (summaries.isEmpty())
+        return;
 
-        const auto &entity = tmp.first();
-        Q_ASSERT(entity.isValid());
+    const int start = m_appNotifies.size();
+    beginInsertRows(QModelIndex(), start, start + summaries.size() - 1);
+    for (const auto &summary : summaries) {
+        m_appNotifies.append(createAppNotify(summary));
+    }
+    endInsertRows();
+}
 
-        if (tmp.size() >= 2) {
-            // add overlap
-            qDebug(notifyLog) << "Add ovelay for the notify" << entity.id();
+AppNotifyItem *NotifyModel::createAppNotify(const AppEntitySummary &summary) const
+{
+    const auto &entity = summary.lastEntity;
+    Q_ASSERT(entity.isValid());
 
-            const int start = m_appNotifies.size();
-            auto overlap = new OverlapAppNotifyItem(entity);
-            overlap->updateCount(tmp.size());
-            beginInsertRows(QModelIndex(), start, start);
-            m_appNotifies.append(overlap);
-            endInsertRows();
-        } else {
-            // add normal
-            const int start = m_appNotifies.size();
-            beginInsertRows(QModelIndex(), start, start);
-            auto notify = new AppNotifyItem(entity);
-            m_appNotifies.append(notify);
-            endInsertRows();
-        }
+    if (summary.count >= 2) {
+        // add overlap
+        qDebug(notifyLog) << "Add ovelay for the notify" << entity.id();
+
+        auto overlap = new OverlapAppNotifyItem(entity);
+        overlap->updateCount(summary.count);
+        return overlap;
     }
+    // add normal
+    return new AppNotifyItem(entity);
 }
 
 void NotifyModel::append(const NotifyEntity &entity)
@@ -271,47 +283,59 @@ void NotifyModel::append(const NotifyEntity &entity)
         endInsertRows();
     }
 
-    if (m_refreshTimer < 0) {
-        m_refreshTimer = startTimer(std::chrono::milliseconds(1000));
-    }
+    scheduleTimeUpdate();
 }
 
-QList<QString> NotifyModel::fetchLastApps(int maxCount) const
+QList<AppEntitySummary> NotifyModel::fetchLastApps() const
 {
-    qDebug(notifyLog) << "Fetch last apps count" << maxCount;
-    QStringList pinnedApps;
-    auto allApps = m_accessor->fetchApps(-1);
-    for (auto item : allApps) {
-        if (m_accessor->applicationPin(item)) {
-            pinnedApps << item;
-            if (maxCount >= 0 && pinnedApps.size() >= maxCount)
-                break;
-        }
-    }
+    qDebug(notifyLog) << "Fetch last apps";
+    // ordered by time already, only pinned apps need to be moved ahead.
+    auto summaries = m_accessor->fetchAppSummaries();
+    std::stable_sort(summaries.begin(), summaries.end(), [this] (
+                                                             const AppEntitySummary &item1,
+                                                             const AppEntitySummary &item2) {
+        const bool item1Pin = m_accessor->applicationPin(item1.lastEntity.appName());
+        const bool item2Pin = m_accessor->applicationPin(item2.lastEntity.appName());
+        if (item1Pin == item2Pin)
+            return item1.lastEntity.cTime() > item2.lastEntity.cTime();
+        return item1Pin;
+    });
+    return summaries;
+}
 
-    QList<NotifyEntity> lastEntities;
-    for (auto item : allApps) {
-        const auto entity = m_accessor->fetchLastEntity(item);
-        if (!entity.isValid())
-            continue;
-        lastEntities << entity;
+void NotifyModel::fetchNextPage(const QString &appName)
+{
+    if (!m_partialApps.contains(appName))
+        return;
+
+    const auto groupIndex = firstNotifyIndex(appName, NotifyType::Group);
+    int last = groupIndex;
+    while (groupIndex >= 0 && last + 1 < m_appNotifies.size()) {
+        const auto item = m_appNotifies[last + 1];
+        if (item->appName() != appName || item->type() != NotifyType::Normal)
+            break;
+        last++;
+    }
+    if (last <= groupIndex) {
+        m_partialApps.remove(appName);
+        return;
     }
 
-    std::sort(lastEntities.begin(), lastEntities.end(), [this] (
-                                                            const NotifyEntity &item1,
-                                                            const NotifyEntity &item2) {
-        return greaterNotify(item1, item2);
-    });
+    // keyset pagination, the last loaded notify of the group is the cursor.
+    const auto entities = m_accessor->fetchEntities(appName, m_appNotifies[last]->entity(), PageSize);
+    if (entities.size() < PageSize)
+        m_partialApps.remove(appName);
+    if (entities.isEmpty())
+        return;
 
-    QStringList ret;
-    for (int i = 0; i < lastEntities.size(); i++) {
-        const auto entity = lastEntities[i];
-        if (maxCount >= 0 && i >= maxCount)
-            break;
+    qDebug(notifyLog) << "Fetch more notifies for the app" << appName << ", count" << entities.size();
 
-        ret << entity.appName();
+    const auto start = last + 1;
+    beginInsertRows(QModelIndex(), start, start + entities.size() - 1);
+    for (int i = 0; i < entities.size(); i++) {
+        m_appNotifies.insert(start + i, new AppNotifyItem(entities[i]));
     }
-    return ret;
+    endInsertRows();
 }
 
 NotifyEntity NotifyModel::greaterNotifyEntity(const AppNotifyItem *notifyItem) const
@@ -526,6 +550,10 @@ void NotifyModel::remove(qint64 id)
             }
         }
 
+        if (row >= 0 && m_partialApps.contains(appName) && notifyCount(appName, NotifyType::Normal) <= 1) {
+            fetchNextPage(appName);
+        }
+
         if (row >= 0 && notifyCount(appName, NotifyType::Normal) <= 1) {
             // group -> remove group && to normal
 
@@ -542,6 +570,7 @@ void NotifyModel::remove(qint64 id)
 void NotifyModel::removeByApp(const QString &appName)
 {
     qDebug(notifyLog) << "Remove all notifies for the app" << appName;
+    m_partialApps.remove(appName);
 
     int row = -1;
     for (int i = 0; i < m_appNotifies.size(); i++) {
@@ -586,6 +615,7 @@ void NotifyModel::clear()
     beginResetModel();
     qDeleteAll(m_appNotifies);
     m_appNotifies.clear();
+    m_partialApps.clear();
     endResetModel();
 
     m_accessor->clear();
@@ -606,34 +636,15 @@ void NotifyModel::expandAllApp()
         existApps << item->appName();
     }
 
-    const auto apps = fetchLastApps();
-    for (auto appName : std::as_const(apps)) {
-        if (existApps.contains(appName))
+    const auto summaries = fetchLastApps();
+    for (const auto &summary : summaries) {
+        if (existApps.contains(summary.lastEntity.appName()))
             continue;
 
-        const auto tmp = m_accessor->fetchEntities(appName, 3);
-
-        auto entity = tmp.first();
-        Q_ASSERT(entity.isValid());
-
-        if (tmp.size() >= 2) {
-            // add overlap
-            qDebug(notifyLog) << "Add ovelay for the notify" << entity.id();
-
-            const int start = m_appNotifies.size();
-            auto overlap = new OverlapAppNotifyItem(entity);
-            overlap->updateCount(tmp.size());
-            beginInsertRows(QModelIndex(), start, start);
-            m_appNotifies.append(overlap);
-            endInsertRows();
-        } else {
-            // add normal
-            const int start = m_appNotifies.size();
-            beginInsertRows(QModelIndex(), start, start);
-            auto notify = new AppNotifyItem(entity);
-            m_appNotifies.append(notify);
-            endInsertRows();
-        }
+        const int start = m_appNotifies.size();
+        beginInsertRows(QModelIndex(), start, start);
+        m_appNotifies.append(createAppNotify(summary));
+        endInsertRows();
     }
 }
 
@@ -677,6 +688,46 @@ int NotifyModel::rowCount(const QModelIndex &parent) const
     return m_appNotifies.size();
 }
 
+// the model is flat, the view only asks for more rows at the end of the list,
+// which belong to the last group, the groups above page through fetchMoreApp.
+bool NotifyModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (parent.isValid() || m_appNotifies.isEmpty())
+        return false;
+    return m_partialApps.contains(m_appNotifies.last()->appName());
+}
+
+void NotifyModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.isValid() || m_appNotifies.isEmpty())
+        return;
+
+    fetchNextPage(m_appNotifies.last()->appName());
+}
+
+void NotifyModel::fetchMoreApp(int row)
+{
+    if (row < 0 || row >= m_appNotifies.size())
+        return;
+
+    const auto item = m_appNotifies[row];
+    const auto appName = item->appName();
+    if (item->type() != NotifyType::Normal || !m_partialApps.contains(appName))
+        return;
+
+    // only the last loaded notify of the group is the cursor of the next page.
+    if (row + 1 < m_appNotifies.size()) {
+        const auto next = m_appNotifies[row + 1];
+        if (next->appName() == appName && next->type() == NotifyType::Normal)
+            return;
+    }
+
+    // it's called while the view creates the delegate, rows can't be inserted meanwhile.
+    QMetaObject::invokeMethod(this, [this, appName]() {
+        fetchNextPage(appName);
+    }, Qt::QueuedConnection);
+}
+
 QVariant NotifyModel::data(const QModelIndex &index, int role) const
 {
     int row = index.row();
@@ -749,14 +800,47 @@ int NotifyModel::firstNotifyIndex(const QString &appName, const NotifyType &type
 
 void NotifyModel::updateTime()
 {
-    if (m_appNotifies.isEmpty())
-        return;
+    // only the rows whose text changes are notified, in contiguous ranges.
+    const auto now = QDateTime::currentMSecsSinceEpoch();
+    int first = -1;
+    for (int i = 0; i <= m_appNotifies.size(); i++) {
+        bool changed = false;
+        if (i < m_appNotifies.size()) {
+            auto item = m_appNotifies[i];
+            const auto next = item->nextTimeUpdate();
+            if (next > 0 && next <= now) {
+                const auto old = item->time();
+                item->updateTime();
+                changed = item->time() != old;
+            }
+        }
+        if (changed && first < 0) {
+            first = i;
+        } else if (!changed && first >= 0) {
+            dataChanged(index(first), index(i - 1), {NotifyTime});
+            first = -1;
+        }
+    }
+
+    scheduleTimeUpdate();
+}
 
-    QList<AppNotifyItem *> tmp = m_appNotifies;
-    for (auto item : tmp) {
-        item->updateTime();
+void NotifyModel::scheduleTimeUpdate()
+{
+    qint64 next = 0;
+    for (auto item : std::as_const(m_appNotifies)) {
+        const auto time = item->nextTimeUpdate();
+        if (time > 0 && (next <= 0 || time < next))
+            next = time;
+    }
+
+    if (next <= 0) {
+        TimeTicker::instance()->cancel(this);
+        return;
     }
-    dataChanged(index(0), index(rowCount(QModelIndex()) - 1), {NotifyTime});
+    TimeTicker::instance()->schedule(this, next, [this]() {
+        updateTime();
+    });
 }
 
 QHash<int, QByteArray> NotifyModel::roleNames() const
@@ -779,12 +863,11 @@ QHash<int, QByteArray> NotifyModel::roleNames() const
     return roles;
 }
 
-void NotifyModel::doEntityReceived(qint64 id)
+void NotifyModel::doEntityReceived(const NotifyEntity &entity)
 {
-    qDebug(notifyLog) << "Receive entity" << id;
-    auto entity = m_accessor->fetchEntity(id);
+    qDebug(notifyLog) << "Receive entity" << entity.id();
     if (!entity.isValid()) {
-        qWarning(notifyLog) << "Received invalid entity:" << id << ", appName:" << entity.appName();
+        qWarning(notifyLog) << "Received invalid entity:" << entity.id() << ", appName:" << entity.appName();
         return;
     }
     append(entity);
@@ -812,19 +895,6 @@ int NotifyModel::notifyCount(const QString &appName) const
     return count;
 }
 
-void NotifyModel::timerEvent(QTimerEvent *event)
-{
-    if (event->timerId() == m_refreshTimer) {
-        updateTime();
-
-        if (m_appNotifies.isEmpty()) {
-            killTimer(m_refreshTimer);
-            m_refreshTimer = -1;
-        }
-    }
-    return QAbstractListModel::timerEvent(event);
-}
-
 void NotifyModel::sort(int column, Qt::SortOrder order)
 {
     auto notifies = m_appNotifies;
@@ -6,9 +6,14 @@
 
 #include <QAbstractItemModel>
 #include <QObject>
+#include <QSet>
 #include <QtQml/qqml.h>
 #include "notifyitem.h"
 
+namespace notification {
+struct AppEntitySummary;
+}
+
 namespace notifycenter {
 class NotifyAccessor;
 /**
@@ -43,6 +48,7 @@ public:
 
     Q_INVOKABLE void expandApp(int row);
     Q_INVOKABLE void collapseApp(int row);
+    Q_INVOKABLE void fetchMoreApp(int row);
     Q_INVOKABLE void remove(qint64 id);
     Q_INVOKABLE void removeByApp(const QString &appName);
     Q_INVOKABLE void clear();
@@ -67,13 +73,14 @@ signals:
 
 public:
     virtual int rowCount(const QModelIndex &parent) const override;
+    virtual bool canFetchMore(const QModelIndex &parent) const override;
+    virtual void fetchMore(const QModelIndex &parent) override;
     virtual QVariant data(const QModelIndex &index, int role) const override;
     virtual QHash<int, QByteArray> roleNames() const override;
-    virtual void timerEvent(QTimerEvent *event) override;
     virtual void sort(int column, Qt::SortOrder order) override;
 
 private slots:
-    void doEntityReceived(qint64 id);
+    void doEntityReceived(const NotifyEntity &entity);
     void onCountChanged();
 
 private:
@@ -83,8 +90,11 @@ private:
     int firstNotifyIndex(const QString &appName, const NotifyType &type) const;
 
     void updateTime();
+    void scheduleTimeUpdate();
     void append(const NotifyEntity &entity);
-    QList<QString> fetchLastApps(int maxCount = -1) const;
+    AppNotifyItem *createAppNotify(const AppEntitySummary &summary) const;
+    QList<AppEntitySummary> fetchLastApps() const;
+    void fetchNextPage(const QString &appName);
     NotifyEntity greaterNotifyEntity(const AppNotifyItem *notifyItem) const;
     bool greaterNotify(const AppNotifyItem *item1, const AppNotifyItem *item2) const;
     bool greaterNotify(const NotifyEntity &item1, const NotifyEntity &item2) const;
@@ -98,8 +108,9 @@ private:
 
 private:
     QList<AppNotifyItem *> m_appNotifies;
+    // expanded apps whose older notifies are still in the database.
+    QSet<QString> m_partialApps;
     QPointer<NotifyAccessor> m_accessor;
-    int m_refreshTimer = -1;
     bool m_collapse = false;
     int m_contentRowCount = 6;
 };
@@ -4,7 +4,7 @@
 
 #include "notifystagingmodel.h"
 
-#include <QTimerEvent>
+#include <QDateTime>
 #include <QLoggingCategory>
 
 #include "dataaccessorproxy.h"
@@ -12,6 +12,7 @@
 #include "notifyentity.h"
 #include "notifyitem.h"
 #include "notifysetting.h"
+#include "timeticker.h"
 
 namespace notification {
 Q_DECLARE_LOGGING_CATEGORY(notifyLog)
@@ -25,6 +26,8 @@ NotifyStagingModel::NotifyStagingModel(QObject *parent)
     connect(NotifyAccessor::instance(), &NotifyAccessor::stagingEntityReceived, this, &NotifyStagingModel::doEntityReceived);
     connect(NotifyAccessor::instance(), &NotifyAccessor::stagingEntityClosed, this, &NotifyStagingModel::onEntityClosed);
     connect(NotifySetting::instance(), &NotifySetting::contentRowCountChanged, this, &NotifyStagingModel::updateContentRowCount);
+    connect(this, &NotifyStagingModel::rowsInserted, this, &NotifyStagingModel::scheduleTimeUpdate);
+    connect(this, &NotifyStagingModel::modelReset, this, &NotifyStagingModel::scheduleTimeUpdate);
 }
 
 void NotifyStagingModel::close()
@@ -62,10 +65,6 @@ void NotifyStagingModel::push(const NotifyEntity &entity)
         auto count = m_accessor->fetchEntityCount(DataAccessor::AllApp(), NotifyEntity::NotProcessed);
         updateOverlapCount(count);
     }
-
-    if (m_refreshTimer < 0) {
-        m_refreshTimer = startTimer(std::chrono::milliseconds(1000));
-    }
 }
 
 void NotifyStagingModel::closeNotify(qint64 id, int reason)
@@ -222,14 +221,47 @@ QVariant NotifyStagingModel::data(const QModelIndex &index, int role) const
 
 void NotifyStagingModel::updateTime()
 {
-    if (m_appNotifies.isEmpty())
-        return;
+    // only the rows whose text changes are notified, in contiguous ranges.
+    const auto now = QDateTime::currentMSecsSinceEpoch();
+    int first = -1;
+    for (int i = 0; i <= m_appNotifies.size(); i++) {
+        bool changed = false;
+        if (i < m_appNotifies.size()) {
+            auto item = m_appNotifies[i];
+            const auto next = item->nextTimeUpdate();
+            if (next > 0 && next <= now) {
+                const auto old = item->time();
+                item->updateTime();
+                changed = item->time() != old;
+            }
+        }
+        if (changed && first < 0) {
+            first = i;
+        } else if (!changed && first >= 0) {
+            dataChanged(index(first), index(i - 1), {NotifyTime});
+            first = -1;
+        }
+    }
+
+    scheduleTimeUpdate();
+}
+
+void NotifyStagingModel::scheduleTimeUpdate()
+{
+    qint64 next = 0;
+    for (auto item : std::as_const(m_appNotifies)) {
+        const auto time = item->nextTimeUpdate();
+        if (time > 0 && (next <= 0 || time < next))
+            next = time;
+    }
 
-    QList<AppNotifyItem *> tmp = m_appNotifies;
-    for (auto item : tmp) {
-        item->updateTime();
+    if (next <= 0) {
+        TimeTicker::instance()->cancel(this);
+        return;
     }
-    dataChanged(index(0), index(rowCount(QModelIndex()) - 1), {NotifyTime});
+    TimeTicker::instance()->schedule(this, next, [this]() {
+        updateTime();
+    });
 }
 
 NotifyEntity NotifyStagingModel::notifyById(qint64 id) const
@@ -274,46 +306,30 @@ QHash<int, QByteArray> NotifyStagingModel::roleNames() const
     return roles;
 }
 
-void NotifyStagingModel::timerEvent(QTimerEvent *event)
-{
-    if (event->timerId() == m_refreshTimer) {
-        updateTime();
-
-        if (m_appNotifies.isEmpty()) {
-            killTimer(m_refreshTimer);
-            m_refreshTimer = -1;
-        }
-    }
-    return QAbstractListModel::timerEvent(event);
-}
-
 int NotifyStagingModel::overlapCount() const
 {
     return m_overlapCount;
 }
 
-void NotifyStagingModel::doEntityReceived(qint64 id)
+void NotifyStagingModel::doEntityReceived(const NotifyEntity &entity)
 {
-    qDebug(notifyLog) << "Receive entity" << id;
-    auto entity = m_accessor->fetchEntity(id);
+    qDebug(notifyLog) << "Receive entity" << entity.id();
     if (!entity.isValid()) {
-        qWarning(notifyLog) << "Received invalid entity:" << id << ", appName:" << entity.appName();
+        qWarning(notifyLog) << "Received invalid entity:" << entity.id() << ", appName:" << entity.appName();
         return;
     }
-    if (entity.isReplace() && notifyById(id).isValid()) {
+    if (entity.isReplace() && notifyById(entity.id()).isValid()) {
         replace(entity);
     } else {
         push(entity);
     }
 }
 
-void NotifyStagingModel::onEntityClosed(qint64 id)
+void NotifyStagingModel::onEntityClosed(const NotifyEntity &entity)
 {
-    auto entity = m_accessor->fetchEntity(id);
     if (!entity.isValid())
         return;
-    id = entity.bubbleId();
-    remove(id);
+    remove(entity.bubbleId());
 }
 
 void NotifyStagingModel::updateOverlapCount(int count)
@@ -48,7 +48,6 @@ public:
     virtual int rowCount(const QModelIndex &parent) const override;
     virtual QVariant data(const QModelIndex &index, int role) const override;
     virtual QHash<int, QByteArray> roleNames() const override;
-    virtual void timerEvent(QTimerEvent *event) override;
 
     int overlapCount() const;
     void updateOverlapCount(int count);
@@ -57,19 +56,19 @@ public:
 private slots:
     void push(const NotifyEntity &entity);
     void replace(const NotifyEntity &entity);
-    void doEntityReceived(qint64 id);
-    void onEntityClosed(qint64 id);
+    void doEntityReceived(const NotifyEntity &entity);
+    void onEntityClosed(const NotifyEntity &entity);
 
 private:
     void remove(qint64 id);
     void updateTime();
+    void scheduleTimeUpdate();
     NotifyEntity notifyById(qint64 id) const;
 
 private:
     QList<AppNotifyItem *> m_appNotifies;
     const int BubbleMaxCount{3};
     const int OverlayMaxCount{2};
-    int m_refreshTimer = -1;
     DataAccessor *m_accessor = nullptr;
     int m_overlapCount = 0;
     int m_contentRowCount = 6;
@@ -0,0 +1,84 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dataaccessor.h"
+
+#include <QPair>
+
+#include <algorithm>
+
+namespace notification {
+
+// about the length of the 24 tokens a FTS5 snippet keeps.
+static const int SnippetLength = 64;
+static const int SnippetLeading = 16;
+static const QString SnippetEllipsis = QStringLiteral("...");
+
+static QList<QPair<qsizetype, qsizetype>> matchedRanges(const QString &text, const QStringList &terms)
+{
+    QList<QPair<qsizetype, qsizetype>> ranges;
+    for (const auto &term : terms) {
+        for (auto pos = text.indexOf(term, 0, Qt::CaseInsensitive); pos >= 0;
+             pos = text.indexOf(term, pos + term.size(), Qt::CaseInsensitive)) {
+            ranges.append({pos, pos + term.size()});
+        }
+    }
+    std::sort(ranges.begin(), ranges.end());
+
+    // overlapping matches of different terms are marked once.
+    QList<QPair<qsizetype, qsizetype>> merged;
+    for (const auto &range : std::as_const(ranges)) {
+        if (!merged.isEmpty() && range.first <= merged.last().second) {
+            merged.last().second = std::max(merged.last().second, range.second);
+        } else {
+            merged.append(range);
+        }
+    }
+    return merged;
+}
+
+QString DataAccessor::searchSnippet(const NotifyEntity &entity, const QStringList &terms)
+{
+    // like FTS5, the column with the most matches is used, in the order of the index columns.
+    const QStringList columns {entity.summary(), entity.body(), entity.appName()};
+    QString text;
+    QList<QPair<qsizetype, qsizetype>> ranges;
+    for (const auto &column : columns) {
+        auto columnRanges = matchedRanges(column, terms);
+        if (columnRanges.size() > ranges.size()) {
+            text = column;
+            ranges = std::move(columnRanges);
+        }
+    }
+    if (ranges.isEmpty())
+        return entity.body();
+
+    qsizetype start = 0;
+    qsizetype end = text.size();
+    if (text.size() > SnippetLength) {
+        start = std::max<qsizetype>(0, ranges.first().first - SnippetLeading);
+        end = std::min<qsizetype>(text.size(), start + SnippetLength);
+        start = std::max<qsizetype>(0, end - SnippetLength);
+    }
+
+    QString snippet;
+    if (start > 0)
+        snippet += SnippetEllipsis;
+    qsizetype pos = start;
+    for (const auto &range : std::as_const(ranges)) {
+        const auto first = std::max(range.first, start);
+        const auto last = std::min(range.second, end);
+        if (first >= last)
+            continue;
+        snippet += text.mid(pos, first - pos);
+        snippet += QStringLiteral("<b>") + text.mid(first, last - first) + QStringLiteral("</b>");
+        pos = last;
+    }
+    snippet += text.mid(pos, end - pos);
+    if (end < text.size())
+        snippet += SnippetEllipsis;
+    return snippet;
+}
+
+}
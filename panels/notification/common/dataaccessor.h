@@ -6,11 +6,30 @@
 
 #include <QList>
 #include <QString>
+#include <QStringList>
 
 #include "notifyentity.h"
 
 namespace notification {
 
+/**
+ * @brief Last entity and entity count of an app, fetched for all apps at once.
+ */
+struct AppEntitySummary
+{
+    NotifyEntity lastEntity;
+    int count = 0;
+};
+
+/**
+ * @brief Entity matched by a full text search, `snippet` marks the matched terms with <b></b>.
+ */
+struct NotifySearchHit
+{
+    NotifyEntity entity;
+    QString snippet;
+};
+
 class DataAccessor
 {
 public:
@@ -31,6 +50,26 @@ public:
 
     virtual void updateEntityProcessedType(qint64 id, int processedType) { Q_UNUSED(id); Q_UNUSED(processedType); }
 
+    // batch operations, implementations run them in one transaction.
+    virtual QList<qint64> addEntities(const QList<NotifyEntity> &entities)
+    {
+        QList<qint64> ret;
+        ret.reserve(entities.size());
+        for (const auto &entity : entities)
+            ret << addEntity(entity);
+        return ret;
+    }
+    virtual void updateEntityProcessedTypes(const QList<qint64> &ids, int processedType)
+    {
+        for (const auto id : ids)
+            updateEntityProcessedType(id, processedType);
+    }
+    virtual void removeEntities(const QList<qint64> &ids)
+    {
+        for (const auto id : ids)
+            removeEntity(id);
+    }
+
     virtual NotifyEntity fetchEntity(qint64 id) { Q_UNUSED(id); return {}; }
     virtual int fetchEntityCount(const QString &appName, int processedType) const { Q_UNUSED(appName); Q_UNUSED(processedType); return 0; }
     virtual NotifyEntity fetchLastEntity(const QString &appName, int processedType) { Q_UNUSED(appName); Q_UNUSED(processedType); return {}; }
@@ -42,11 +81,36 @@ public:
         Q_UNUSED(maxCount)
         return {};
     }
+    // keyset pagination, fetch entities older than (lastCTime, lastId) ordered by (CTime, ID) descending.
+    virtual QList<NotifyEntity> fetchEntities(const QString &appName, int processedType, qint64 lastCTime, qint64 lastId, int maxCount)
+    {
+        Q_UNUSED(appName)
+        Q_UNUSED(processedType);
+        Q_UNUSED(lastCTime);
+        Q_UNUSED(lastId);
+        Q_UNUSED(maxCount)
+        return {};
+    }
+    // ids of the entities, the batch operations take them without fetching the whole entities.
+    virtual QList<qint64> fetchEntityIds(const QString &appName, int processedType) const { Q_UNUSED(appName); Q_UNUSED(processedType); return {}; }
+    virtual QList<AppEntitySummary> fetchAppSummaries(int processedType) { Q_UNUSED(processedType); return {}; }
     virtual QList<QString> fetchApps(int maxCount) const { Q_UNUSED(maxCount); return {}; }
+    // full text search on summary, body and app name, hits are ordered by relevance.
+    virtual QList<NotifySearchHit> searchEntities(const QString &text, int processedType, int offset, int maxCount)
+    {
+        Q_UNUSED(text);
+        Q_UNUSED(processedType);
+        Q_UNUSED(offset);
+        Q_UNUSED(maxCount);
+        return {};
+    }
 
     virtual void removeEntity(qint64 id) { Q_UNUSED(id); }
     virtual void removeEntityByApp(const QString &appName) { Q_UNUSED(appName); }
     virtual void clear() {}
+    // the snippet of a hit matched without the full text index, it's marked like the one of FTS5.
+    static QString searchSnippet(const NotifyEntity &entity, const QStringList &terms);
+
     inline static QString AllApp()
     {
         return QLatin1String("AllApp");
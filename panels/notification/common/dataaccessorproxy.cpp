@@ -6,6 +6,7 @@
 #include "memoryaccessor.h"
 
 #include <QDebug>
+#include <QHash>
 
 namespace notification
 {
@@ -61,14 +62,7 @@ void DataAccessorProxy::updateEntityProcessedType(qint64 id, int processedType)
 {
     if (routerToSource(id, processedType)) {
         m_impl->updateEntityProcessedType(id, processedType);
-        if (m_source && m_source->isValid()) {
-            auto entity = m_impl->fetchEntity(id);
-            const auto sId = m_source->addEntity(entity);
-            if (sId > 0) {
-                m_impl->removeEntity(id);
-                entity.setId(sId);
-            }
-        }
+        moveToSource({id});
         return;
     }
     if (m_source && m_source->isValid()) {
@@ -77,6 +71,109 @@ void DataAccessorProxy::updateEntityProcessedType(qint64 id, int processedType)
     return m_impl->updateEntityProcessedType(id, processedType);
 }
 
+QList<qint64> DataAccessorProxy::addEntities(const QList<NotifyEntity> &entities)
+{
+    if (!m_source || !m_source->isValid()) {
+        return m_impl->addEntities(entities);
+    }
+
+    QList<NotifyEntity> memoryEntities;
+    QList<NotifyEntity> sourceEntities;
+    for (const auto &entity : entities) {
+        if (entity.processedType() == NotifyEntity::NotProcessed) {
+            memoryEntities << entity;
+        } else {
+            sourceEntities << entity;
+        }
+    }
+    const auto memoryIds = m_impl->addEntities(memoryEntities);
+    const auto sourceIds = m_source->addEntities(sourceEntities);
+
+    // keep the ids in the order of entities.
+    QList<qint64> ret;
+    ret.reserve(entities.size());
+    int memoryIndex = 0;
+    int sourceIndex = 0;
+    for (const auto &entity : entities) {
+        if (entity.processedType() == NotifyEntity::NotProcessed) {
+            ret << memoryIds.value(memoryIndex++, -1);
+        } else {
+            ret << sourceIds.value(sourceIndex++, -1);
+        }
+    }
+    return ret;
+}
+
+void DataAccessorProxy::updateEntityProcessedTypes(const QList<qint64> &ids, int processedType)
+{
+    processEntities(ids, processedType);
+}
+
+QList<qint64> DataAccessorProxy::processEntities(const QList<qint64> &ids, int processedType)
+{
+    QList<qint64> memoryIds;
+    QList<qint64> sourceIds;
+    for (const auto id : ids) {
+        if (routerToSource(id, processedType)) {
+            memoryIds << id;
+        } else {
+            sourceIds << id;
+        }
+    }
+
+    QHash<qint64, qint64> movedIds;
+    if (!memoryIds.isEmpty()) {
+        m_impl->updateEntityProcessedTypes(memoryIds, processedType);
+        const auto newIds = moveToSource(memoryIds);
+        for (int i = 0; i < memoryIds.size(); i++) {
+            if (newIds.value(i, -1) > 0)
+                movedIds.insert(memoryIds[i], newIds[i]);
+        }
+    }
+    if (!sourceIds.isEmpty()) {
+        if (m_source && m_source->isValid()) {
+            m_source->updateEntityProcessedTypes(sourceIds, processedType);
+        } else {
+            m_impl->updateEntityProcessedTypes(sourceIds, processedType);
+        }
+    }
+
+    QList<qint64> ret;
+    ret.reserve(ids.size());
+    for (const auto id : ids)
+        ret << movedIds.value(id, id);
+    return ret;
+}
+
+QList<qint64> DataAccessorProxy::moveToSource(const QList<qint64> &ids)
+{
+    if (!m_source || !m_source->isValid())
+        return ids;
+
+    QList<NotifyEntity> entities;
+    QList<int> indexes;
+    entities.reserve(ids.size());
+    for (int i = 0; i < ids.size(); i++) {
+        const auto entity = m_impl->fetchEntity(ids[i]);
+        if (!entity.isValid())
+            continue;
+        entities << entity;
+        indexes << i;
+    }
+
+    const auto sourceIds = m_source->addEntities(entities);
+    QList<qint64> moved;
+    QList<qint64> ret(ids.size(), -1);
+    for (int i = 0; i < entities.size(); i++) {
+        const auto sId = sourceIds.value(i, -1);
+        if (sId > 0)
+            moved << entities[i].id();
+        ret[indexes[i]] = sId;
+    }
+    m_impl->removeEntities(moved);
+    return ret;
+}
+
 NotifyEntity DataAccessorProxy::fetchEntity(qint64 id)
 {
     auto entity = m_impl->fetchEntity(id);
@@ -134,6 +231,39 @@ QList<NotifyEntity> DataAccessorProxy::fetchEntities(const QString &appName, int
     return m_impl->fetchEntities(appName, processedType, maxCount);
 }
 
+QList<NotifyEntity> DataAccessorProxy::fetchEntities(const QString &appName, int processedType, qint64 lastCTime, qint64 lastId, int maxCount)
+{
+    if (processedType == NotifyEntity::NotProcessed) {
+        return m_impl->fetchEntities(appName, processedType, lastCTime, lastId, maxCount);
+    }
+    if (m_source && m_source->isValid()) {
+        return m_source->fetchEntities(appName, processedType, lastCTime, lastId, maxCount);
+    }
+    return m_impl->fetchEntities(appName, processedType, lastCTime, lastId, maxCount);
+}
+
+QList<qint64> DataAccessorProxy::fetchEntityIds(const QString &appName, int processedType) const
+{
+    if (processedType == NotifyEntity::NotProcessed) {
+        return m_impl->fetchEntityIds(appName, processedType);
+    }
+    if (m_source && m_source->isValid()) {
+        return m_source->fetchEntityIds(appName, processedType);
+    }
+    return m_impl->fetchEntityIds(appName, processedType);
+}
+
+QList<AppEntitySummary> DataAccessorProxy::fetchAppSummaries(int processedType)
+{
+    if (processedType == NotifyEntity::NotProcessed) {
+        return m_impl->fetchAppSummaries(processedType);
+    }
+    if (m_source && m_source->isValid()) {
+        return m_source->fetchAppSummaries(processedType);
+    }
+    return m_impl->fetchAppSummaries(processedType);
+}
+
 QList<QString> DataAccessorProxy::fetchApps(int maxCount) const
 {
     if (m_source && m_source->isValid()) {
@@ -142,15 +272,63 @@ QList<QString> DataAccessorProxy::fetchApps(int maxCount) const
     return m_impl->fetchApps(maxCount);
 }
 
+QList<NotifySearchHit> DataAccessorProxy::searchEntities(const QString &text, int processedType, int offset, int maxCount)
+{
+    if (processedType == NotifyEntity::NotProcessed) {
+        return m_impl->searchEntities(text, processedType, offset, maxCount);
+    }
+    if (m_source && m_source->isValid()) {
+        return m_source->searchEntities(text, processedType, offset, maxCount);
+    }
+    return m_impl->searchEntities(text, processedType, offset, maxCount);
+}
+
 void DataAccessorProxy::removeEntity(qint64 id)
 {
-    m_impl->removeEntity(id);
+    if (m_impl->fetchEntity(id).isValid()) {
+        m_impl->removeEntity(id);
+        return;
+    }
 
     if (m_source && m_source->isValid()) {
         m_source->removeEntity(id);
     }
 }
 
+void DataAccessorProxy::removeEntities(const QList<qint64> &ids)
+{
+    QList<qint64> memoryIds;
+    QList<qint64> sourceIds;
+    for (const auto id : ids) {
+        if (m_impl->fetchEntity(id).isValid()) {
+            memoryIds << id;
+        } else {
+            sourceIds << id;
+        }
+    }
+
+    if (!memoryIds.isEmpty())
+        m_impl->removeEntities(memoryIds);
+
+    if (!sourceIds.isEmpty() && m_source && m_source->isValid()) {
+        m_source->removeEntities(sourceIds);
+    }
+}
+
+void DataAccessorProxy::removeEntities(const QList<qint64> &ids, int processedType)
+{
+    if (ids.isEmpty())
+        return;
+
+    if (processedType == NotifyEntity::NotProcessed) {
+        return m_impl->removeEntities(ids);
+    }
+    if (m_source && m_source->isValid()) {
+        return m_source->removeEntities(ids);
+    }
+    return m_impl->removeEntities(ids);
+}
+
 void DataAccessorProxy::removeEntityByApp(const QString &appName)
 {
     m_impl->removeEntityByApp(appName);
@@ -20,11 +20,17 @@ public:
     ~DataAccessorProxy() override;
 
     void setSource(DataAccessor *source);
+    // moves the entities from memory to the source, returns their ids in the source.
+    QList<qint64> moveToSource(const QList<qint64> &ids);
+    // updates the processed type, returns the ids after updating, an entity moved to the source gets a new id.
+    QList<qint64> processEntities(const QList<qint64> &ids, int processedType);
 
     virtual qint64 addEntity(const NotifyEntity &entity) override;
     virtual qint64 replaceEntity(qint64 id, const NotifyEntity &entity) override;
 
     virtual void updateEntityProcessedType(qint64 id, int processedType) override;
+    virtual QList<qint64> addEntities(const QList<NotifyEntity> &entities) override;
+    virtual void updateEntityProcessedTypes(const QList<qint64> &ids, int processedType) override;
 
     virtual NotifyEntity fetchEntity(qint64 id) override;
 
@@ -32,9 +38,18 @@ public:
     virtual NotifyEntity fetchLastEntity(const QString &appName, int processedType) override;
     virtual NotifyEntity fetchLastEntity(uint notifyId) override;
     virtual QList<NotifyEntity> fetchEntities(const QString &appName, int processedType, int maxCount) override;
+    virtual QList<NotifyEntity> fetchEntities(const QString &appName, int processedType, qint64 lastCTime, qint64 lastId, int maxCount) override;
+    virtual QList<qint64> fetchEntityIds(const QString &appName, int processedType) const override;
+    virtual QList<AppEntitySummary> fetchAppSummaries(int processedType) override;
     virtual QList<QString> fetchApps(int maxCount) const override;
+    virtual QList<NotifySearchHit> searchEntities(const QString &text, int processedType, int offset, int maxCount) override;
 
+    // an id is removed from where `fetchEntity` finds it, the ids of the memory are bubble ids,
+    // the ids of the source are its own, they may be equal.
     virtual void removeEntity(qint64 id) override;
+    virtual void removeEntities(const QList<qint64> &ids) override;
+    // removes the ids got by `fetchEntityIds(appName, processedType)`, only from the accessor storing `processedType`.
+    void removeEntities(const QList<qint64> &ids, int processedType);
     virtual void removeEntityByApp(const QString &appName) override;
     virtual void clear() override;
 
@@ -16,6 +16,8 @@
 #include <QSqlRecord>
 #include <QStandardPaths>
 
+#include <algorithm>
+
 namespace notification {
 Q_DECLARE_LOGGING_CATEGORY(notifyLog)
 }
@@ -24,6 +26,7 @@ Q_LOGGING_CATEGORY(notifyDBLog, "dde.shell.notification.db", QtMsgType::QtWarnin
 
 static const QString TableName = "notifications";
 static const QString TableName_v2 = "notifications2";
+static const QString SearchTableName = "notifications2_fts";
 static const QString ColumnId = "ID";
 static const QString ColumnIcon = "Icon";
 static const QString ColumnSummary = "Summary";
@@ -109,6 +112,23 @@ private:
 #define BENCHMARK() \
     Benchmark __benchmark__(__FUNCTION__);
 
+// trigram matches substrings and doesn't depend on word boundaries, it's preferred for CJK text.
+static const QString TrigramTokenizer = "trigram";
+static const QString WordTokenizer = "unicode61 remove_diacritics 2";
+// a common term matches a large part of the history, only its newest matches are ranked.
+static const int SearchWindow = 500;
+
+static QString quotedSearchTerm(QString term)
+{
+    return QString("\"%1\"").arg(term.replace("\"", "\"\""));
+}
+
+static QString escapedLikeTerm(QString term)
+{
+    term.replace("\\", "\\\\").replace("%", "\\%").replace("_", "\\_");
+    return QLatin1Char('%') + term + QLatin1Char('%');
+}
+
 DBAccessor::DBAccessor(const QString &key)
     : m_key(key)
 {
@@ -176,13 +196,8 @@ bool DBAccessor::isValid() const
     return !m_connection.lastError().isValid();
 }
 
-qint64 DBAccessor::addEntity(const NotifyEntity &entity)
+static QString insertEntityCmd()
 {
-    BENCHMARK();
-
-    QMutexLocker locker(&m_mutex);
-    QSqlQuery query(m_connection);
-
     QString columns = QStringList{
             ColumnIcon,
             ColumnSummary,
@@ -201,8 +216,11 @@ qint64 DBAccessor::addEntity(const NotifyEntity &entity)
             .arg(TableName_v2)
             .arg(columns)
             .arg(":icon, :summary, :body, :appName, :appId, :ctime, :action, :hint, :replacesId, :notifyId, :processedType");
+    return sqlCmd;
+}
 
-    query.prepare(sqlCmd);
+static void bindInsertEntity(QSqlQuery &query, const NotifyEntity &entity)
+{
     query.bindValue(":icon", entity.appIcon());
     query.bindValue(":summary", entity.summary());
     query.bindValue(":body", entity.body());
@@ -214,6 +232,17 @@ qint64 DBAccessor::addEntity(const NotifyEntity &entity)
     query.bindValue(":replacesId", entity.replacesId());
     query.bindValue(":notifyId", entity.bubbleId());
     query.bindValue(":processedType", entity.processedType());
+}
+
+qint64 DBAccessor::addEntity(const NotifyEntity &entity)
+{
+    BENCHMARK();
+
+    QMutexLocker locker(&m_mutex);
+    QSqlQuery query(m_connection);
+
+    query.prepare(insertEntityCmd());
+    bindInsertEntity(query, entity);
 
     if (!query.exec()) {
         qWarning(notifyDBLog) << "insert value to database failed: " << query.lastError().text() << query.lastQuery() << entity.bubbleId() << entity.cTime();
@@ -228,6 +257,40 @@ qint64 DBAccessor::addEntity(const NotifyEntity &entity)
     return storageId;
 }
 
+QList<qint64> DBAccessor::addEntities(const QList<NotifyEntity> &entities)
+{
+    BENCHMARK();
+
+    QMutexLocker locker(&m_mutex);
+    if (entities.isEmpty())
+        return {};
+
+    m_connection.transaction();
+    QSqlQuery query(m_connection);
+    query.prepare(insertEntityCmd());
+
+    QList<qint64> ret;
+    ret.reserve(entities.size());
+    for (const auto &entity : entities) {
+        bindInsertEntity(query, entity);
+        if (!query.exec()) {
+            qWarning(notifyDBLog) << "insert value to database failed: " << query.lastError().text() << entity.bubbleId() << entity.cTime();
+            ret << -1;
+            continue;
+        }
+        ret << query.lastInsertId().toLongLong();
+    }
+
+    if (!m_connection.commit()) {
+        qWarning(notifyDBLog) << "commit entities to database failed: " << m_connection.lastError().text();
+        m_connection.rollback();
+        return QList<qint64>(entities.size(), -1);
+    }
+
+    qDebug(notifyDBLog) << "Insert entities count:" << entities.size();
+    return ret;
+}
+
 qint64 DBAccessor::replaceEntity(qint64 id, const NotifyEntity &entity)
 {
     BENCHMARK();
@@ -291,6 +354,32 @@ void DBAccessor::updateEntityProcessedType(qint64 id, int processedType)
     }
 }
 
+void DBAccessor::updateEntityProcessedTypes(const QList<qint64> &ids, int processedType)
+{
+    BENCHMARK();
+
+    QMutexLocker locker(&m_mutex);
+    if (ids.isEmpty())
+        return;
+
+    m_connection.transaction();
+    QSqlQuery query(m_connection);
+    QString cmd = QString("UPDATE %1 SET ProcessedType = :processed WHERE ID = :id").arg(TableName_v2);
+    query.prepare(cmd);
+    for (const auto id : ids) {
+        query.bindValue(":id", id);
+        query.bindValue(":processed", processedType);
+        if (!query.exec()) {
+            qWarning(notifyDBLog) << "update processed type execution error:" << query.lastError().text();
+        }
+    }
+
+    if (!m_connection.commit()) {
+        qWarning(notifyDBLog) << "commit processed types failed:" << m_connection.lastError().text();
+        m_connection.rollback();
+    }
+}
+
 NotifyEntity DBAccessor::fetchEntity(qint64 id)
 {
     BENCHMARK();
@@ -348,7 +437,7 @@ NotifyEntity DBAccessor::fetchLastEntity(const QString &appName, int processedTy
     QSqlQuery query(m_connection);
     QString cmd =
         QString(
-            "SELECT %1 FROM notifications2 WHERE AppName = :appName AND (ProcessedType = :processedType OR ProcessedType IS NULL) ORDER BY CTime DESC LIMIT 1")
+            "SELECT %1 FROM notifications2 WHERE AppName = :appName AND (ProcessedType = :processedType OR ProcessedType IS NULL) ORDER BY CTime DESC, ID DESC LIMIT 1")
             .arg(EntityFields.join(","));
     query.prepare(cmd);
     query.bindValue(":appName", appName);
@@ -376,21 +465,21 @@ QList<NotifyEntity> DBAccessor::fetchEntities(const QString &appName, int proces
     QSqlQuery query(m_connection);
     if (appName == DataAccessor::AllApp()) {
         if (maxCount >= 0) {
-            QString cmd = QString("SELECT %1 FROM notifications2 WHERE (ProcessedType = :processedType OR ProcessedType IS NULL) ORDER BY CTime DESC LIMIT :limit").arg(EntityFields.join(","));
+            QString cmd = QString("SELECT %1 FROM notifications2 WHERE (ProcessedType = :processedType OR ProcessedType IS NULL) ORDER BY CTime DESC, ID DESC LIMIT :limit").arg(EntityFields.join(","));
             query.prepare(cmd);
             query.bindValue(":limit", maxCount);
         } else {
-            QString cmd = QString("SELECT %1 FROM notifications2 WHERE (ProcessedType = :processedType OR ProcessedType IS NULL) ORDER BY CTime DESC").arg(EntityFields.join(","));
+            QString cmd = QString("SELECT %1 FROM notifications2 WHERE (ProcessedType = :processedType OR ProcessedType IS NULL) ORDER BY CTime DESC, ID DESC").arg(EntityFields.join(","));
             query.prepare(cmd);
         }
     } else {
         if (maxCount >= 0) {
-            QString cmd = QString("SELECT %1 FROM notifications2 WHERE AppName = :appName AND (ProcessedType = :processedType OR ProcessedType IS NULL) ORDER BY CTime DESC LIMIT :limit").arg(EntityFields.join(","));
+            QString cmd = QString("SELECT %1 FROM notifications2 WHERE AppName = :appName AND (ProcessedType = :processedType OR ProcessedType IS NULL) ORDER BY CTime DESC, ID DESC LIMIT :limit").arg(EntityFields.join(","));
             query.prepare(cmd);
             query.bindValue(":appName", appName);
             query.bindValue(":limit", maxCount);
         } else {
-            QString cmd = QString("SELECT %1 FROM notifications2 WHERE AppName = :appName AND (ProcessedType = :processedType OR ProcessedType IS NULL) ORDER BY CTime DESC").arg(EntityFields.join(","));
+            QString cmd = QString("SELECT %1 FROM notifications2 WHERE AppName = :appName AND (ProcessedType = :processedType OR ProcessedType IS NULL) ORDER BY CTime DESC, ID DESC").arg(EntityFields.join(","));
             query.prepare(cmd);
             query.bindValue(":appName", appName);
         }
@@ -415,6 +504,106 @@ QList<NotifyEntity> DBAccessor::fetchEntities(const QString &appName, int proces
     return ret;
 }
 
+QList<NotifyEntity> DBAccessor::fetchEntities(const QString &appName, int processedType, qint64 lastCTime, qint64 lastId, int maxCount)
+{
+    BENCHMARK();
+
+    QMutexLocker locker(&m_mutex);
+    QSqlQuery query(m_connection);
+    // CTime is stored as TEXT, compare it with the same affinity as `ORDER BY CTime`.
+    if (appName == DataAccessor::AllApp()) {
+        QString cmd = QString("SELECT %1 FROM notifications2 WHERE (ProcessedType = :processedType OR ProcessedType IS NULL) AND (CTime, ID) < (:ctime, :id) ORDER BY CTime DESC, ID DESC LIMIT :limit").arg(EntityFields.join(","));
+        query.prepare(cmd);
+    } else {
+        QString cmd = QString("SELECT %1 FROM notifications2 WHERE AppName = :appName AND (ProcessedType = :processedType OR ProcessedType IS NULL) AND (CTime, ID) < (:ctime, :id) ORDER BY CTime DESC, ID DESC LIMIT :limit").arg(EntityFields.join(","));
+        query.prepare(cmd);
+        query.bindValue(":appName", appName);
+    }
+
+    query.bindValue(":processedType", processedType);
+    query.bindValue(":ctime", QString::number(lastCTime));
+    query.bindValue(":id", lastId);
+    query.bindValue(":limit", maxCount);
+
+    if (!query.exec()) {
+        qWarning(notifyDBLog) << "Query execution error:" << query.lastError().text();
+        return {};
+    }
+
+    QList<NotifyEntity> ret;
+    while (query.next()) {
+        auto entity = parseEntity(query);
+        if (!entity.isValid())
+            continue;
+        ret.append(entity);
+    }
+
+    qDebug(notifyDBLog) << "Fetched entities page size:" << ret.size() << ", after" << lastCTime << lastId;
+    return ret;
+}
+
+QList<qint64> DBAccessor::fetchEntityIds(const QString &appName, int processedType) const
+{
+    BENCHMARK();
+
+    QMutexLocker locker(&m_mutex);
+    QSqlQuery query(m_connection);
+    if (appName == DataAccessor::AllApp()) {
+        QString cmd = QString("SELECT ID FROM notifications2 WHERE (ProcessedType = :processedType OR ProcessedType IS NULL)");
+        query.prepare(cmd);
+    } else {
+        QString cmd = QString("SELECT ID FROM notifications2 WHERE AppName = :appName AND (ProcessedType = :processedType OR ProcessedType IS NULL)");
+        query.prepare(cmd);
+        query.bindValue(":appName", appName);
+    }
+
+    query.bindValue(":processedType", processedType);
+
+    if (!query.exec()) {
+        qWarning(notifyDBLog) << "Query execution error:" << query.lastError().text();
+        return {};
+    }
+
+    QList<qint64> ret;
+    while (query.next())
+        ret.append(query.value(0).toLongLong());
+
+    return ret;
+}
+
+QList<AppEntitySummary> DBAccessor::fetchAppSummaries(int processedType)
+{
+    BENCHMARK();
+
+    QMutexLocker locker(&m_mutex);
+    QSqlQuery query(m_connection);
+    // one pass over the table instead of a `fetchLastEntity` and `fetchEntityCount` per app.
+    QString cmd = QString("SELECT %1, AppCount FROM ("
+                          "SELECT %1, COUNT(*) OVER (PARTITION BY AppName) AS AppCount, "
+                          "ROW_NUMBER() OVER (PARTITION BY AppName ORDER BY CTime DESC, ID DESC) AS AppRow "
+                          "FROM notifications2 WHERE (ProcessedType = :processedType OR ProcessedType IS NULL)) "
+                          "WHERE AppRow = 1 ORDER BY CTime DESC, ID DESC")
+                      .arg(EntityFields.join(","));
+    query.prepare(cmd);
+    query.bindValue(":processedType", processedType);
+
+    if (!query.exec()) {
+        qWarning(notifyDBLog) << "Query execution error:" << query.lastError().text();
+        return {};
+    }
+
+    QList<AppEntitySummary> ret;
+    while (query.next()) {
+        auto entity = parseEntity(query);
+        if (!entity.isValid())
+            continue;
+        ret.append({entity, query.value("AppCount").toInt()});
+    }
+
+    qDebug(notifyDBLog) << "Fetched app summaries count" << ret.size();
+    return ret;
+}
+
 NotifyEntity DBAccessor::fetchLastEntity(uint notifyId)
 {
     BENCHMARK();
@@ -470,6 +659,81 @@ QList<QString> DBAccessor::fetchApps(int maxCount) const
     return ret;
 }
 
+QList<NotifySearchHit> DBAccessor::searchEntities(const QString &text, int processedType, int offset, int maxCount)
+{
+    BENCHMARK();
+
+    const auto terms = text.split(QLatin1Char(' '), Qt::SkipEmptyParts);
+    if (terms.isEmpty())
+        return {};
+
+    QMutexLocker locker(&m_mutex);
+
+    QStringList fields;
+    for (const auto &field : EntityFields)
+        fields << QString("n.%1 AS %1").arg(field);
+
+    // trigram can't match terms shorter than 3 characters, they fall back to scan the table.
+    bool useIndex = !m_searchTokenizer.isEmpty();
+    QStringList matches;
+    for (const auto &term : terms) {
+        if (m_searchTokenizer == TrigramTokenizer) {
+            useIndex = useIndex && term.size() >= 3;
+            matches << quotedSearchTerm(term);
+        } else {
+            matches << quotedSearchTerm(term) + "*";
+        }
+    }
+
+    QSqlQuery query(m_connection);
+    if (useIndex) {
+        // only the newest matches are ranked, ranking every match of a common term and asking the
+        // index for the snippets takes tens of milliseconds, the snippets are marked like the ones of the scan.
+        QString cmd = QString("SELECT %1 FROM ("
+                              "SELECT rowid AS MatchId, bm25(%2, 5.0, 1.0, 2.0) AS Score FROM %2 "
+                              "WHERE %2 MATCH :match ORDER BY rowid DESC LIMIT :window) "
+                              "JOIN %3 n ON n.ID = MatchId "
+                              "WHERE (n.ProcessedType = :processedType OR n.ProcessedType IS NULL) "
+                              "ORDER BY Score, MatchId DESC LIMIT :limit OFFSET :offset")
+                          .arg(fields.join(","), SearchTableName, TableName_v2);
+        query.prepare(cmd);
+        query.bindValue(":match", matches.join(" "));
+        query.bindValue(":window", std::max(SearchWindow, offset + maxCount));
+    } else {
+        QStringList conditions;
+        for (int i = 0; i < terms.size(); i++) {
+            conditions << QString("(n.Summary LIKE :term%1 ESCAPE '\\' OR n.Body LIKE :term%1 ESCAPE '\\' OR n.AppName LIKE :term%1 ESCAPE '\\')").arg(i);
+        }
+        QString cmd = QString("SELECT %1 FROM %2 n "
+                              "WHERE %3 AND (n.ProcessedType = :processedType OR n.ProcessedType IS NULL) "
+                              "ORDER BY n.CTime DESC, n.ID DESC LIMIT :limit OFFSET :offset")
+                          .arg(fields.join(","), TableName_v2, conditions.join(" AND "));
+        query.prepare(cmd);
+        for (int i = 0; i < terms.size(); i++) {
+            query.bindValue(QString(":term%1").arg(i), escapedLikeTerm(terms[i]));
+        }
+    }
+    query.bindValue(":processedType", processedType);
+    query.bindValue(":limit", maxCount);
+    query.bindValue(":offset", offset);
+
+    if (!query.exec()) {
+        qWarning(notifyDBLog) << "Query execution error:" << query.lastError().text();
+        return {};
+    }
+
+    QList<NotifySearchHit> ret;
+    while (query.next()) {
+        auto entity = parseEntity(query);
+        if (!entity.isValid())
+            continue;
+        ret.append({entity, searchSnippet(entity, terms)});
+    }
+
+    qDebug(notifyDBLog) << "Searched entities count:" << ret.size() << ", indexed:" << useIndex;
+    return ret;
+}
+
 void DBAccessor::removeEntity(qint64 id)
 {
     BENCHMARK();
@@ -489,6 +753,33 @@ void DBAccessor::removeEntity(qint64 id)
     qDebug(notifyDBLog) << "Delete notify count" << query.numRowsAffected();
 }
 
+void DBAccessor::removeEntities(const QList<qint64> &ids)
+{
+    BENCHMARK();
+
+    QMutexLocker locker(&m_mutex);
+    if (ids.isEmpty())
+        return;
+
+    m_connection.transaction();
+    QSqlQuery query(m_connection);
+    query.prepare("DELETE FROM notifications2 WHERE ID = :id");
+    for (const auto id : ids) {
+        query.bindValue(":id", id);
+        if (!query.exec()) {
+            qWarning(notifyDBLog) << "Query execution error:" << query.lastError().text();
+        }
+    }
+
+    if (!m_connection.commit()) {
+        qWarning(notifyDBLog) << "commit removing entities failed:" << m_connection.lastError().text();
+        m_connection.rollback();
+        return;
+    }
+
+    qDebug(notifyDBLog) << "Delete notify count" << ids.size();
+}
+
 void DBAccessor::removeEntityByApp(const QString &appName)
 {
     BENCHMARK();
@@ -556,6 +847,21 @@ void DBAccessor::tryToCreateTable()
         qWarning(notifyDBLog) << "create table failed" << query.lastError().text();
     }
 
+    // serves the per app ordering and keyset pagination of the notification center.
+    QString indexSql = QString("CREATE INDEX IF NOT EXISTS %1_app_ctime ON %1(%2, %3 DESC, %4 DESC)")
+            .arg(TableName_v2, ColumnAppName, ColumnCTime, ColumnId);
+    if (!query.exec(indexSql)) {
+        qWarning(notifyDBLog) << "create index failed" << query.lastError().text();
+    }
+    // serves the ordering of all apps, a scan for a short search term stops at the newest matches.
+    indexSql = QString("CREATE INDEX IF NOT EXISTS %1_ctime ON %1(%2 DESC, %3 DESC)")
+            .arg(TableName_v2, ColumnCTime, ColumnId);
+    if (!query.exec(indexSql)) {
+        qWarning(notifyDBLog) << "create index failed" << query.lastError().text();
+    }
+
+    tryToCreateSearchTable();
+
     // add new columns in history
     QMap<QString, QString> newColumns;
     newColumns[ColumnAction] = "TEXT";
@@ -578,6 +884,58 @@ void DBAccessor::tryToCreateTable()
     }
 }
 
+void DBAccessor::tryToCreateSearchTable()
+{
+    QSqlQuery query(m_connection);
+
+    // an existing index keeps the tokenizer it was created with.
+    QString sqlCmd = QString("SELECT sql FROM SQLITE_MASTER WHERE TYPE='table' AND NAME='%1'").arg(SearchTableName);
+    if (query.exec(sqlCmd) && query.next()) {
+        const auto createCmd = query.value(0).toString();
+        m_searchTokenizer = createCmd.contains(TrigramTokenizer) ? TrigramTokenizer : WordTokenizer;
+    } else {
+        for (const auto &tokenizer : {TrigramTokenizer, WordTokenizer}) {
+            sqlCmd = QString("CREATE VIRTUAL TABLE %1 USING fts5(%2, %3, %4, content='%5', content_rowid='%6', tokenize='%7')")
+                         .arg(SearchTableName, ColumnSummary, ColumnBody, ColumnAppName, TableName_v2, ColumnId, tokenizer);
+            if (query.exec(sqlCmd)) {
+                m_searchTokenizer = tokenizer;
+                break;
+            }
+            qDebug(notifyDBLog) << "create search table failed, tokenizer:" << tokenizer << query.lastError().text();
+        }
+        if (m_searchTokenizer.isEmpty()) {
+            qWarning(notifyDBLog) << "FTS5 isn't supported, searching falls back to scan the table.";
+            return;
+        }
+        // index the existing history once.
+        sqlCmd = QString("INSERT INTO %1(%1) VALUES('rebuild')").arg(SearchTableName);
+        if (!query.exec(sqlCmd)) {
+            qWarning(notifyDBLog) << "rebuild search table failed" << query.lastError().text();
+        }
+    }
+
+    // triggers keep the index in sync for every path which changes the text columns.
+    const QString newValues = QString("new.%1, new.%2, new.%3, new.%4").arg(ColumnId, ColumnSummary, ColumnBody, ColumnAppName);
+    const QString oldValues = QString("old.%1, old.%2, old.%3, old.%4").arg(ColumnId, ColumnSummary, ColumnBody, ColumnAppName);
+    const QString insertCmd = QString("INSERT INTO %1(rowid, %2, %3, %4) VALUES (%5);")
+                                  .arg(SearchTableName, ColumnSummary, ColumnBody, ColumnAppName, newValues);
+    const QString deleteCmd = QString("INSERT INTO %1(%1, rowid, %2, %3, %4) VALUES ('delete', %5);")
+                                  .arg(SearchTableName, ColumnSummary, ColumnBody, ColumnAppName, oldValues);
+    const QStringList triggers {
+        QString("CREATE TRIGGER IF NOT EXISTS %1_ai AFTER INSERT ON %2 BEGIN %3 END")
+            .arg(SearchTableName, TableName_v2, insertCmd),
+        QString("CREATE TRIGGER IF NOT EXISTS %1_ad AFTER DELETE ON %2 BEGIN %3 END")
+            .arg(SearchTableName, TableName_v2, deleteCmd),
+        QString("CREATE TRIGGER IF NOT EXISTS %1_au AFTER UPDATE OF %2, %3, %4 ON %5 BEGIN %6 %7 END")
+            .arg(SearchTableName, ColumnSummary, ColumnBody, ColumnAppName, TableName_v2, deleteCmd, insertCmd),
+    };
+    for (const auto &trigger : triggers) {
+        if (!query.exec(trigger)) {
+            qWarning(notifyDBLog) << "create search trigger failed" << query.lastError().text();
+        }
+    }
+}
+
 bool DBAccessor::isAttributeValid(const QString &tableName, const QString &attributeName) const
 {
     QSqlQuery query(m_connection);
@@ -31,20 +31,28 @@ public:
     qint64 addEntity(const NotifyEntity &entity) override;
     qint64 replaceEntity(qint64 id, const NotifyEntity &entity) override;
     void updateEntityProcessedType(qint64 id, int processedType) override;
+    QList<qint64> addEntities(const QList<NotifyEntity> &entities) override;
+    void updateEntityProcessedTypes(const QList<qint64> &ids, int processedType) override;
 
     NotifyEntity fetchEntity(qint64 id) override;
     int fetchEntityCount(const QString &appName, int processedType) const override;
     NotifyEntity fetchLastEntity(const QString &appName, int processedType) override;
     QList<NotifyEntity> fetchEntities(const QString &appName, int processedType, int maxCount) override;
+    QList<NotifyEntity> fetchEntities(const QString &appName, int processedType, qint64 lastCTime, qint64 lastId, int maxCount) override;
+    QList<qint64> fetchEntityIds(const QString &appName, int processedType) const override;
+    QList<AppEntitySummary> fetchAppSummaries(int processedType) override;
     NotifyEntity fetchLastEntity(uint notifyId) override;
     QList<QString> fetchApps(int maxCount) const override;
+    QList<NotifySearchHit> searchEntities(const QString &text, int processedType, int offset, int maxCount) override;
 
     void removeEntity(qint64 id) override;
+    void removeEntities(const QList<qint64> &ids) override;
     void removeEntityByApp(const QString &appName) override;
     void clear() override;
 
 private:
     void tryToCreateTable();
+    void tryToCreateSearchTable();
 
     bool isAttributeValid(const QString &tableName, const QString &attributeName) const;
     bool addAttributeToTable(const QString &tableName, const QString &attributeName, const QString &type) const;
@@ -57,5 +65,7 @@ private:
     mutable QMutex m_mutex;
     QSqlDatabase m_connection;
     QString m_key;
+    // tokenizer of the FTS5 search table, it's empty if FTS5 isn't available.
+    QString m_searchTokenizer;
 };
 }
@@ -3,7 +3,12 @@
 // SPDX-License-Identifier: GPL-3.0-or-later
 
 #include "memoryaccessor.h"
+
+#include <algorithm>
+
 #include <QDebug>
+#include <QHash>
+#include <QSet>
 
 namespace notification
 {
@@ -50,6 +55,28 @@ void MemoryAccessor::updateEntityProcessedType(qint64 id, int processedType)
     }
 }
 
+QList<qint64> MemoryAccessor::addEntities(const QList<NotifyEntity> &entities)
+{
+    QMutexLocker locker(&m_mutex);
+    QList<qint64> ret;
+    ret.reserve(entities.size());
+    for (const auto &entity : entities) {
+        m_entities << entity;
+        ret << entity.bubbleId();
+    }
+    return ret;
+}
+
+void MemoryAccessor::updateEntityProcessedTypes(const QList<qint64> &ids, int processedType)
+{
+    const QSet<qint64> idSet(ids.cbegin(), ids.cend());
+    QMutexLocker locker(&m_mutex);
+    for (auto &entity : m_entities) {
+        if (idSet.contains(entity.id()))
+            entity.setProcessedType(processedType);
+    }
+}
+
 NotifyEntity MemoryAccessor::fetchEntity(qint64 id)
 {
     QMutexLocker locker(&m_mutex);
@@ -114,6 +141,58 @@ QList<NotifyEntity> MemoryAccessor::fetchEntities(const QString &appName, int pr
     return ret;
 }
 
+QList<NotifyEntity> MemoryAccessor::fetchEntities(const QString &appName, int processedType, qint64 lastCTime, qint64 lastId, int maxCount)
+{
+    QMutexLocker locker(&m_mutex);
+    QList<NotifyEntity> ret;
+    for (const auto &item : m_entities) {
+        if ((item.appName() != appName && AllApp() != appName) || item.processedType() != processedType)
+            continue;
+        if (item.cTime() > lastCTime || (item.cTime() == lastCTime && item.id() >= lastId))
+            continue;
+        ret.append(item);
+    }
+    std::sort(ret.begin(), ret.end(), [](const NotifyEntity &item1, const NotifyEntity &item2) {
+        if (item1.cTime() == item2.cTime())
+            return item1.id() > item2.id();
+        return item1.cTime() > item2.cTime();
+    });
+    if (maxCount >= 0 && ret.size() > maxCount)
+        ret.resize(maxCount);
+    return ret;
+}
+
+QList<qint64> MemoryAccessor::fetchEntityIds(const QString &appName, int processedType) const
+{
+    QMutexLocker locker(&m_mutex);
+    QList<qint64> ret;
+    for (const auto &item : m_entities) {
+        if ((item.appName() == appName || AllApp() == appName) && item.processedType() == processedType)
+            ret.append(item.id());
+    }
+    return ret;
+}
+
+QList<AppEntitySummary> MemoryAccessor::fetchAppSummaries(int processedType)
+{
+    QMutexLocker locker(&m_mutex);
+    QList<AppEntitySummary> ret;
+    QHash<QString, qsizetype> indexes;
+    // entities are appended in time order, the first one seen from the back is the last of the app.
+    for (auto iter = m_entities.crbegin(); iter != m_entities.crend(); ++iter) {
+        if (iter->processedType() != processedType)
+            continue;
+        const auto index = indexes.value(iter->appName(), -1);
+        if (index < 0) {
+            indexes[iter->appName()] = ret.size();
+            ret.append({*iter, 1});
+        } else {
+            ret[index].count++;
+        }
+    }
+    return ret;
+}
+
 QList<QString> MemoryAccessor::fetchApps(int maxCount) const
 {
     QMutexLocker locker(&m_mutex);
@@ -128,6 +207,35 @@ QList<QString> MemoryAccessor::fetchApps(int maxCount) const
     return ret;
 }
 
+QList<NotifySearchHit> MemoryAccessor::searchEntities(const QString &text, int processedType, int offset, int maxCount)
+{
+    const auto terms = text.split(QLatin1Char(' '), Qt::SkipEmptyParts);
+    if (terms.isEmpty())
+        return {};
+
+    QMutexLocker locker(&m_mutex);
+    QList<NotifySearchHit> ret;
+    int skipped = 0;
+    // only a handful of entities stay in memory, newest first is good enough as the ranking.
+    for (auto iter = m_entities.crbegin(); iter != m_entities.crend(); ++iter) {
+        if (iter->processedType() != processedType)
+            continue;
+        const bool matched = std::all_of(terms.begin(), terms.end(), [iter](const QString &term) {
+            return iter->summary().contains(term, Qt::CaseInsensitive)
+                || iter->body().contains(term, Qt::CaseInsensitive)
+                || iter->appName().contains(term, Qt::CaseInsensitive);
+        });
+        if (!matched)
+            continue;
+        if (skipped++ < offset)
+            continue;
+        ret.append({*iter, searchSnippet(*iter, terms)});
+        if (maxCount >= 0 && ret.size() >= maxCount)
+            break;
+    }
+    return ret;
+}
+
 void MemoryAccessor::removeEntity(qint64 id)
 {
     QMutexLocker locker(&m_mutex);
@@ -136,6 +244,15 @@ void MemoryAccessor::removeEntity(qint64 id)
     });
 }
 
+void MemoryAccessor::removeEntities(const QList<qint64> &ids)
+{
+    const QSet<qint64> idSet(ids.cbegin(), ids.cend());
+    QMutexLocker locker(&m_mutex);
+    m_entities.removeIf([&idSet](const NotifyEntity &entity) {
+        return idSet.contains(entity.id());
+    });
+}
+
 void MemoryAccessor::removeEntityByApp(const QString &appName)
 {
     QMutexLocker locker(&m_mutex);
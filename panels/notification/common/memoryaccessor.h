@@ -21,6 +21,8 @@ public:
     virtual qint64 replaceEntity(qint64 id, const NotifyEntity &entity) override;
 
     virtual void updateEntityProcessedType(qint64 id, int processedType) override;
+    virtual QList<qint64> addEntities(const QList<NotifyEntity> &entities) override;
+    virtual void updateEntityProcessedTypes(const QList<qint64> &ids, int processedType) override;
 
     virtual NotifyEntity fetchEntity(qint64 id) override;
 
@@ -28,9 +30,14 @@ public:
     virtual NotifyEntity fetchLastEntity(const QString &appName, int processedType) override;
     virtual NotifyEntity fetchLastEntity(uint notifyId) override;
     virtual QList<NotifyEntity> fetchEntities(const QString &appName, int processedType, int maxCount) override;
+    virtual QList<NotifyEntity> fetchEntities(const QString &appName, int processedType, qint64 lastCTime, qint64 lastId, int maxCount) override;
+    virtual QList<qint64> fetchEntityIds(const QString &appName, int processedType) const override;
+    virtual QList<AppEntitySummary> fetchAppSummaries(int processedType) override;
     virtual QList<QString> fetchApps(int maxCount) const override;
+    virtual QList<NotifySearchHit> searchEntities(const QString &text, int processedType, int offset, int maxCount) override;
 
     virtual void removeEntity(qint64 id) override;
+    virtual void removeEntities(const QList<qint64> &ids) override;
     virtual void removeEntityByApp(const QString &appName) override;
     virtual void clear() override;
 
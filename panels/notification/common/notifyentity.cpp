@@ -199,6 +199,11 @@ QVariantMap NotifyEntity::hints() const
     return d->hints;
 }
 
+void NotifyEntity::setHints(const QVariantMap &hints)
+{
+    d->hints = hints;
+}
+
 QString NotifyEntity::hintsString() const
 {
     return convertHintsToString(d->hints);
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <QMetaType>
 #include <QSharedData>
 
 namespace notification {
@@ -71,6 +72,7 @@ public:
     void setActionString(const QString &actionString);
 
     QVariantMap hints() const;
+    void setHints(const QVariantMap &hints);
     QString hintsString() const;
     void setHintString(const QString &hintString);
 
@@ -102,3 +104,4 @@ private:
 
 }
 
+Q_DECLARE_METATYPE(notification::NotifyEntity)
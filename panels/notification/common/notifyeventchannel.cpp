@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "notifyeventchannel.h"
+
+#include <QCoreApplication>
+
+namespace notification {
+
+NotifyEventChannel::NotifyEventChannel(QObject *parent)
+    : QObject(parent)
+{
+    qRegisterMetaType<NotifyEntity>();
+    qRegisterMetaType<QList<NotifyEntity>>();
+    // the server reaches the channel on its worker thread, the panels on the main thread,
+    // it lives in the main thread whichever thread creates it.
+    if (auto app = QCoreApplication::instance())
+        moveToThread(app->thread());
+}
+
+NotifyEventChannel *NotifyEventChannel::instance()
+{
+    static NotifyEventChannel *instance = new NotifyEventChannel();
+    return instance;
+}
+
+void NotifyEventChannel::notifyStatesChanged(const QList<NotifyEntity> &entities)
+{
+    if (entities.isEmpty())
+        return;
+    Q_EMIT entitiesStateChanged(entities);
+}
+
+void NotifyEventChannel::setAppValueProvider(AppValueProvider provider)
+{
+    m_appValueProvider = std::move(provider);
+}
+
+void NotifyEventChannel::invokeAction(qint64 id, uint bubbleId, const QString &actionId)
+{
+    Q_EMIT actionInvokeRequested(id, bubbleId, actionId);
+}
+
+void NotifyEventChannel::closeNotification(qint64 id, uint bubbleId, uint reason)
+{
+    Q_EMIT closeRequested(id, bubbleId, reason);
+}
+
+QVariant NotifyEventChannel::appValue(const QString &appId, int configItem) const
+{
+    if (!m_appValueProvider)
+        return {};
+    return m_appValueProvider(appId, configItem);
+}
+
+}
@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QObject>
+#include <QVariant>
+
+#include <functional>
+
+#include "notifyentity.h"
+
+namespace notification {
+
+/**
+ * @brief The NotifyEventChannel class
+ * Typed channel between the notification server and the bubble and center panels in the same process,
+ * state changes carry the entity the server has written, so the panels don't fetch it again.
+ * The server emits on its worker thread and the panels on the main thread, the receivers of the other
+ * side are connected by Qt::QueuedConnection.
+ */
+class NotifyEventChannel : public QObject
+{
+    Q_OBJECT
+public:
+    using AppValueProvider = std::function<QVariant(const QString &appId, int configItem)>;
+
+    static NotifyEventChannel *instance();
+
+    // server side
+    // the entities of one batch are delivered together.
+    void notifyStatesChanged(const QList<NotifyEntity> &entities);
+    void setAppValueProvider(AppValueProvider provider);
+
+    // panel side
+    void invokeAction(qint64 id, uint bubbleId, const QString &actionId);
+    void closeNotification(qint64 id, uint bubbleId, uint reason);
+    QVariant appValue(const QString &appId, int configItem) const;
+
+Q_SIGNALS:
+    void entitiesStateChanged(const QList<notification::NotifyEntity> &entities);
+    void actionInvokeRequested(qint64 id, uint bubbleId, const QString &actionId);
+    void closeRequested(qint64 id, uint bubbleId, uint reason);
+
+private:
+    explicit NotifyEventChannel(QObject *parent = nullptr);
+
+private:
+    AppValueProvider m_appValueProvider;
+};
+
+}
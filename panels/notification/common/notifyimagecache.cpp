@@ -0,0 +1,280 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "notifyimagecache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDBusArgument>
+#include <QFileInfo>
+#include <QLoggingCategory>
+#include <QQmlEngine>
+#include <QQuickImageProvider>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+
+namespace notification {
+Q_DECLARE_LOGGING_CATEGORY(notifyLog)
+}
+
+namespace notification {
+
+static const QString ImageProviderName = QStringLiteral("notifyimage");
+// images are shown at most 106 logical pixels, it's enough for a scale factor of 2.
+static const int MaxImageSize = 256;
+// the cost of an image is in KiB, about 64 images of the max size are kept in memory.
+static const int MaxImagesCost = 16 * 1024;
+static const int ExpiredDays = 30;
+
+static QImage scaledImage(const QImage &image)
+{
+    if (image.width() <= MaxImageSize && image.height() <= MaxImageSize)
+        return image;
+    return image.scaled(MaxImageSize, MaxImageSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+}
+
+static int costOf(const QImage &image)
+{
+    return int(qMax<qsizetype>(1, image.sizeInBytes() / 1024));
+}
+
+// keys are the hex of a hash, anything else isn't looked up on disk.
+static bool isValidKey(const QString &key)
+{
+    return !key.isEmpty() && std::all_of(key.cbegin(), key.cend(), [](QChar c) {
+        return (c >= QLatin1Char('0') && c <= QLatin1Char('9')) || (c >= QLatin1Char('a') && c <= QLatin1Char('f'));
+    });
+}
+
+// https://specifications.freedesktop.org/notification-spec/1.2/icons-and-images.html
+static QImage decodeImageFromPixels(const QByteArray &pixels, int width, int height, int rowStride, int bitsPerSample, int channels)
+{
+#define SANITY_CHECK(condition) \
+if (!(condition)) { \
+    qWarning(notifyLog) << "Sanity check failed on" << #condition; \
+    return QImage(); \
+}
+
+    SANITY_CHECK(width > 0);
+    SANITY_CHECK(width < 2048);
+    SANITY_CHECK(height > 0);
+    SANITY_CHECK(height < 2048);
+    SANITY_CHECK(bitsPerSample == 8);
+    SANITY_CHECK(channels == 3 || channels == 4);
+    SANITY_CHECK(rowStride >= width * channels);
+    SANITY_CHECK(qsizetype(rowStride) * (height - 1) + width * channels <= pixels.size());
+
+#undef SANITY_CHECK
+
+    // the pixels are wrapped without copying, the byte order of the spec is the one of RGBA8888 and RGB888,
+    // the conversion to premultiplied ARGB32 uses the vectorized converters of QtGui.
+    const auto format = channels == 4 ? QImage::Format_RGBA8888 : QImage::Format_RGB888;
+    const QImage wrapped(reinterpret_cast<const uchar *>(pixels.constData()), width, height, rowStride, format);
+    return scaledImage(wrapped).convertToFormat(QImage::Format_ARGB32_Premultiplied);
+}
+
+class NotifyImageProvider : public QQuickImageProvider
+{
+public:
+    NotifyImageProvider()
+        : QQuickImageProvider(QQuickImageProvider::Image)
+    {
+    }
+
+    QImage requestImage(const QString &id, QSize *size, const QSize &requestedSize) override
+    {
+        Q_UNUSED(requestedSize)
+        const auto image = NotifyImageCache::instance()->image(id);
+        if (size)
+            *size = image.size();
+        return image;
+    }
+};
+
+NotifyImageCache::NotifyImageCache()
+    : m_images(MaxImagesCost)
+{
+    const auto cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    m_dir.setPath(QDir(cacheDir).absoluteFilePath("notification-images"));
+    if (!m_dir.exists() && !QDir().mkpath(m_dir.path())) {
+        qWarning(notifyLog) << "Failed on creating the image cache directory" << m_dir.path();
+    }
+    m_filePool.setMaxThreadCount(1);
+    m_filePool.start([this]() {
+        removeExpiredFiles();
+    });
+}
+
+NotifyImageCache *NotifyImageCache::instance()
+{
+    static NotifyImageCache *instance = nullptr;
+    static QMutex mutex;
+    // the server decodes on its worker thread, the panels read on the thread of the image provider.
+    QMutexLocker locker(&mutex);
+    if (!instance) {
+        instance = new NotifyImageCache();
+    }
+    return instance;
+}
+
+void NotifyImageCache::registerImageProvider(QQmlEngine *engine)
+{
+    if (!engine || engine->imageProvider(ImageProviderName))
+        return;
+    engine->addImageProvider(ImageProviderName, new NotifyImageProvider());
+}
+
+bool NotifyImageCache::decode(QString &appIcon, QVariantMap &hints)
+{
+    static const QStringList ImageHints {
+        "image-data",
+        "image_data",
+        "icon_data"
+    };
+
+    QString key;
+    for (const auto &hint : ImageHints) {
+        auto iter = hints.find(hint);
+        if (iter == hints.end())
+            continue;
+
+        if (key.isEmpty() && iter->canConvert<QDBusArgument>()) {
+            int width, height, rowStride, hasAlpha, bitsPerSample, channels;
+            QByteArray pixels;
+            const auto arg = iter->value<QDBusArgument>();
+            arg.beginStructure();
+            arg >> width >> height >> rowStride >> hasAlpha >> bitsPerSample >> channels >> pixels;
+            arg.endStructure();
+
+            QCryptographicHash hash(QCryptographicHash::Md5);
+            for (const int value : {width, height, rowStride, bitsPerSample, channels})
+                hash.addData(QByteArrayView(reinterpret_cast<const char *>(&value), sizeof(value)));
+            hash.addData(pixels);
+            key = store(hash.result(), [&]() {
+                return decodeImageFromPixels(pixels, width, height, rowStride, bitsPerSample, channels);
+            });
+        }
+        hints.erase(iter);
+    }
+
+    // an inline image can't be shown by the icon, it's shown as the image of the notification.
+    if (appIcon.startsWith("data:image/")) {
+        const auto strs = appIcon.split("base64,");
+        if (key.isEmpty() && strs.length() == 2) {
+            const auto data = strs.at(1).toLatin1();
+            key = store(QCryptographicHash::hash(data, QCryptographicHash::Md5), [data]() {
+                return scaledImage(QImage::fromData(QByteArray::fromBase64(data)));
+            });
+        }
+        appIcon.clear();
+    }
+
+    if (key.isEmpty())
+        return false;
+
+    // the image data takes precedence over the image path of the sender.
+    hints.insert("image-path", QStringLiteral("image://%1/%2").arg(ImageProviderName, key));
+    return true;
+}
+
+QImage NotifyImageCache::image(const QString &key)
+{
+    if (!isValidKey(key))
+        return QImage();
+
+    {
+        QMutexLocker locker(&m_mutex);
+        if (auto image = m_images.object(key))
+            return *image;
+        m_usedKeys.insert(key);
+    }
+
+    // saved in a previous session, or dropped from memory meanwhile.
+    const QImage image(fileName(key), "PNG");
+    if (image.isNull()) {
+        qWarning(notifyLog) << "Failed on loading the notification image" << key;
+        return image;
+    }
+    touch(key);
+
+    QMutexLocker locker(&m_mutex);
+    m_images.insert(key, new QImage(image), costOf(image));
+    return image;
+}
+
+QString NotifyImageCache::store(const QByteArray &hash, const std::function<QImage()> &decoder)
+{
+    const auto key = QString::fromLatin1(hash.toHex());
+    bool cached = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        // it's marked before the file is checked, the file isn't expired by `removeExpiredFiles` anymore.
+        m_usedKeys.insert(key);
+        cached = m_images.contains(key);
+    }
+
+    const auto name = fileName(key);
+    // saved in a previous session, it's loaded when it's shown.
+    if (cached || QFileInfo::exists(name)) {
+        touch(key);
+        return key;
+    }
+
+    const auto image = decoder();
+    if (image.isNull())
+        return QString();
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_images.insert(key, new QImage(image), costOf(image));
+    }
+
+    // encoding and writing aren't done on the receiving path, the image is shown from memory meanwhile.
+    m_filePool.start([image, name]() {
+        QSaveFile file(name);
+        if (!file.open(QIODevice::WriteOnly) || !image.save(&file, "PNG") || !file.commit()) {
+            qWarning(notifyLog) << "Failed on saving the notification image" << name << file.errorString();
+        }
+    });
+    return key;
+}
+
+QString NotifyImageCache::fileName(const QString &key) const
+{
+    return m_dir.absoluteFilePath(key + ".png");
+}
+
+// the file of a reused image gets a new modification time, it expires 30 days after its last use.
+void NotifyImageCache::touch(const QString &key)
+{
+    m_filePool.start([name = fileName(key)]() {
+        QFile file(name);
+        // queued after the write of a new image, the file is missing only if the write failed.
+        if (!file.exists())
+            return;
+        if (!file.open(QIODevice::Append) || !file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime)) {
+            qWarning(notifyLog) << "Failed on touching the notification image" << name << file.errorString();
+        }
+    });
+}
+
+void NotifyImageCache::removeExpiredFiles()
+{
+    const auto expired = QDateTime::currentDateTime().addDays(-ExpiredDays);
+    const auto files = m_dir.entryInfoList({"*.png"}, QDir::Files);
+    for (const auto &info : files) {
+        if (info.lastModified() >= expired)
+            continue;
+
+        // checked and removed under the lock, `store` can't hand out the key meanwhile.
+        QMutexLocker locker(&m_mutex);
+        if (m_usedKeys.contains(info.completeBaseName()))
+            continue;
+        QFile::remove(info.absoluteFilePath());
+    }
+}
+
+}
@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QCache>
+#include <QDir>
+#include <QImage>
+#include <QMutex>
+#include <QSet>
+#include <QThreadPool>
+#include <QVariantMap>
+
+#include <functional>
+
+class QQmlEngine;
+
+namespace notification {
+
+/**
+ * @brief The NotifyImageCache class
+ * Decodes the image of a notification once when it's received, the decoded image is kept in memory by
+ * its content hash and shared by the bubble and the notification center through the "notifyimage"
+ * image provider. A copy is saved to disk off the receiving thread, so the image of the history is
+ * still shown after a restart. The copies unused for 30 days are removed at startup.
+ */
+class NotifyImageCache
+{
+public:
+    static NotifyImageCache *instance();
+    // registers the "notifyimage" image provider to `engine` once.
+    static void registerImageProvider(QQmlEngine *engine);
+
+    // inline images of the icon and the hints are replaced by the "image-path" hint referring to the
+    // cached image, they aren't kept as raw pixels in the entity. Returns true if an image is cached.
+    bool decode(QString &appIcon, QVariantMap &hints);
+    // the image of `key`, it's loaded from disk if it isn't in memory, it can be called from any thread.
+    QImage image(const QString &key);
+
+private:
+    NotifyImageCache();
+
+    QString store(const QByteArray &hash, const std::function<QImage()> &decoder);
+    QString fileName(const QString &key) const;
+    void touch(const QString &key);
+    void removeExpiredFiles();
+
+private:
+    QDir m_dir;
+    mutable QMutex m_mutex;
+    QCache<QString, QImage> m_images;
+    // keys handed out in this session, their files aren't expired, guarded by m_mutex.
+    QSet<QString> m_usedKeys;
+    // one thread writes the files, in the order they're stored, after the expired ones are removed.
+    QThreadPool m_filePool;
+};
+
+}
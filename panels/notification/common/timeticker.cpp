@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "timeticker.h"
+
+#include <QDateTime>
+
+#include <limits>
+
+namespace notification {
+
+TimeTicker *TimeTicker::instance()
+{
+    static TimeTicker instance;
+    return &instance;
+}
+
+TimeTicker::TimeTicker(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+{
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &TimeTicker::onTimeout);
+}
+
+void TimeTicker::schedule(QObject *client, qint64 msecsSinceEpoch, std::function<void()> callback)
+{
+    if (!client)
+        return;
+
+    if (!m_requests.contains(client)) {
+        connect(client, &QObject::destroyed, this, [this, client]() {
+            cancel(client);
+        });
+    }
+    m_requests[client] = {msecsSinceEpoch, std::move(callback)};
+    restart();
+}
+
+void TimeTicker::cancel(QObject *client)
+{
+    if (m_requests.remove(client) <= 0)
+        return;
+
+    disconnect(client, &QObject::destroyed, this, nullptr);
+    restart();
+}
+
+void TimeTicker::restart()
+{
+    if (m_requests.isEmpty()) {
+        m_timer->stop();
+        return;
+    }
+
+    qint64 next = std::numeric_limits<qint64>::max();
+    for (const auto &item : std::as_const(m_requests)) {
+        next = std::min(next, item.time);
+    }
+    const auto interval = std::max<qint64>(0, next - QDateTime::currentMSecsSinceEpoch());
+    m_timer->start(static_cast<int>(std::min<qint64>(interval, std::numeric_limits<int>::max())));
+}
+
+void TimeTicker::onTimeout()
+{
+    const auto now = QDateTime::currentMSecsSinceEpoch();
+    QList<std::function<void()>> callbacks;
+    for (auto iter = m_requests.begin(); iter != m_requests.end();) {
+        if (iter.value().time > now) {
+            ++iter;
+            continue;
+        }
+        disconnect(iter.key(), &QObject::destroyed, this, nullptr);
+        callbacks << std::move(iter.value().callback);
+        iter = m_requests.erase(iter);
+    }
+
+    // callbacks usually schedule the next label change again.
+    for (const auto &callback : std::as_const(callbacks)) {
+        callback();
+    }
+    restart();
+}
+
+}
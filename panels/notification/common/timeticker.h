@@ -0,0 +1,46 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+
+#include <functional>
+
+namespace notification {
+
+/**
+ * @brief The TimeTicker class
+ * Shared wake-up source for the relative time labels ("Just now", "1 minutes ago"...),
+ * every client schedules the time its next label changes, and the ticker only wakes
+ * for the earliest one of them.
+ */
+class TimeTicker : public QObject
+{
+    Q_OBJECT
+public:
+    static TimeTicker *instance();
+
+    // the callback is invoked once at `msecsSinceEpoch`, replaces the former request of the client.
+    void schedule(QObject *client, qint64 msecsSinceEpoch, std::function<void()> callback);
+    void cancel(QObject *client);
+
+private:
+    explicit TimeTicker(QObject *parent = nullptr);
+
+    void restart();
+    void onTimeout();
+
+private:
+    struct Request {
+        qint64 time = 0;
+        std::function<void()> callback;
+    };
+    QHash<QObject *, Request> m_requests;
+    QTimer *m_timer = nullptr;
+};
+
+}
@@ -6,38 +6,47 @@
 
 #include "pluginfactory.h"
 
-#include <QDBusConnection>
-#include <QDBusPendingCall>
-#include <QDBusReply>
+#include "dbuspropertycache.h"
 
-#include <DDBusSender>
+#include <QDBusObjectPath>
 
 namespace osd {
 
-static DDBusSender audioInter()
+static const QString AudioService = "org.deepin.dde.Audio1";
+
+AudioApplet::AudioApplet(QObject *parent)
+    : DApplet(parent)
 {
-    return DDBusSender().service("org.deepin.dde.Audio1")
-        .path("/org/deepin/dde/Audio1")
-        .interface("org.deepin.dde.Audio1");
+
 }
 
-static DDBusSender audioSinkInter()
+bool AudioApplet::init()
 {
-    QDBusReply<QVariant> defaultSink = audioInter().property("DefaultSink").get();
-    if (!defaultSink.isValid()) {
-        qWarning() << "Failed to fetch DefaultSink" << defaultSink.error();
-        return DDBusSender();
-    }
-    const auto path = qdbus_cast<QDBusObjectPath>(defaultSink);
-    return DDBusSender().service("org.deepin.dde.Audio1")
-        .path(path.path())
-        .interface("org.deepin.dde.Audio1.Sink");
+    // properties are cached and kept by PropertiesChanged, sync() is called on every key repeat
+    // of the volume keys, it shouldn't block on D-Bus.
+    m_audio = new DBusPropertyCache(AudioService, "org.deepin.dde.Audio1", this);
+    m_sink = new DBusPropertyCache(AudioService, "org.deepin.dde.Audio1.Sink", this);
+    connect(m_audio, &DBusPropertyCache::propertiesChanged, this, [this](const QStringList &names) {
+        if (names.contains("DefaultSink"))
+            updateSinkPath();
+        if (names.contains("IncreaseVolume"))
+            setIncreaseVolume(fetchIncreaseVolume());
+    });
+    connect(m_sink, &DBusPropertyCache::propertiesChanged, this, [this](const QStringList &names) {
+        if (names.contains("Volume"))
+            setVolumeValue(fetchVolume());
+        if (names.contains("Volume") || names.contains("Mute"))
+            setIconName(fetchIconName());
+    });
+    m_audio->setPath("/org/deepin/dde/Audio1");
+
+    return DApplet::init();
 }
 
-AudioApplet::AudioApplet(QObject *parent)
-    : DApplet(parent)
+void AudioApplet::updateSinkPath()
 {
-
+    const auto path = qdbus_cast<QDBusObjectPath>(m_audio->value("DefaultSink"));
+    m_sink->setPath(path.path());
 }
 
 bool AudioApplet::increaseVolume() const
@@ -55,6 +64,9 @@ void AudioApplet::setIncreaseVolume(bool newIncreaseVolume)
 
 void AudioApplet::sync()
 {
+    if (!m_sink || !m_sink->isReady())
+        return;
+
     setVolumeValue(fetchVolume());
 
     setIncreaseVolume(fetchIncreaseVolume());
@@ -64,12 +76,7 @@ void AudioApplet::sync()
 
 QString AudioApplet::fetchIconName() const
 {
-    QDBusReply<QVariant> muteReply = audioSinkInter().property("Mute").get();
-    if (!muteReply.isValid()) {
-        qWarning() << "Failed to fetch Mute" << muteReply.error();
-        return QString();
-    }
-    if (qdbus_cast<bool>(muteReply)) {
+    if (m_sink->value("Mute").toBool()) {
         return "osd_volume_mute";
     }
 
@@ -90,24 +97,12 @@ QString AudioApplet::fetchIconName() const
 
 double AudioApplet::fetchVolume() const
 {
-    QDBusReply<QVariant> volumeReply = audioSinkInter().property("Volume").get();
-    if (!volumeReply.isValid()) {
-        qWarning() << "Failed to Volume Volume" << volumeReply.error();
-        return 0.0;
-    }
-
-    return qdbus_cast<double>(volumeReply);
+    return m_sink->value("Volume").toDouble();
 }
 
 bool AudioApplet::fetchIncreaseVolume() const
 {
-    QDBusReply<QVariant> volumeReply = audioInter().property("IncreaseVolume").get();
-    if (!volumeReply.isValid()) {
-        qWarning() << "Failed to Volume IncreaseVolume" << volumeReply.error();
-        return false;
-    }
-
-    return qdbus_cast<bool>(volumeReply);
+    return m_audio->value("IncreaseVolume").toBool();
 }
 
 QString AudioApplet::iconName() const
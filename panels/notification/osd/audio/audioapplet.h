@@ -8,6 +8,7 @@
 
 namespace osd {
 
+class DBusPropertyCache;
 class AudioApplet : public DS_NAMESPACE::DApplet
 {
     Q_OBJECT
@@ -17,6 +18,8 @@ class AudioApplet : public DS_NAMESPACE::DApplet
 public:
     explicit AudioApplet(QObject *parent = nullptr);
 
+    bool init() override;
+
     double volumeValue() const;
     void setVolumeValue(double newVolumeValue);
 
@@ -41,7 +44,10 @@ private:
     QString fetchIconName() const;
     double fetchVolume() const;
     bool fetchIncreaseVolume() const;
+    void updateSinkPath();
 private:
+    DBusPropertyCache *m_audio = nullptr;
+    DBusPropertyCache *m_sink = nullptr;
     double m_increaseVolume = 1.0;
     double m_volumeValue = 1.0;
     QString m_iconName;
@@ -6,26 +6,31 @@
 
 #include "pluginfactory.h"
 
-#include <QDBusConnection>
-#include <QDBusReply>
+#include "dbuspropertycache.h"
 
-#include <DDBusSender>
+#include <QDBusArgument>
 
 namespace osd {
 
-static DDBusSender displayInter()
-{
-    return DDBusSender().service("org.deepin.dde.Display1")
-        .path("/org/deepin/dde/Display1")
-        .interface("org.deepin.dde.Display1");
-}
-
 BrightnessApplet::BrightnessApplet(QObject *parent)
     : DApplet(parent)
 {
 
 }
 
+bool BrightnessApplet::init()
+{
+    // sync() is called on every key repeat of the brightness keys, it reads the cached properties.
+    m_display = new DBusPropertyCache("org.deepin.dde.Display1", "org.deepin.dde.Display1", this);
+    connect(m_display, &DBusPropertyCache::propertiesChanged, this, [this](const QStringList &names) {
+        if (names.contains("Brightness") || names.contains("Primary"))
+            sync();
+    });
+    m_display->setPath("/org/deepin/dde/Display1");
+
+    return DApplet::init();
+}
+
 QString BrightnessApplet::iconName() const
 {
     return m_iconName;
@@ -33,6 +38,9 @@ QString BrightnessApplet::iconName() const
 
 void BrightnessApplet::sync()
 {
+    if (!m_display || !m_display->isReady())
+        return;
+
     auto brightness = fetchBrightness();
 
     setBrightness(brightness);
@@ -65,18 +73,8 @@ QString BrightnessApplet::fetchIconName() const
 
 double BrightnessApplet::fetchBrightness() const
 {
-    QDBusReply<QVariant> brightness = displayInter().property("Brightness").get();
-    if (!brightness.isValid()) {
-        return 0;
-    }
-
-    QDBusReply<QVariant> primary = displayInter().property("Primary").get();
-    if (!primary.isValid()) {
-        return 0;
-    }
-
-    const auto brightnessInfo = qdbus_cast<QMap<QString, double>>(brightness.value());
-    const auto primaryInfo = primary.value().toString();
+    const auto brightnessInfo = qdbus_cast<QMap<QString, double>>(m_display->value("Brightness"));
+    const auto primaryInfo = m_display->value("Primary").toString();
 
     return brightnessInfo.value(primaryInfo);
 }
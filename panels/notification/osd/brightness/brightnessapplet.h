@@ -8,6 +8,7 @@
 
 namespace osd {
 
+class DBusPropertyCache;
 class BrightnessApplet : public DS_NAMESPACE::DApplet
 {
     Q_OBJECT
@@ -16,6 +17,8 @@ class BrightnessApplet : public DS_NAMESPACE::DApplet
 public:
     explicit BrightnessApplet(QObject *parent = nullptr);
 
+    bool init() override;
+
     double brightness() const;
     QString iconName() const;
 
@@ -32,6 +35,7 @@ private:
     QString fetchIconName() const;
     double fetchBrightness() const;
 private:
+    DBusPropertyCache *m_display = nullptr;
     double m_brightness;
     QString m_iconName;
 };
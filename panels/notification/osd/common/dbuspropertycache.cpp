@@ -0,0 +1,127 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "dbuspropertycache.h"
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDBusServiceWatcher>
+#include <QLoggingCategory>
+
+namespace osd {
+
+Q_LOGGING_CATEGORY(osdDBusLog, "dde.shell.osd.dbus")
+
+static const QString PropertiesInterface = "org.freedesktop.DBus.Properties";
+static const QString PropertiesChanged = "PropertiesChanged";
+
+DBusPropertyCache::DBusPropertyCache(const QString &service, const QString &interface, QObject *parent)
+    : QObject(parent)
+    , m_service(service)
+    , m_interface(interface)
+    , m_serviceWatcher(new QDBusServiceWatcher(service, QDBusConnection::sessionBus(), QDBusServiceWatcher::WatchForRegistration, this))
+{
+    // the service is restarted, its properties may be changed without PropertiesChanged.
+    connect(m_serviceWatcher, &QDBusServiceWatcher::serviceRegistered, this, &DBusPropertyCache::fetchAll);
+}
+
+QString DBusPropertyCache::path() const
+{
+    return m_path;
+}
+
+void DBusPropertyCache::setPath(const QString &path)
+{
+    if (m_path == path)
+        return;
+
+    subscribe(false);
+    m_path = path;
+    m_ready = false;
+    const auto names = m_values.keys();
+    m_values.clear();
+    if (!names.isEmpty())
+        Q_EMIT propertiesChanged(names);
+
+    subscribe(true);
+    fetchAll();
+}
+
+bool DBusPropertyCache::isReady() const
+{
+    return m_ready;
+}
+
+QVariant DBusPropertyCache::value(const QString &name) const
+{
+    return m_values.value(name);
+}
+
+void DBusPropertyCache::onPropertiesChanged(const QString &interface, const QVariantMap &changed, const QStringList &invalidated)
+{
+    if (interface != m_interface)
+        return;
+
+    for (auto iter = changed.cbegin(); iter != changed.cend(); ++iter)
+        m_values.insert(iter.key(), iter.value());
+    if (!changed.isEmpty())
+        Q_EMIT propertiesChanged(changed.keys());
+
+    // the values of invalidated properties aren't sent, they're fetched again.
+    if (!invalidated.isEmpty())
+        fetchAll();
+}
+
+void DBusPropertyCache::fetchAll()
+{
+    if (m_path.isEmpty())
+        return;
+
+    auto msg = QDBusMessage::createMethodCall(m_service, m_path, PropertiesInterface, "GetAll");
+    msg << m_interface;
+    auto watcher = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().asyncCall(msg), this);
+    const auto path = m_path;
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, path](QDBusPendingCallWatcher *watcher) {
+        onFetched(watcher, path);
+    });
+}
+
+void DBusPropertyCache::onFetched(QDBusPendingCallWatcher *watcher, const QString &path)
+{
+    watcher->deleteLater();
+    // the reply of a former object.
+    if (path != m_path)
+        return;
+
+    QDBusPendingReply<QVariantMap> reply = *watcher;
+    if (reply.isError()) {
+        qCWarning(osdDBusLog) << "Failed to fetch properties of" << m_service << path << reply.error();
+        return;
+    }
+
+    const auto values = reply.value();
+    for (auto iter = values.cbegin(); iter != values.cend(); ++iter)
+        m_values.insert(iter.key(), iter.value());
+    m_ready = true;
+    Q_EMIT propertiesChanged(values.keys());
+}
+
+void DBusPropertyCache::subscribe(bool on)
+{
+    if (m_path.isEmpty())
+        return;
+
+    auto bus = QDBusConnection::sessionBus();
+    if (on) {
+        bus.connect(m_service, m_path, PropertiesInterface, PropertiesChanged, this,
+                    SLOT(onPropertiesChanged(QString, QVariantMap, QStringList)));
+    } else {
+        bus.disconnect(m_service, m_path, PropertiesInterface, PropertiesChanged, this,
+                       SLOT(onPropertiesChanged(QString, QVariantMap, QStringList)));
+    }
+}
+
+}
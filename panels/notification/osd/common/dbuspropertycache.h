@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QObject>
+#include <QVariantMap>
+
+class QDBusPendingCallWatcher;
+class QDBusServiceWatcher;
+
+namespace osd {
+
+/**
+ * @brief The DBusPropertyCache class
+ * Keeps the properties of a D-Bus object, they're fetched by an asynchronous GetAll,
+ * and updated by PropertiesChanged, reading them doesn't block on D-Bus.
+ */
+class DBusPropertyCache : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DBusPropertyCache(const QString &service, const QString &interface, QObject *parent = nullptr);
+
+    QString path() const;
+    // subscribes the object of the path, the properties of the former object are dropped.
+    void setPath(const QString &path);
+
+    bool isReady() const;
+    QVariant value(const QString &name) const;
+
+Q_SIGNALS:
+    void propertiesChanged(const QStringList &names);
+
+private Q_SLOTS:
+    void onPropertiesChanged(const QString &interface, const QVariantMap &changed, const QStringList &invalidated);
+
+private:
+    void fetchAll();
+    void onFetched(QDBusPendingCallWatcher *watcher, const QString &path);
+    void subscribe(bool on);
+
+private:
+    QString m_service;
+    QString m_interface;
+    QString m_path;
+    QVariantMap m_values;
+    bool m_ready = false;
+    QDBusServiceWatcher *m_serviceWatcher = nullptr;
+};
+
+}
@@ -5,9 +5,12 @@
 #include "displaymodeapplet.h"
 
 #include "pluginfactory.h"
+#include "dbuspropertycache.h"
 
 #include <QDBusConnection>
 #include <QDBusPendingCall>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
 #include <QDBusReply>
 #include <QLoggingCategory>
 
@@ -77,6 +80,28 @@ DisPlayModeApplet::DisPlayModeApplet(QObject *parent)
     QObject::connect(m_actionTimer, &QTimer::timeout, this, &DisPlayModeApplet::doAction);
 }
 
+bool DisPlayModeApplet::init()
+{
+    DCORE_USE_NAMESPACE;
+
+    // sync() is called on every key press of the display mode shortcut, the properties, the outputs
+    // and the config are cached and updated by their change notifications.
+    m_display = new DBusPropertyCache("org.deepin.dde.Display1", "org.deepin.dde.Display1", this);
+    connect(m_display, &DBusPropertyCache::propertiesChanged, this, [this](const QStringList &names) {
+        if (names.contains("Monitors"))
+            fetchOutputNames();
+    });
+    m_display->setPath("/org/deepin/dde/Display1");
+
+    m_config = DConfig::create("org.deepin.dde.control-center", "org.deepin.dde.control-center", QString(), this);
+    connect(m_config, &DConfig::valueChanged, this, [this](const QString &key) {
+        if (key == "hideModule" || key == "disableModule")
+            setState(fetchState());
+    });
+
+    return DApplet::init();
+}
+
 int DisPlayModeApplet::state() const
 {
     return m_state;
@@ -154,12 +179,7 @@ void DisPlayModeApplet::setCurrentPlanItem(DPItem *newCurrentPlanItem)
 
 void DisPlayModeApplet::fetchPlanItems()
 {
-    QDBusReply<QStringList> listOutputNames = displayInter().method("ListOutputNames").call();
-    if (!listOutputNames.isValid()) {
-        qCWarning(osdDPLog) << "Failed to fetch ListOutputNames" << listOutputNames.error();
-        return;
-    }
-    auto outputNames = listOutputNames.value();
+    auto outputNames = m_outputNames;
 
     qDeleteAll(m_planItems);
     m_planItems.clear();
@@ -178,20 +198,12 @@ void DisPlayModeApplet::fetchPlanItems()
 
 DPItem *DisPlayModeApplet::fetchCurrentPlanItem() const
 {
-    auto inter = displayInter();
-    QDBusReply<QVariant> displayMode = inter.property("DisplayMode").get();
-    if (!displayMode.isValid()) {
-        qCWarning(osdDPLog) << "Failed to fetch DisplayMode" << displayMode.error();
+    if (!m_display->isReady()) {
+        qCWarning(osdDPLog) << "Properties of Display1 aren't fetched yet";
         return nullptr;
     }
-    auto mode = qdbus_cast<uchar>(displayMode);
-
-    QDBusReply<QVariant> primaryScreen = inter.property("Primary").get();
-    if (!primaryScreen.isValid()) {
-        qCWarning(osdDPLog) << "Failed to fetch Primary" << primaryScreen.error();
-        return nullptr;
-    }
-    auto screen = qdbus_cast<QString>(primaryScreen);
+    auto mode = qdbus_cast<uchar>(m_display->value("DisplayMode"));
+    auto screen = m_display->value("Primary").toString();
 
     auto it = std::find_if(m_planItems.begin(), m_planItems.end(), [this, mode, screen](const DPItem *item) {
         return (mode != DPItem::Single && mode == item->mode())
@@ -205,14 +217,10 @@ DPItem *DisPlayModeApplet::fetchCurrentPlanItem() const
 
 int DisPlayModeApplet::fetchState() const
 {
-    DCORE_USE_NAMESPACE;
-
     int state = 1;
-    QScopedPointer<DConfig> config(DConfig::create("org.deepin.dde.control-center", "org.deepin.dde.control-center", QString()));
-
-    if (config->isValid()) {
-        bool inHideModules = config->value("hideModule").toStringList().contains("display/mode");
-        bool inDisableModules = config->value("disableModule").toStringList().contains("display/mode");
+    if (m_config && m_config->isValid()) {
+        bool inHideModules = m_config->value("hideModule").toStringList().contains("display/mode");
+        bool inDisableModules = m_config->value("disableModule").toStringList().contains("display/mode");
         if (!inHideModules && !inDisableModules) {
             state = 0;
         } else if (inDisableModules) {
@@ -222,6 +230,21 @@ int DisPlayModeApplet::fetchState() const
     return state;
 }
 
+void DisPlayModeApplet::fetchOutputNames()
+{
+    QDBusPendingCall call = displayInter().method("ListOutputNames").call();
+    auto watcher = new QDBusPendingCallWatcher(call, this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher *watcher) {
+        watcher->deleteLater();
+        QDBusPendingReply<QStringList> reply = *watcher;
+        if (reply.isError()) {
+            qCWarning(osdDPLog) << "Failed to fetch ListOutputNames" << reply.error();
+            return;
+        }
+        m_outputNames = reply.value();
+    });
+}
+
 D_APPLET_CLASS(DisPlayModeApplet)
 
 }
@@ -9,8 +9,11 @@
 #include <QQmlListProperty>
 #include <QTimer>
 
+#include <DConfig>
+
 namespace osd {
 
+class DBusPropertyCache;
 class DPItem : public QObject
 {
     Q_OBJECT
@@ -56,6 +59,8 @@ class DisPlayModeApplet : public DS_NAMESPACE::DApplet
 public:
     explicit DisPlayModeApplet(QObject *parent = nullptr);
 
+    bool init() override;
+
     int state() const;
     DPItem *currentPlanItem() const;
     QQmlListProperty<DPItem> planItems();
@@ -75,8 +80,12 @@ private:
     void fetchPlanItems();
     DPItem *fetchCurrentPlanItem() const;
     int fetchState() const;
+    void fetchOutputNames();
 
 private:
+    DBusPropertyCache *m_display = nullptr;
+    DTK_CORE_NAMESPACE::DConfig *m_config = nullptr;
+    QStringList m_outputNames;
     QList<DPItem *> m_planItems;
     DPItem *m_currentPlanItem = nullptr;
     int m_state;
@@ -140,4 +140,9 @@ QDBusVariant DDENotificationDbusAdaptor::GetSystemInfo(uint configItem)
     return QDBusVariant(manager()->GetSystemInfo(configItem));
 }
 
+QString DDENotificationDbusAdaptor::GetRateLimitStatistics()
+{
+    return manager()->GetRateLimitStatistics();
+}
+
 } // notification
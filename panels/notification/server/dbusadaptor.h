@@ -69,6 +69,8 @@ public Q_SLOTS: // methods
     void SetSystemInfo(uint configItem, const QDBusVariant &value);
     QDBusVariant GetSystemInfo(uint configItem);
 
+    QString GetRateLimitStatistics();
+
 private:
     NotificationManager *manager() const;
 
@@ -82,6 +84,7 @@ Q_SIGNALS:
     void SystemInfoChanged(uint configItem, const QDBusVariant &value);
 
     void NotificationStateChanged(qint64 id, int processedType);
+    void NotificationStatesChanged(const QList<qint64> &ids, int processedType);
     void RecordCountChanged(uint count);
 };
 
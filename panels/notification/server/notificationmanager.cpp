@@ -7,8 +7,12 @@
 #include "dbaccessor.h"
 #include "notificationsetting.h"
 #include "notifyentity.h"
+#include "notifyeventchannel.h"
+#include "notifyimagecache.h"
+#include "notifyratelimiter.h"
 
 #include <QDateTime>
+#include <QMap>
 #include <DDesktopServices>
 #include <DSGApplication>
 #include <QDBusConnection>
@@ -46,9 +50,13 @@ NotificationManager::NotificationManager(QObject *parent)
     , m_setting(new NotificationSetting(this))
     , m_userSessionManager(new UserSessionManager(SessionDBusService, SessionDaemonDBusPath, QDBusConnection::sessionBus(), this))
     , m_pendingTimeout(new QTimer(this))
+    , m_rateLimiter(new NotifyRateLimiter())
+    , m_floodTimeout(new QTimer(this))
 {
     m_pendingTimeout->setSingleShot(true);
     connect(m_pendingTimeout, &QTimer::timeout, this, &NotificationManager::onHandingPendingEntities);
+    m_floodTimeout->setSingleShot(true);
+    connect(m_floodTimeout, &QTimer::timeout, this, &NotificationManager::onHandingFloods);
 
     DataAccessorProxy::instance()->setSource(DBAccessor::instance());
 
@@ -72,12 +80,14 @@ NotificationManager::NotificationManager(QObject *parent)
 
     QScopedPointer<DConfig> config(DConfig::create("org.deepin.dde.shell", "org.deepin.dde.shell.notification"));
     m_systemApps = config->value("systemApps").toStringList();
-    // TODO temporary fix for AppNamesMap
-    m_appNamesMap = config->value("AppNamesMap").toMap();
+    m_rateLimiter->setBurst(config->value("notifyBurstCount", 10).toInt());
+    m_rateLimiter->setRefillInterval(config->value("notifyRefillInterval", 500).toInt());
 }
 
 NotificationManager::~NotificationManager()
 {
+    delete m_rateLimiter;
+    m_rateLimiter = nullptr;
     if (m_persistence) {
         delete m_persistence;
         m_persistence = nullptr;
@@ -147,16 +157,16 @@ void NotificationManager::removeNotification(qint64 id)
 
 void NotificationManager::removeNotifications(const QString &appName)
 {
-    m_persistence->removeEntityByApp(appName);
+    const auto ids = m_persistence->fetchEntityIds(appName, NotifyEntity::Processed);
+    m_persistence->removeEntities(ids, NotifyEntity::Processed);
 
+    emitStateChanged(ids, NotifyEntity::Removed);
     emitRecordCountChanged();
 }
 
 void NotificationManager::removeNotifications()
 {
-    m_persistence->clear();
-
-    emitRecordCountChanged();
+    removeNotifications(DataAccessor::AllApp());
 }
 
 QStringList NotificationManager::GetCapabilities()
@@ -196,12 +206,16 @@ uint NotificationManager::Notify(const QString &appName, uint replacesId, const
     if (appId.isEmpty())
         appId = appName;
 
-    bool enableAppNotification = m_setting->appValue(appId, NotificationSetting::EnableNotification).toBool();
+    // resolved once for all the settings used below.
+    const auto appSettings = m_setting->appSettings(appId);
+    const auto appItem = m_setting->appItem(appId);
+
+    bool enableAppNotification = appSettings.enabled;
     if (!enableAppNotification && !m_systemApps.contains(appId)) {
         return 0;
     }
 
-    auto tsAppName = m_setting->appValue(appId, NotificationSetting::AppName).toString();
+    auto tsAppName = appItem.appName;
     if (tsAppName.isEmpty()) {
         tsAppName = appName;
     }
@@ -211,12 +225,42 @@ uint NotificationManager::Notify(const QString &appName, uint replacesId, const
 
     QString strIcon = appIcon;
     if (strIcon.isEmpty())
-        strIcon = m_setting->appValue(appId, NotificationSetting::AppIcon).toString();
+        strIcon = appItem.appIcon;
     NotifyEntity entity(tsAppName, replacesId, strIcon, summary, strBody, actions, hints, expireTimeout);
     entity.setAppId(appId);
     entity.setProcessedType(NotifyEntity::None);
     entity.setReplacesId(replacesId);
 
+    // only replacing an existing notify doesn't add records, the other notifies of the app are limited.
+    NotifyEntity replacedEntity;
+    if (replacesId != NoReplacesId)
+        replacedEntity = m_persistence->fetchLastEntity(replacesId);
+    if (!replacedEntity.isValid()) {
+        const auto now = QDateTime::currentMSecsSinceEpoch();
+        // replacing a collapsed notify goes to the flood it belongs to.
+        auto floodAppId = m_rateLimiter->floodAppId(replacesId);
+        if (floodAppId.isEmpty() && !m_rateLimiter->acquire(appId, now))
+            floodAppId = appId;
+        if (!floodAppId.isEmpty()) {
+            qDebug(notifyLog) << "Collapse the notify for flooding, appId:" << floodAppId;
+            auto bubbleId = m_rateLimiter->floodBubbleId(floodAppId);
+            if (bubbleId == 0)
+                bubbleId = ++m_replacesCount;
+            m_rateLimiter->collapse(floodAppId, bubbleId, entity, now);
+            if (!m_floodTimeout->isActive()) {
+                m_floodTimeout->start(NotifyRateLimiter::FloodQuietInterval);
+            }
+            // the entity recording the flood gets this bubble id, it can be closed or replaced by it.
+            return bubbleId;
+        }
+    }
+
+    // images are decoded once here, the bubble and the center show the cached image.
+    QVariantMap strHints = hints;
+    NotifyImageCache::instance()->decode(strIcon, strHints);
+    entity.setAppIcon(strIcon);
+    entity.setHints(strHints);
+
     bool lockScreenShow = true;
     bool dndMode = isDoNotDisturb();
     bool systemNotification = m_systemApps.contains(appId);
@@ -224,9 +268,9 @@ uint NotificationManager::Notify(const QString &appName, uint replacesId, const
     const bool desktopScreen = !lockScreen;
 
     if (!systemNotification) {
-        lockScreenShow = m_setting->appValue(appId, NotificationSetting::ShowOnLockScreen).toBool();
+        lockScreenShow = appSettings.showOnLockScreen;
     }
-    const bool onDesktopShow = m_setting->appValue(appId, NotificationSetting::ShowOnDesktop).toBool();
+    const bool onDesktopShow = appSettings.showOnDesktop;
 
     tryPlayNotificationSound(entity, appId, dndMode);
 
@@ -255,10 +299,9 @@ uint NotificationManager::Notify(const QString &appName, uint replacesId, const
     if (entity.processedType() != NotifyEntity::None) {
         qint64 id = -1;
         if (entity.isReplace()) {
-            auto lastEntity = m_persistence->fetchLastEntity(entity.bubbleId());
-            if (lastEntity.isValid()) {
+            if (replacedEntity.isValid()) {
                 removePendingEntity(entity);
-                id = m_persistence->replaceEntity(lastEntity.id(), entity);
+                id = m_persistence->replaceEntity(replacedEntity.id(), entity);
             } else {
                 qWarning() << "Not exist notification to replace for the replaceId" << replacesId;
             }
@@ -276,7 +319,7 @@ uint NotificationManager::Notify(const QString &appName, uint replacesId, const
 
         emitRecordCountChanged();
 
-        Q_EMIT NotificationStateChanged(entity.id(), entity.processedType());
+        emitStatesChanged({entity});
 
         bool critical = false;
         if (auto iter = hints.find("urgency"); iter != hints.end()) {
@@ -296,6 +339,10 @@ uint NotificationManager::Notify(const QString &appName, uint replacesId, const
 }
 void NotificationManager::CloseNotification(uint id)
 {
+    // the flood isn't recorded if it's closed before it's over.
+    if (m_rateLimiter->dropFlood(id))
+        qDebug(notifyLog) << "Drop the collapsed notifications, bubbleId" << id;
+
     auto entity = m_persistence->fetchLastEntity(id);
     if (entity.isValid()) {
         entity.setProcessedType(NotifyEntity::Removed);
@@ -344,6 +391,11 @@ QVariant NotificationManager::GetSystemInfo(uint configItem)
     return m_setting->systemValue(static_cast<NotificationSetting::SystemConfigItem>(configItem));
 }
 
+QString NotificationManager::GetRateLimitStatistics()
+{
+    return QString::fromUtf8(QJsonDocument(m_rateLimiter->statistics()).toJson(QJsonDocument::Compact));
+}
+
 bool NotificationManager::isDoNotDisturb() const
 {
     if (!m_setting->systemValue(NotificationSetting::DNDMode).toBool())
@@ -404,6 +456,11 @@ void NotificationManager::tryPlayNotificationSound(const NotifyEntity &entity, c
         playSoundTip = true;
     }
 
+    if (playSoundTip && !m_rateLimiter->acquireSound(appId, QDateTime::currentMSecsSinceEpoch())) {
+        qDebug(notifyLog) << "Throttle the notification sound of the app" << appId;
+        playSoundTip = false;
+    }
+
     if (playSoundTip) {
         Dtk::Gui::DDesktopServices::playSystemSoundEffect(Dtk::Gui::DDesktopServices::SSE_Notifications);
     }
@@ -415,6 +472,26 @@ void NotificationManager::emitRecordCountChanged()
     emit RecordCountChanged(count);
 }
 
+void NotificationManager::emitStatesChanged(const QList<NotifyEntity> &entities)
+{
+    QMap<int, QList<qint64>> ids;
+    for (const auto &entity : entities)
+        ids[entity.processedType()] << entity.id();
+    for (auto iter = ids.constBegin(); iter != ids.constEnd(); ++iter)
+        emitStateChanged(iter.value(), iter.key());
+
+    NotifyEventChannel::instance()->notifyStatesChanged(entities);
+}
+
+void NotificationManager::emitStateChanged(const QList<qint64> &ids, int processedType)
+{
+    if (ids.size() == 1) {
+        Q_EMIT NotificationStateChanged(ids.first(), processedType);
+    } else if (!ids.isEmpty()) {
+        Q_EMIT NotificationStatesChanged(ids, processedType);
+    }
+}
+
 void NotificationManager::pushPendingEntity(const NotifyEntity &entity, int expireTimeout)
 {
     const int interval = expireTimeout == -1 ? DefaultTimeOutMSecs : expireTimeout;
@@ -445,35 +522,59 @@ void NotificationManager::updateEntityProcessed(qint64 id, uint reason)
 
 void NotificationManager::updateEntityProcessed(const NotifyEntity &entity)
 {
-    const auto id = entity.id();
-    const bool removed = entity.processedType() == NotifyEntity::Removed;
-    const auto showInCenter = m_setting->appValue(entity.appId(), NotificationSetting::ShowInCenter).toBool();
-    // "cancel"表示正在发送蓝牙文件,不需要发送到通知中心
-    const auto bluetooth = entity.body().contains("%") && entity.actions().contains("cancel");
-    if (removed || !showInCenter || bluetooth) {
-        m_persistence->removeEntity(id);
-        removePendingEntity(entity);
-    } else {
-        m_persistence->updateEntityProcessedType(id, entity.processedType());
-    }
-    Q_EMIT NotificationStateChanged(entity.id(), entity.processedType());
-
-    emitRecordCountChanged();
+    updateEntitiesProcessed({entity});
 }
 
-QString NotificationManager::appIdByAppName(const QString &appName) const
+void NotificationManager::updateEntitiesProcessed(const QList<NotifyEntity> &entities)
 {
-    const auto items = m_setting->appItems();
-    for (const auto &item: items) {
-        if (item.id == appName || item.appName == appName)
-            return item.id;
+    if (entities.isEmpty())
+        return;
+
+    QList<qint64> removedIds;
+    // indexes of the updated entities by processed type.
+    QMap<int, QList<int>> updatedIndexes;
+    for (int i = 0; i < entities.size(); i++) {
+        const auto &entity = entities[i];
+        const bool removed = entity.processedType() == NotifyEntity::Removed;
+        const auto showInCenter = m_setting->appValue(entity.appId(), NotificationSetting::ShowInCenter).toBool();
+        // "cancel"表示正在发送蓝牙文件,不需要发送到通知中心
+        const auto bluetooth = entity.body().contains("%") && entity.actions().contains("cancel");
+        if (removed || !showInCenter || bluetooth) {
+            removedIds << entity.id();
+            removePendingEntity(entity);
+        } else {
+            updatedIndexes[entity.processedType()] << i;
+        }
+    }
+
+    // each batch is written in one transaction instead of one per notification.
+    if (!removedIds.isEmpty())
+        m_persistence->removeEntities(removedIds);
+
+    // entities moved from memory to the DB get new ids, the panels receive the ids of the stored entities.
+    QList<qint64> storedIds(entities.size(), -1);
+    for (auto iter = updatedIndexes.constBegin(); iter != updatedIndexes.constEnd(); ++iter) {
+        QList<qint64> ids;
+        for (const auto index : iter.value())
+            ids << entities[index].id();
+        const auto newIds = m_persistence->processEntities(ids, iter.key());
+        for (int i = 0; i < newIds.size(); i++)
+            storedIds[iter.value()[i]] = newIds[i];
     }
 
-    if (m_appNamesMap.contains(appName)) {
-        return m_appNamesMap.value(appName).toString();
+    auto updatedEntities = entities;
+    for (int i = 0; i < updatedEntities.size(); i++) {
+        if (storedIds[i] > 0 && storedIds[i] != updatedEntities[i].id())
+            updatedEntities[i].setId(storedIds[i]);
     }
+    emitStatesChanged(updatedEntities);
 
-    return QString();
+    emitRecordCountChanged();
+}
+
+QString NotificationManager::appIdByAppName(const QString &appName) const
+{
+    return m_setting->appIdByName(appName);
 }
 
 void NotificationManager::doActionInvoked(const NotifyEntity &entity, const QString &actionId)
@@ -585,9 +686,63 @@ void NotificationManager::onHandingPendingEntities()
         m_lastTimeoutPoint = std::numeric_limits<qint64>::max();
     }
 
+    QList<NotifyEntity> expiredEntities;
+    expiredEntities.reserve(timeoutEntities.size());
     for (const auto &item : timeoutEntities) {
         qDebug(notifyLog) << "Expired for the notification " << item.id() << item.appName();
-        notificationClosed(item.id(), item.bubbleId(), NotifyEntity::Expired);
+        auto entity = m_persistence->fetchEntity(item.id());
+        if (!entity.isValid())
+            continue;
+        entity.setProcessedType(NotifyEntity::Processed);
+        expiredEntities << entity;
+    }
+    updateEntitiesProcessed(expiredEntities);
+
+    for (const auto &item : timeoutEntities) {
+        Q_EMIT NotificationClosed(item.bubbleId(), NotifyEntity::Expired);
+    }
+}
+
+void NotificationManager::onHandingFloods()
+{
+    const auto current = QDateTime::currentMSecsSinceEpoch();
+    const auto floods = m_rateLimiter->takeFloods(current);
+    if (const auto next = m_rateLimiter->nextFloodCheck(); next > 0) {
+        m_floodTimeout->start(static_cast<int>(std::max<qint64>(0, next - current)));
+    }
+
+    // the collapsed notifies of a flood are recorded as one entity in the notification center.
+    QList<NotifyEntity> collapsedEntities;
+    for (const auto &flood : floods) {
+        qInfo(notifyLog) << "Collapsed notifications of the app" << flood.appId << ", count:" << flood.count;
+        if (!m_setting->appSettings(flood.appId).showInCenter)
+            continue;
+
+        NotifyEntity entity = flood.lastEntity;
+        // the images of the collapsed notifies aren't decoded, only the one recorded is.
+        auto icon = entity.appIcon();
+        auto hints = entity.hints();
+        NotifyImageCache::instance()->decode(icon, hints);
+        entity.setAppIcon(icon);
+        entity.setHints(hints);
+        entity.setBody(flood.lastEntity.summary());
+        entity.setSummary(tr("%1 notifications were collapsed").arg(flood.count));
+        entity.setActionString(QString());
+        entity.setBubbleId(flood.bubbleId);
+        entity.setProcessedType(NotifyEntity::Processed);
+
+        const auto id = m_persistence->addEntity(entity);
+        if (id == -1) {
+            qWarning(notifyLog) << "Failed on saving collapsed notifications of the app" << flood.appId;
+            continue;
+        }
+        entity.setId(id);
+        collapsedEntities << entity;
+    }
+
+    if (!collapsedEntities.isEmpty()) {
+        emitStatesChanged(collapsedEntities);
+        emitRecordCountChanged();
     }
 }
 
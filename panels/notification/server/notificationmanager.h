@@ -15,8 +15,9 @@ using UserSessionManager = org::deepin::dde::SessionManager1;
 namespace notification {
 
 class NotifyEntity;
-class DataAccessor;
+class DataAccessorProxy;
 class NotificationSetting;
+class NotifyRateLimiter;
 
 class NotificationManager : public QObject, public QDBusContext
 {
@@ -51,6 +52,8 @@ Q_SIGNALS:
     void AppRemoved(const QString &id);
 
     void NotificationStateChanged(qint64 id, int processedType);
+    // a batch of notifications changed to the same state, it's emitted instead of one NotificationStateChanged each.
+    void NotificationStatesChanged(const QList<qint64> &ids, int processedType);
 
 public Q_SLOTS:
     // Standard Notifications dbus implementation
@@ -67,14 +70,19 @@ public Q_SLOTS:
     void SetSystemInfo(uint configItem, const QVariant &value);
     QVariant GetSystemInfo(uint configItem);
 
+    QString GetRateLimitStatistics();
+
 private:
     bool isDoNotDisturb() const;
     void tryPlayNotificationSound(const NotifyEntity &entity, const QString &appId, bool dndMode) const;
     void emitRecordCountChanged();
+    void emitStatesChanged(const QList<NotifyEntity> &entities);
+    void emitStateChanged(const QList<qint64> &ids, int processedType);
 
     void pushPendingEntity(const NotifyEntity &entity, int expireTimeout);
     void updateEntityProcessed(qint64 id, uint reason);
     void updateEntityProcessed(const NotifyEntity &entity);
+    void updateEntitiesProcessed(const QList<NotifyEntity> &entities);
 
     QString appIdByAppName(const QString &appName) const;
     void doActionInvoked(const NotifyEntity &entity, const QString &actionId);
@@ -82,19 +90,21 @@ private:
 
 private slots:
     void onHandingPendingEntities();
+    void onHandingFloods();
     void removePendingEntity(const NotifyEntity &entity);
 
 private:
     uint m_replacesCount = 0;
 
-    DataAccessor *m_persistence = nullptr;
+    DataAccessorProxy *m_persistence = nullptr;
     NotificationSetting *m_setting = nullptr;
     UserSessionManager *m_userSessionManager = nullptr;
     QTimer *m_pendingTimeout = nullptr;
     qint64 m_lastTimeoutPoint = std::numeric_limits<qint64>::max();
     QMultiHash<qint64, NotifyEntity> m_pendingTimeoutEntities;
     QStringList m_systemApps;
-    QMap<QString, QVariant> m_appNamesMap;
+    NotifyRateLimiter *m_rateLimiter = nullptr;
+    QTimer *m_floodTimeout = nullptr;
 };
 
 } // notification
@@ -7,6 +7,10 @@
 #include <QVariant>
 #include <QAbstractListModel>
 #include <QLoggingCategory>
+#include <QReadLocker>
+#include <QWriteLocker>
+
+#include <algorithm>
 
 #include <DConfig>
 
@@ -15,7 +19,6 @@ Q_DECLARE_LOGGING_CATEGORY(notifyLog)
 }
 namespace notification {
 
-static const QString InvalidApp {"DS-Invalid-Apps"};
 namespace {
 enum Roles {
     DesktopIdRole = 0x1000,
@@ -39,10 +42,13 @@ NotificationSetting::NotificationSetting(QObject *parent)
     : QObject(parent)
     , m_impl(Dtk::Core::DConfig::create("org.deepin.dde.shell", "org.deepin.dde.shell.notification", QString(), this))
 {
-    invalidAppItemCached();
+    updateAppsInfo();
+    updateAppNamesMap();
     connect(m_impl, &Dtk::Core::DConfig::valueChanged, this, [this] (const QString &key) {
         if (key == "appsInfo") {
-            invalidAppItemCached();
+            updateAppsInfo();
+        } else if (key == "AppNamesMap") {
+            updateAppNamesMap();
         } else {
             static const QStringList
                 keys{"dndMode", "openByTimeInterval", "lockScreenOpenDndMode", "startTime", "endTime", "notificationClosed", "maxCount", "bubbleCount"};
@@ -56,8 +62,23 @@ NotificationSetting::NotificationSetting(QObject *parent)
 void NotificationSetting::setAppAccessor(QAbstractItemModel *model)
 {
     m_appAccessor = model;
-    QObject::connect(m_appAccessor, &QAbstractItemModel::rowsInserted, this, &NotificationSetting::onAppsChanged);
-    QObject::connect(m_appAccessor, &QAbstractItemModel::rowsRemoved, this, &NotificationSetting::onAppsChanged);
+    // the setting lives in the thread of NotificationManager, not of the model, the rows are read
+    // on the model's thread while they still exist, and the index is published under m_appItemsLock.
+    QObject::connect(m_appAccessor, &QAbstractItemModel::rowsInserted, this, &NotificationSetting::onAppsInserted, Qt::DirectConnection);
+    QObject::connect(m_appAccessor, &QAbstractItemModel::rowsAboutToBeRemoved, this, &NotificationSetting::onAppsAboutToBeRemoved, Qt::DirectConnection);
+    QObject::connect(m_appAccessor, &QAbstractItemModel::rowsRemoved, this, &NotificationSetting::onAppsRemoved, Qt::DirectConnection);
+    QObject::connect(m_appAccessor, &QAbstractItemModel::dataChanged, this, &NotificationSetting::onAppsDataChanged, Qt::DirectConnection);
+    QObject::connect(m_appAccessor, &QAbstractItemModel::modelReset, this, &NotificationSetting::onAppsReset, Qt::DirectConnection);
+
+    QWriteLocker locker(&m_appItemsLock);
+    m_appItems.clear();
+    m_appIds.clear();
+    m_appIdsByName.clear();
+    for (int i = 0; i < m_appAccessor->rowCount(); i++) {
+        AppItem app;
+        if (appItemAt(i, app))
+            insertAppItem(app);
+    }
 }
 
 QAbstractItemModel *NotificationSetting::appAccessor() const
@@ -100,6 +121,7 @@ void NotificationSetting::setAppValue(const QString &id, AppConfigItem item, con
     {
         QMutexLocker locker(&m_appsInfoMutex);
         m_appsInfo[id] = info;
+        m_appSettings.remove(id);
         m_impl->setValue("appsInfo", m_appsInfo);
     }
 
@@ -108,37 +130,36 @@ void NotificationSetting::setAppValue(const QString &id, AppConfigItem item, con
 
 QVariant NotificationSetting::appValue(const QString &id, AppConfigItem item)
 {
-    const auto app = appItem(id);
     switch (item) {
     case AppName: {
-        return app.appName;
+        return appItem(id).appName;
     }
     case AppIcon: {
-        return app.appIcon;
+        return appItem(id).appIcon;
     default:
         break;
     }
     }
 
-    const auto info = appInfo(id);
+    const auto settings = appSettings(id);
     switch (item) {
     case EnableNotification: {
-        return info.value("enabled", true);
+        return settings.enabled;
     }
     case EnablePreview: {
-        return info.value("enablePreview", true);
+        return settings.enablePreview;
     }
     case EnableSound: {
-        return info.value("enableSound", true);
+        return settings.enableSound;
     }
     case ShowInCenter: {
-        return info.value("showInCenter", true);
+        return settings.showInCenter;
     }
     case ShowOnLockScreen: {
-        return info.value("showOnLockScreen", true);
+        return settings.showOnLockScreen;
     }
     case ShowOnDesktop: {
-        return info.value("showOnDesktop", true);
+        return settings.showOnDesktop;
     }
     default:
         break;
@@ -207,121 +228,259 @@ QVariant NotificationSetting::systemValue(NotificationSetting::SystemConfigItem
 
 QStringList NotificationSetting::apps() const
 {
-    QStringList ret;
-    for (const auto &item : appItems()) {
-        ret << item.id;
-    }
-    return ret;
+    QReadLocker locker(&m_appItemsLock);
+    return m_appIds;
 }
 
 NotificationSetting::AppItem NotificationSetting::appItem(const QString &id) const
 {
-    const auto infos = appItems();
-    auto iter = std::find_if(infos.begin(), infos.end(), [id] (const AppItem &item) {
-        return id == item.id;
-    });
-    if (iter != infos.end()) {
-        return *iter;
-    }
-
-    return {};
+    QReadLocker locker(&m_appItemsLock);
+    return m_appItems.value(id);
 }
 
 QList<NotificationSetting::AppItem> NotificationSetting::appItems() const
 {
-    QMutexLocker locker(&(const_cast<NotificationSetting *>(this)->m_appItemsMutex));
-    if (!m_appItems.isEmpty())
-        return m_appItems;
-
-    QList<NotificationSetting::AppItem> apps = appItemsImpl();
-    const_cast<NotificationSetting *>(this)->m_appItems = apps;
-    return m_appItems;
+    QReadLocker locker(&m_appItemsLock);
+    QList<AppItem> apps;
+    apps.reserve(m_appIds.size());
+    for (const auto &id : m_appIds)
+        apps.append(m_appItems.value(id));
+    return apps;
 }
 
-QList<NotificationSetting::AppItem> NotificationSetting::appItemsImpl() const
+QString NotificationSetting::appIdByName(const QString &appName) const
 {
-    if (!m_appAccessor)
-        return {};
+    QReadLocker locker(&m_appItemsLock);
+    if (m_appItems.contains(appName))
+        return appName;
 
-    QList<NotificationSetting::AppItem> apps;
-    apps.reserve(m_appAccessor->rowCount());
-    for (int i = 0; i < m_appAccessor->rowCount(); i++) {
-        const auto index = m_appAccessor->index(i, 0);
-        const auto nodisplay = m_appAccessor->data(index, NoDisplayRole).toBool();
-        if (nodisplay)
-            continue;
-
-        const auto desktopId = m_appAccessor->data(index, DesktopIdRole).toString();
-        const auto icon = m_appAccessor->data(index, IconNameRole).toString();
-        const auto name = m_appAccessor->data(index, NameRole).toString();
+    if (auto iter = m_appIdsByName.constFind(appName); iter != m_appIdsByName.constEnd())
+        return iter.value();
 
-        NotificationSetting::AppItem item;
-        item.id = desktopId;
-        item.appIcon = icon;
-        item.appName = name;
-        apps << item;
-    }
-    return apps;
+    return m_appNamesMap.value(appName);
 }
 
 QVariantMap NotificationSetting::appInfo(const QString &id) const
 {
-    QMutexLocker locker(&(const_cast<NotificationSetting *>(this)->m_appsInfoMutex));
-    if (m_appsInfo.contains(InvalidApp)) {
-        const_cast<NotificationSetting *>(this)->m_appsInfo = m_impl->value("appsInfo").toMap();
-    }
+    QMutexLocker locker(&m_appsInfoMutex);
     if (auto iter = m_appsInfo.find(id); iter != m_appsInfo.end()) {
         return iter.value().toMap();
     }
     return {};
 }
 
-void NotificationSetting::onAppsChanged()
+NotificationSetting::AppSettings NotificationSetting::appSettings(const QString &id) const
 {
-    const auto old = appItems();
-    const auto current = appItemsImpl();
-
-    QList<NotificationSetting::AppItem> added;
-    for (auto item : current) {
-        const auto id = item.id;
-        auto iter = std::find_if(old.begin(), old.end(), [id] (const NotificationSetting::AppItem &app) {
-            return id == app.id;
-        });
-        if (iter == old.end()) {
-            added << item;
+    QMutexLocker locker(&m_appsInfoMutex);
+    if (auto iter = m_appSettings.constFind(id); iter != m_appSettings.constEnd())
+        return iter.value();
+
+    const auto info = m_appsInfo.value(id).toMap();
+    AppSettings settings;
+    settings.enabled = info.value("enabled", true).toBool();
+    settings.enablePreview = info.value("enablePreview", true).toBool();
+    settings.enableSound = info.value("enableSound", true).toBool();
+    settings.showInCenter = info.value("showInCenter", true).toBool();
+    settings.showOnLockScreen = info.value("showOnLockScreen", true).toBool();
+    settings.showOnDesktop = info.value("showOnDesktop", true).toBool();
+    m_appSettings.insert(id, settings);
+    return settings;
+}
+
+void NotificationSetting::onAppsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+
+    QStringList added;
+    {
+        QWriteLocker locker(&m_appItemsLock);
+        for (int i = first; i <= last; i++) {
+            AppItem app;
+            if (!appItemAt(i, app) || m_appItems.contains(app.id))
+                continue;
+            insertAppItem(app);
+            added << app.id;
         }
     }
-    for (auto item : added) {
-        qDebug(notifyLog) << "Application added" << item.id;
-        Q_EMIT appAdded(item.id);
+    for (const auto &id : std::as_const(added)) {
+        qDebug(notifyLog) << "Application added" << id;
+        Q_EMIT appAdded(id);
     }
+}
+
+void NotificationSetting::onAppsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid())
+        return;
+
+    for (int i = first; i <= last; i++) {
+        const auto index = m_appAccessor->index(i, 0);
+        m_removingApps << m_appAccessor->data(index, DesktopIdRole).toString();
+    }
+}
+
+void NotificationSetting::onAppsRemoved()
+{
+    QStringList removed;
+    {
+        QWriteLocker locker(&m_appItemsLock);
+        for (const auto &id : std::as_const(m_removingApps)) {
+            if (!m_appItems.contains(id))
+                continue;
+            removeAppItem(id);
+            removed << id;
+        }
+        m_removingApps.clear();
+    }
+    for (const auto &id : std::as_const(removed)) {
+        qDebug(notifyLog) << "Application removed" << id;
+        Q_EMIT appRemoved(id);
+    }
+}
 
-    QList<NotificationSetting::AppItem> removed;
-    for (auto item : old) {
-        const auto id = item.id;
-        auto iter = std::find_if(current.begin(), current.end(), [id] (const NotificationSetting::AppItem &app) {
-            return id == app.id;
-        });
-        if (iter == current.end()) {
-            removed << item;
+void NotificationSetting::onAppsDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    if (topLeft.parent().isValid())
+        return;
+
+    QStringList added;
+    QStringList removed;
+    {
+        QWriteLocker locker(&m_appItemsLock);
+        for (int i = topLeft.row(); i <= bottomRight.row(); i++) {
+            const auto id = m_appAccessor->data(m_appAccessor->index(i, 0), DesktopIdRole).toString();
+            const bool exists = m_appItems.contains(id);
+            AppItem app;
+            if (appItemAt(i, app)) {
+                if (exists)
+                    removeAppItem(id);
+                else
+                    added << id;
+                insertAppItem(app);
+            } else if (exists) {
+                // changed to NoDisplay
+                removeAppItem(id);
+                removed << id;
+            }
         }
     }
-    for (auto item : removed) {
-        qDebug(notifyLog) << "Application removed" << item.id;
-        Q_EMIT appRemoved(item.id);
+    for (const auto &id : std::as_const(added)) {
+        Q_EMIT appAdded(id);
+    }
+    for (const auto &id : std::as_const(removed)) {
+        Q_EMIT appRemoved(id);
+    }
+}
+
+void NotificationSetting::onAppsReset()
+{
+    QHash<QString, AppItem> current;
+    for (int i = 0; i < m_appAccessor->rowCount(); i++) {
+        AppItem app;
+        if (appItemAt(i, app))
+            current.insert(app.id, app);
     }
 
+    QStringList added;
+    QStringList removed;
     {
-        QMutexLocker locker(&m_appItemsMutex);
-        m_appItems = current;
+        QWriteLocker locker(&m_appItemsLock);
+        for (auto iter = current.cbegin(); iter != current.cend(); ++iter) {
+            if (!m_appItems.contains(iter.key()))
+                added << iter.key();
+        }
+        for (auto iter = m_appItems.cbegin(); iter != m_appItems.cend(); ++iter) {
+            if (!current.contains(iter.key()))
+                removed << iter.key();
+        }
+
+        m_appItems.clear();
+        m_appIds.clear();
+        m_appIdsByName.clear();
+        for (const auto &app : std::as_const(current)) {
+            insertAppItem(app);
+        }
     }
+    for (const auto &id : std::as_const(added)) {
+        qDebug(notifyLog) << "Application added" << id;
+        Q_EMIT appAdded(id);
+    }
+    for (const auto &id : std::as_const(removed)) {
+        qDebug(notifyLog) << "Application removed" << id;
+        Q_EMIT appRemoved(id);
+    }
+}
+
+bool NotificationSetting::appItemAt(int row, AppItem &app) const
+{
+    const auto index = m_appAccessor->index(row, 0);
+    const auto nodisplay = m_appAccessor->data(index, NoDisplayRole).toBool();
+    if (nodisplay)
+        return false;
+
+    app.id = m_appAccessor->data(index, DesktopIdRole).toString();
+    app.appIcon = m_appAccessor->data(index, IconNameRole).toString();
+    app.appName = m_appAccessor->data(index, NameRole).toString();
+    return true;
 }
 
-void NotificationSetting::invalidAppItemCached()
+// the caller should hold m_appItemsLock for writing.
+void NotificationSetting::insertAppItem(const AppItem &app)
 {
+    if (!m_appItems.contains(app.id))
+        m_appIds.insert(std::lower_bound(m_appIds.begin(), m_appIds.end(), app.id), app.id);
+    m_appItems.insert(app.id, app);
+    if (!app.appName.isEmpty() && !m_appIdsByName.contains(app.appName))
+        m_appIdsByName.insert(app.appName, app.id);
+}
+
+// the caller should hold m_appItemsLock for writing.
+void NotificationSetting::removeAppItem(const QString &id)
+{
+    const auto app = m_appItems.take(id);
+    if (auto iter = std::lower_bound(m_appIds.begin(), m_appIds.end(), id); iter != m_appIds.end() && *iter == id)
+        m_appIds.erase(iter);
+    if (m_appIdsByName.value(app.appName) != id)
+        return;
+
+    // apps may have the same name, keep resolving the name to one of the others.
+    m_appIdsByName.remove(app.appName);
+    for (const auto &otherId : std::as_const(m_appIds)) {
+        if (m_appItems.value(otherId).appName == app.appName) {
+            m_appIdsByName.insert(app.appName, otherId);
+            break;
+        }
+    }
+}
+
+void NotificationSetting::updateAppsInfo()
+{
+    const auto appsInfo = m_impl->value("appsInfo").toMap();
+
     QMutexLocker locker(&m_appsInfoMutex);
-    m_appsInfo.clear();
-    m_appsInfo[InvalidApp] = QVariant();
+    // only the apps whose config is changed are resolved again.
+    for (auto iter = m_appSettings.begin(); iter != m_appSettings.end();) {
+        if (m_appsInfo.value(iter.key()) != appsInfo.value(iter.key())) {
+            iter = m_appSettings.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+    m_appsInfo = appsInfo;
+}
+
+void NotificationSetting::updateAppNamesMap()
+{
+    // TODO temporary fix for AppNamesMap
+    const auto appNamesMap = m_impl->value("AppNamesMap").toMap();
+    QHash<QString, QString> names;
+    for (auto iter = appNamesMap.cbegin(); iter != appNamesMap.cend(); ++iter) {
+        names.insert(iter.key(), iter.value().toString());
+    }
+
+    QWriteLocker locker(&m_appItemsLock);
+    m_appNamesMap.swap(names);
 }
 
 QVariant NotificationSetting::systemValue(const QString &key, const QVariant &fallback)
@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include <QHash>
 #include <QMutex>
 #include <QObject>
+#include <QReadWriteLock>
 #include <QTimer>
 #include <QVariantMap>
 
@@ -16,6 +18,7 @@ namespace Core {
 }
 
 class QAbstractItemModel;
+class QModelIndex;
 namespace notification {
 
 class NotificationSetting : public QObject
@@ -51,6 +54,16 @@ public:
         QString appName;
         QString appIcon;
     };
+
+    // per app config of `appsInfo`, resolved once for every app.
+    struct AppSettings {
+        bool enabled = true;
+        bool enablePreview = true;
+        bool enableSound = true;
+        bool showInCenter = true;
+        bool showOnLockScreen = true;
+        bool showOnDesktop = true;
+    };
     // clang-format on
 
 public:
@@ -68,9 +81,10 @@ public:
     QStringList apps() const;
     AppItem appItem(const QString &id) const;
     QList<AppItem> appItems() const;
-    QList<AppItem> appItemsImpl() const;
+    QString appIdByName(const QString &appName) const;
 
     QVariantMap appInfo(const QString &id) const;
+    AppSettings appSettings(const QString &id) const;
 
 signals:
     void appAdded(const QString &appId);
@@ -79,20 +93,36 @@ signals:
     void systemValueChanged(uint configItem, const QVariant &value);
 
 private slots:
-    void onAppsChanged();
+    void onAppsInserted(const QModelIndex &parent, int first, int last);
+    void onAppsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void onAppsRemoved();
+    void onAppsDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void onAppsReset();
 
 private:
-    void updateAppItemValue(const QVariantMap &info, AppItem &app) const;
-    void invalidAppItemCached();
+    bool appItemAt(int row, AppItem &app) const;
+    void insertAppItem(const AppItem &app);
+    void removeAppItem(const QString &id);
+    void updateAppsInfo();
+    void updateAppNamesMap();
     QVariant systemValue(const QString &key, const QVariant &fallback);
 
 private:
     Dtk::Core::DConfig *m_impl = nullptr;
     QAbstractItemModel *m_appAccessor = nullptr;
-    QList<AppItem> m_appItems;
-    QMutex m_appItemsMutex;
+    // apps index of the app model, guarded by m_appItemsLock.
+    QHash<QString, AppItem> m_appItems;
+    // ids of m_appItems in ascending order, apps are listed in a stable order.
+    QStringList m_appIds;
+    QHash<QString, QString> m_appIdsByName;
+    QHash<QString, QString> m_appNamesMap;
+    // only accessed on the thread of m_appAccessor.
+    QStringList m_removingApps;
+    mutable QReadWriteLock m_appItemsLock;
+    // `appsInfo` of DConfig and the settings resolved from it, guarded by m_appsInfoMutex.
     QVariantMap m_appsInfo;
-    QMutex m_appsInfoMutex;
+    mutable QHash<QString, AppSettings> m_appSettings;
+    mutable QMutex m_appsInfoMutex;
     QVariantMap m_systemInfo;
 };
 
@@ -0,0 +1,154 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include "notifyratelimiter.h"
+
+#include <QJsonObject>
+
+namespace notification {
+
+void NotifyRateLimiter::setBurst(int burst)
+{
+    m_burst = std::max(1, burst);
+}
+
+void NotifyRateLimiter::setRefillInterval(int msecs)
+{
+    m_refillInterval = std::max(1, msecs);
+}
+
+NotifyRateLimiter::Bucket &NotifyRateLimiter::bucket(const QString &appId, qint64 now)
+{
+    auto iter = m_buckets.find(appId);
+    if (iter == m_buckets.end()) {
+        Bucket bucket;
+        bucket.tokens = m_burst;
+        bucket.lastRefill = now;
+        iter = m_buckets.insert(appId, bucket);
+    }
+
+    auto &bucket = iter.value();
+    if (now > bucket.lastRefill) {
+        bucket.tokens = std::min<double>(m_burst, bucket.tokens + double(now - bucket.lastRefill) / m_refillInterval);
+        bucket.lastRefill = now;
+    }
+    return bucket;
+}
+
+bool NotifyRateLimiter::acquire(const QString &appId, qint64 now)
+{
+    auto &bucket = this->bucket(appId, now);
+    if (bucket.tokens < 1)
+        return false;
+
+    bucket.tokens -= 1;
+    bucket.accepted++;
+    return true;
+}
+
+void NotifyRateLimiter::collapse(const QString &appId, uint bubbleId, const NotifyEntity &entity, qint64 now)
+{
+    auto &bucket = this->bucket(appId, now);
+    if (bucket.pendingCollapsed <= 0) {
+        bucket.floods++;
+        bucket.floodBubbleId = bubbleId;
+    }
+
+    bucket.pendingCollapsed++;
+    bucket.collapsed++;
+    bucket.lastCollapsed = now;
+    bucket.lastCollapsedEntity = entity;
+}
+
+uint NotifyRateLimiter::floodBubbleId(const QString &appId) const
+{
+    const auto iter = m_buckets.constFind(appId);
+    if (iter == m_buckets.constEnd() || iter.value().pendingCollapsed <= 0)
+        return 0;
+    return iter.value().floodBubbleId;
+}
+
+QString NotifyRateLimiter::floodAppId(uint bubbleId) const
+{
+    if (bubbleId == 0)
+        return {};
+
+    for (auto iter = m_buckets.cbegin(); iter != m_buckets.cend(); ++iter) {
+        if (iter.value().pendingCollapsed > 0 && iter.value().floodBubbleId == bubbleId)
+            return iter.key();
+    }
+    return {};
+}
+
+bool NotifyRateLimiter::dropFlood(uint bubbleId)
+{
+    const auto appId = floodAppId(bubbleId);
+    if (appId.isEmpty())
+        return false;
+
+    auto &bucket = m_buckets[appId];
+    bucket.pendingCollapsed = 0;
+    bucket.floodBubbleId = 0;
+    bucket.lastCollapsedEntity = {};
+    return true;
+}
+
+bool NotifyRateLimiter::acquireSound(const QString &appId, qint64 now)
+{
+    auto &bucket = this->bucket(appId, now);
+    if (bucket.lastSound > 0 && now - bucket.lastSound < SoundInterval) {
+        bucket.soundsThrottled++;
+        return false;
+    }
+    bucket.lastSound = now;
+    return true;
+}
+
+QList<NotifyRateLimiter::Flood> NotifyRateLimiter::takeFloods(qint64 now)
+{
+    QList<Flood> ret;
+    for (auto iter = m_buckets.begin(); iter != m_buckets.end(); ++iter) {
+        auto &bucket = iter.value();
+        if (bucket.pendingCollapsed <= 0 || now - bucket.lastCollapsed < FloodQuietInterval)
+            continue;
+
+        ret.append({iter.key(), bucket.floodBubbleId, bucket.lastCollapsedEntity, bucket.pendingCollapsed});
+        bucket.pendingCollapsed = 0;
+        bucket.floodBubbleId = 0;
+        bucket.lastCollapsedEntity = {};
+    }
+    return ret;
+}
+
+qint64 NotifyRateLimiter::nextFloodCheck() const
+{
+    qint64 next = 0;
+    for (const auto &bucket : std::as_const(m_buckets)) {
+        if (bucket.pendingCollapsed <= 0)
+            continue;
+        const auto time = bucket.lastCollapsed + FloodQuietInterval;
+        if (next <= 0 || time < next)
+            next = time;
+    }
+    return next;
+}
+
+QJsonArray NotifyRateLimiter::statistics() const
+{
+    QJsonArray ret;
+    for (auto iter = m_buckets.cbegin(); iter != m_buckets.cend(); ++iter) {
+        const auto &bucket = iter.value();
+        QJsonObject item;
+        item["appId"] = iter.key();
+        item["accepted"] = static_cast<qint64>(bucket.accepted);
+        item["collapsed"] = static_cast<qint64>(bucket.collapsed);
+        item["floods"] = static_cast<qint64>(bucket.floods);
+        item["soundsThrottled"] = static_cast<qint64>(bucket.soundsThrottled);
+        item["flooding"] = bucket.pendingCollapsed > 0;
+        ret.append(item);
+    }
+    return ret;
+}
+
+}
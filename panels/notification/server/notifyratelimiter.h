@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include <QHash>
+#include <QJsonArray>
+#include <QString>
+
+#include "notifyentity.h"
+
+namespace notification {
+
+/**
+ * @brief The NotifyRateLimiter class
+ * Token bucket of every app, an app can send `burst` notifies at once,
+ * and gets one more every `refillInterval` milliseconds.
+ * The notifies over the rate are collapsed, and reported by `takeFloods` when the flood is over.
+ * The collapsed notifies of a flood share the bubble id of the entity recording the flood.
+ */
+class NotifyRateLimiter
+{
+public:
+    struct Flood {
+        QString appId;
+        uint bubbleId = 0;
+        NotifyEntity lastEntity;
+        int count = 0;
+    };
+
+    void setBurst(int burst);
+    void setRefillInterval(int msecs);
+
+    bool acquire(const QString &appId, qint64 now);
+    // `bubbleId` is only used if it starts a flood of the app.
+    void collapse(const QString &appId, uint bubbleId, const NotifyEntity &entity, qint64 now);
+    // the bubble id of the current flood of the app, 0 if it isn't flooding.
+    uint floodBubbleId(const QString &appId) const;
+    // the app whose current flood has the bubble id, empty if no flood has it.
+    QString floodAppId(uint bubbleId) const;
+    // the flood isn't reported, returns false if no flood has the bubble id.
+    bool dropFlood(uint bubbleId);
+    bool acquireSound(const QString &appId, qint64 now);
+
+    QList<Flood> takeFloods(qint64 now);
+    // the time the next flood may be over, 0 if no app is flooding.
+    qint64 nextFloodCheck() const;
+
+    QJsonArray statistics() const;
+
+public:
+    // a flood is over when no notify is collapsed in this interval.
+    static const int FloodQuietInterval = 2000;
+    static const int SoundInterval = 1000;
+
+private:
+    struct Bucket {
+        double tokens = 0;
+        qint64 lastRefill = 0;
+        qint64 lastSound = 0;
+        qint64 lastCollapsed = 0;
+        NotifyEntity lastCollapsedEntity;
+        uint floodBubbleId = 0;
+        int pendingCollapsed = 0;
+        // statistics
+        quint64 accepted = 0;
+        quint64 collapsed = 0;
+        quint64 floods = 0;
+        quint64 soundsThrottled = 0;
+    };
+    Bucket &bucket(const QString &appId, qint64 now);
+
+private:
+    QHash<QString, Bucket> m_buckets;
+    int m_burst = 10;
+    int m_refillInterval = 500;
+};
+
+}
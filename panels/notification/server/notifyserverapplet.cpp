@@ -5,6 +5,7 @@
 #include "notifyserverapplet.h"
 #include "notificationmanager.h"
 #include "dbusadaptor.h"
+#include "notifyeventchannel.h"
 #include "pluginfactory.h"
 
 namespace notification {
@@ -22,6 +23,7 @@ NotifyServerApplet::NotifyServerApplet(QObject *parent)
 NotifyServerApplet::~NotifyServerApplet()
 {
     qDebug(notifyLog) << "Exit notification server.";
+    NotifyEventChannel::instance()->setAppValueProvider(nullptr);
     if (m_manager) {
         m_manager->deleteLater();
     }
@@ -52,6 +54,16 @@ bool NotifyServerApplet::init()
     new DDENotificationDbusAdaptor(m_manager);
 
     connect(m_manager, &NotificationManager::NotificationStateChanged, this, &NotifyServerApplet::notificationStateChanged);
+    connect(m_manager, &NotificationManager::NotificationStatesChanged, this, &NotifyServerApplet::notificationStatesChanged);
+
+    // the panels in this process call the server through the typed channel, the requests are handled
+    // on the thread of the manager.
+    auto channel = NotifyEventChannel::instance();
+    connect(channel, &NotifyEventChannel::actionInvokeRequested, m_manager, &NotificationManager::actionInvoked, Qt::QueuedConnection);
+    connect(channel, &NotifyEventChannel::closeRequested, m_manager, &NotificationManager::notificationClosed, Qt::QueuedConnection);
+    channel->setAppValueProvider([this](const QString &appId, int configItem) {
+        return appValue(appId, configItem);
+    });
 
     m_worker = new QThread();
     m_manager->moveToThread(m_worker);
@@ -61,12 +73,12 @@ bool NotifyServerApplet::init()
 
 void NotifyServerApplet::actionInvoked(qint64 id, uint bubbleId, const QString &actionKey)
 {
-    QMetaObject::invokeMethod(m_manager, "actionInvoked", Qt::DirectConnection, Q_ARG(qint64, id), Q_ARG(uint, bubbleId), Q_ARG(QString, actionKey));
+    m_manager->actionInvoked(id, bubbleId, actionKey);
 }
 
 void NotifyServerApplet::notificationClosed(qint64 id, uint bubbleId, uint reason)
 {
-    QMetaObject::invokeMethod(m_manager, "notificationClosed", Qt::DirectConnection, Q_ARG(qint64, id), Q_ARG(uint, bubbleId), Q_ARG(uint, reason));
+    m_manager->notificationClosed(id, bubbleId, reason);
 }
 
 QVariant NotifyServerApplet::appValue(const QString &appId, int configItem)
@@ -21,6 +21,7 @@ public:
 
 Q_SIGNALS:
     void notificationStateChanged(qint64 id, int processedType);
+    void notificationStatesChanged(const QList<qint64> &ids, int processedType);
 
 public Q_SLOTS:
     void actionInvoked(qint64 id, uint bubbleId, const QString &actionKey);
@@ -134,16 +134,19 @@ void DAppletLoaderPrivate::doCreateRootObject(DApplet *applet)
 
     DQmlEngine *engine = new DQmlEngine(applet, applet);
     QObject::connect(engine, &DQmlEngine::createFinished, applet, [this, applet, engine]() {
-        auto rootObject = engine->rootObject();
-        applet->setRootObject(rootObject);
-        engine->completeCreate();
-        if (!rootObject) {
+        if (!engine->rootObject()) {
             D_Q(DAppletLoader);
             qCWarning(dsLoaderLog) << "Create root failed:" << applet->pluginId();
             Q_EMIT q->failed(applet->pluginId());
-        } else {
-            qCDebug(dsLoaderLog) << "Created rootObject for the applet:" << applet->pluginId();
+            return;
         }
+        engine->completeCreate();
+    });
+    // the root object is handed to the applet once its bindings are evaluated, users of rootObjectChanged
+    // read the properties of the window.
+    QObject::connect(engine, &DQmlEngine::finished, applet, [applet, engine]() {
+        applet->setRootObject(engine->rootObject());
+        qCDebug(dsLoaderLog) << "Created rootObject for the applet:" << applet->pluginId();
     });
 
     qCDebug(dsLoaderLog) << "Begin to create rootObject the applet:" << applet->pluginId();
@@ -53,6 +53,8 @@ public:
         auto rootApplet = qobject_cast<DContainment *>(DPluginLoader::instance()->rootApplet());
         Q_ASSERT(rootApplet);
 
+        preloadQml(pluginIds);
+
         for (const auto &pluginId : pluginIds) {
             auto applet = rootApplet->createApplet(DAppletData{pluginId});
             if (!applet) {
@@ -71,6 +73,22 @@ public:
             });
         }
     }
+    // start compiling qml in background before loaders ask for it.
+    void preloadQml(const QStringList &pluginIds)
+    {
+        QList<QUrl> urls = DQmlEngine::frameUrls();
+        QStringList pending = pluginIds;
+        while (!pending.isEmpty()) {
+            const auto plugin = DPluginLoader::instance()->plugin(pending.takeFirst());
+            if (!plugin.isValid())
+                continue;
+            if (!plugin.url().isEmpty())
+                urls << QUrl(plugin.url());
+            for (const auto &child : DPluginLoader::instance()->childrenPlugin(plugin.pluginId()))
+                pending << child.pluginId();
+        }
+        DQmlEngine::preload(urls);
+    }
     void enableSceneview()
     {
         auto rootApplet = qobject_cast<DContainment *>(DPluginLoader::instance()->rootApplet());
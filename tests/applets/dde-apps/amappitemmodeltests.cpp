@@ -0,0 +1,141 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QDBusConnection>
+#include <QDBusMetaType>
+#include <QSignalSpy>
+
+#include "amappitem.h"
+#include "amappitemmodel.h"
+
+using namespace apps;
+
+static const QString AMService = "org.desktopspec.ApplicationManager1";
+static const QString AMPath = "/org/desktopspec/ApplicationManager1";
+
+// serves the managed objects of AM on its own connection of the private session bus.
+class FakeObjectManager : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.desktopspec.DBus.ObjectManager")
+public:
+    explicit FakeObjectManager(const QDBusConnection &connection)
+        : m_connection(connection)
+    {
+        m_connection.registerObject(AMPath, this, QDBusConnection::ExportAllSlots | QDBusConnection::ExportAllSignals);
+        m_connection.registerService(AMService);
+    }
+
+    ~FakeObjectManager() override
+    {
+        m_connection.unregisterService(AMService);
+        m_connection.unregisterObject(AMPath);
+    }
+
+    static QDBusObjectPath appPath(const QString &desktopId)
+    {
+        return QDBusObjectPath(AMPath + "/" + desktopId);
+    }
+
+    static ObjectInterfaceMap appInterfaces(const QString &name)
+    {
+        QVariantMap appInfo;
+        appInfo.insert("Name", QVariant::fromValue(QStringMap {{"default", name}}));
+        appInfo.insert("NoDisplay", false);
+        return {{"org.desktopspec.ApplicationManager1.Application", appInfo}};
+    }
+
+    ObjectMap m_objects;
+
+public Q_SLOTS:
+    ObjectMap GetManagedObjects()
+    {
+        return m_objects;
+    }
+
+Q_SIGNALS:
+    void InterfacesAdded(const QDBusObjectPath &object_path, const ObjectInterfaceMap &interfaces);
+    void InterfacesRemoved(const QDBusObjectPath &object_path, const QStringList &interfaces);
+
+private:
+    QDBusConnection m_connection;
+};
+
+class AMAppItemModelTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_manager = new FakeObjectManager(QDBusConnection::connectToBus(QDBusConnection::SessionBus, "fake-am"));
+        for (const auto &id : {"app1", "app2", "app3"}) {
+            m_manager->m_objects.insert(FakeObjectManager::appPath(id), FakeObjectManager::appInterfaces(QString("Name of %1").arg(id)));
+        }
+    }
+
+    void TearDown() override
+    {
+        delete m_manager;
+        QDBusConnection::disconnectFromBus("fake-am");
+    }
+
+    FakeObjectManager *m_manager = nullptr;
+};
+
+TEST_F(AMAppItemModelTest, LoadInOneBatch) {
+    AMAppItemModel model;
+    QSignalSpy spy(&model, &QAbstractItemModel::rowsInserted);
+    ASSERT_TRUE(spy.wait(5000));
+
+    EXPECT_EQ(spy.count(), 1);
+    EXPECT_EQ(model.rowCount(), 3);
+    for (const auto &id : {"app1", "app2", "app3"}) {
+        auto item = model.appItem(id);
+        ASSERT_NE(item, nullptr);
+        EXPECT_EQ(item->appName(), QString("Name of %1").arg(id));
+    }
+    EXPECT_EQ(model.appItem("app4"), nullptr);
+}
+
+TEST_F(AMAppItemModelTest, AddAndRemove) {
+    AMAppItemModel model;
+    QSignalSpy insertedSpy(&model, &QAbstractItemModel::rowsInserted);
+    ASSERT_TRUE(insertedSpy.wait(5000));
+
+    Q_EMIT m_manager->InterfacesAdded(FakeObjectManager::appPath("app4"), FakeObjectManager::appInterfaces("Name of app4"));
+    ASSERT_TRUE(insertedSpy.wait(5000));
+    EXPECT_EQ(model.rowCount(), 4);
+    ASSERT_NE(model.appItem("app4"), nullptr);
+
+    // an added application which exists already is ignored.
+    Q_EMIT m_manager->InterfacesAdded(FakeObjectManager::appPath("app1"), FakeObjectManager::appInterfaces("Name of app1"));
+
+    QSignalSpy removedSpy(&model, &QAbstractItemModel::rowsRemoved);
+    Q_EMIT m_manager->InterfacesRemoved(FakeObjectManager::appPath("app2"), {"org.desktopspec.ApplicationManager1.Application"});
+    ASSERT_TRUE(removedSpy.wait(5000));
+    EXPECT_EQ(model.rowCount(), 3);
+    EXPECT_EQ(model.appItem("app2"), nullptr);
+
+    // the rows after the removed one are still found.
+    for (const auto &id : {"app1", "app3", "app4"}) {
+        auto item = model.appItem(id);
+        ASSERT_NE(item, nullptr);
+        EXPECT_EQ(model.indexFromItem(item).data(AppItemModel::DesktopIdRole).toString(), QString(id));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    qDBusRegisterMetaType<QStringMap>();
+    qDBusRegisterMetaType<ObjectInterfaceMap>();
+    qDBusRegisterMetaType<ObjectMap>();
+
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+#include "amappitemmodeltests.moc"
@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+
+#include <iostream>
+
+#include "appssearchindex.h"
+
+using namespace apps;
+
+static QStringList desktopIds(const QList<AppsSearchIndex::Hit> &hits)
+{
+    QStringList ids;
+    for (const auto &hit : hits)
+        ids.append(hit.desktopId);
+    return ids;
+}
+
+static AppsSearchIndex sampleIndex()
+{
+    AppsSearchIndex index;
+    index.insert(AppsSearchIndex::makeEntry("code.desktop", "Visual Studio Code", "Text Editor"));
+    index.insert(AppsSearchIndex::makeEntry("org.kde.kate.desktop", "Kate", "Advanced Text Editor"));
+    index.insert(AppsSearchIndex::makeEntry("firefox.desktop", "Firefox", "Web Browser"));
+    index.insert(AppsSearchIndex::makeEntry("deepin-terminal.desktop", "终端", "Terminal"));
+    index.insert(AppsSearchIndex::makeEntry("org.gnome.Calculator.desktop", "Calculator", ""));
+    return index;
+}
+
+TEST(AppsSearchIndex, Matches)
+{
+    const auto index = sampleIndex();
+    EXPECT_EQ(index.count(), 5);
+
+    EXPECT_EQ(desktopIds(index.search("fire", 10)), QStringList {"firefox.desktop"});
+    EXPECT_EQ(desktopIds(index.search("studio", 10)), QStringList {"code.desktop"});
+    EXPECT_EQ(desktopIds(index.search("vsc", 10)), QStringList {"code.desktop"});
+    EXPECT_EQ(desktopIds(index.search("browser", 10)), QStringList {"firefox.desktop"});
+    EXPECT_EQ(desktopIds(index.search("gnome", 10)), QStringList {"org.gnome.Calculator.desktop"});
+    EXPECT_EQ(desktopIds(index.search("zhongduan", 10)), QStringList {"deepin-terminal.desktop"});
+    EXPECT_EQ(desktopIds(index.search("zd", 10)), QStringList {"deepin-terminal.desktop"});
+    // a subsequence of the name, it's only looked for when nothing else matches.
+    EXPECT_EQ(desktopIds(index.search("clcltr", 10)), QStringList {"org.gnome.Calculator.desktop"});
+    EXPECT_EQ(desktopIds(index.search("calc", 10)), QStringList {"org.gnome.Calculator.desktop"});
+
+    EXPECT_TRUE(index.search("", 10).isEmpty());
+    EXPECT_TRUE(index.search("nothing", 10).isEmpty());
+    EXPECT_TRUE(index.search("fire", 0).isEmpty());
+}
+
+TEST(AppsSearchIndex, Ranking)
+{
+    const auto index = sampleIndex();
+
+    EXPECT_EQ(desktopIds(index.search("kate", 10)), QStringList {"org.kde.kate.desktop"});
+    // the same score is ordered by desktop id.
+    EXPECT_EQ(desktopIds(index.search("editor", 10)), (QStringList {"code.desktop", "org.kde.kate.desktop"}));
+    // the name matches before the generic name.
+    const auto ids = desktopIds(index.search("te", 10));
+    EXPECT_EQ(ids.first(), "org.kde.kate.desktop");
+    EXPECT_TRUE(ids.contains("deepin-terminal.desktop"));
+
+    // launched times are blended into the score.
+    const auto hits = index.search("editor", 10, [](const QString &desktopId) -> quint64 {
+        return desktopId == "org.kde.kate.desktop" ? 100 : 0;
+    });
+    EXPECT_EQ(desktopIds(hits), (QStringList {"org.kde.kate.desktop", "code.desktop"}));
+
+    EXPECT_EQ(index.search("e", 2).size(), 2);
+}
+
+TEST(AppsSearchIndex, Update)
+{
+    auto index = sampleIndex();
+
+    index.insert(AppsSearchIndex::makeEntry("firefox.desktop", "Firefox ESR", "Web Browser"));
+    EXPECT_EQ(index.count(), 5);
+    EXPECT_EQ(desktopIds(index.search("esr", 10)), QStringList {"firefox.desktop"});
+
+    index.remove("firefox.desktop");
+    EXPECT_FALSE(index.contains("firefox.desktop"));
+    EXPECT_TRUE(index.search("firefox", 10).isEmpty());
+
+    // removed slots are released once they're the most of the index.
+    for (int i = 0; i < 200; ++i)
+        index.insert(AppsSearchIndex::makeEntry(QString("app%1.desktop").arg(i), QString("Application %1").arg(i), ""));
+    for (int i = 0; i < 190; ++i)
+        index.remove(QString("app%1.desktop").arg(i));
+    EXPECT_EQ(index.count(), 14);
+    EXPECT_EQ(desktopIds(index.search("application 195", 10)), QStringList {"app195.desktop"});
+    EXPECT_EQ(desktopIds(index.search("kate", 10)), QStringList {"org.kde.kate.desktop"});
+}
+
+TEST(AppsSearchIndex, Benchmark)
+{
+    static const QStringList Words {
+        "audio", "browser", "calendar", "disk", "editor", "file", "game", "image", "mail", "manager",
+        "music", "office", "player", "reader", "screen", "system", "terminal", "video", "viewer", "writer",
+    };
+
+    QRandomGenerator random(2024);
+    const auto word = [&random]() {
+        return Words.at(random.bounded(int(Words.size())));
+    };
+
+    AppsSearchIndex index;
+    for (int i = 0; i < 2000; ++i) {
+        const auto name = QString("%1 %2 %3").arg(word(), word()).arg(i);
+        index.insert(AppsSearchIndex::makeEntry(QString("org.example.app%1.desktop").arg(i), name, word() + " " + word()));
+    }
+    ASSERT_EQ(index.count(), 2000);
+
+    const QStringList queries {"m", "vi", "edi", "music pl", "terminal 1999", "sysvw", "org.example", "nothing"};
+    const int rounds = 50;
+    QElapsedTimer timer;
+    timer.start();
+    for (int round = 0; round < rounds; ++round) {
+        for (const auto &query : queries)
+            index.search(query, 50, [](const QString &) -> quint64 { return 1; });
+    }
+    const double averageUs = timer.nsecsElapsed() / 1000.0 / (rounds * queries.size());
+    std::cout << "average query time over 2000 applications: " << averageUs << " us" << std::endl;
+    RecordProperty("averageQueryUs", QString::number(averageUs, 'f', 1).toStdString());
+    // far above the cost of the n-gram candidates, it fails when the queries scan every application.
+    EXPECT_LT(averageUs, 1000.0);
+}
@@ -0,0 +1,210 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGuiApplication>
+#include <QIcon>
+#include <QImage>
+#include <QQuickImageProvider>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QThread>
+
+#include <iostream>
+#include <memory>
+
+#include "iconcache.h"
+
+DS_USE_NAMESPACE
+
+static const QString ThemeName = "ds-test";
+static const int IconCount = 50;
+
+// a minimal icon theme with `IconCount` application icons, so the lookup doesn't depend on the system.
+static bool createIconTheme(const QString &path)
+{
+    QDir dir(path);
+    if (!dir.mkpath(ThemeName + "/apps/64"))
+        return false;
+
+    QFile index(dir.filePath(ThemeName + "/index.theme"));
+    if (!index.open(QIODevice::WriteOnly))
+        return false;
+    index.write("[Icon Theme]\nName=ds-test\nDirectories=apps/64\n\n[apps/64]\nSize=64\nType=Fixed\n");
+
+    for (int i = 0; i < IconCount; ++i) {
+        QImage image(64, 64, QImage::Format_ARGB32);
+        image.fill(QColor::fromHsv(i * 7 % 360, 200, 200));
+        if (!image.save(dir.filePath(QString("%1/apps/64/test-icon-%2.png").arg(ThemeName).arg(i))))
+            return false;
+    }
+    return true;
+}
+
+class IconCacheTest : public testing::Test
+{
+protected:
+    static void SetUpTestSuite()
+    {
+        s_themeDir = new QTemporaryDir();
+        ASSERT_TRUE(createIconTheme(s_themeDir->path()));
+        QIcon::setThemeSearchPaths({s_themeDir->path()});
+        QIcon::setThemeName(ThemeName);
+    }
+
+    static void TearDownTestSuite()
+    {
+        delete s_themeDir;
+        s_themeDir = nullptr;
+    }
+
+    void SetUp() override
+    {
+        DIconCache::instance()->invalidate();
+    }
+
+    static QTemporaryDir *s_themeDir;
+};
+
+QTemporaryDir *IconCacheTest::s_themeDir = nullptr;
+
+TEST_F(IconCacheTest, Image)
+{
+    auto cache = DIconCache::instance();
+    const auto image = cache->image("test-icon-0", QSize(32, 32));
+    ASSERT_FALSE(image.isNull());
+    EXPECT_EQ(image.size(), QSize(32, 32));
+    EXPECT_EQ(cache->imageCount(), 1);
+
+    // a hit shares the rasterized image.
+    EXPECT_EQ(cache->image("test-icon-0", QSize(32, 32)).cacheKey(), image.cacheKey());
+    EXPECT_EQ(cache->imageCount(), 1);
+
+    EXPECT_EQ(cache->image("test-icon-0", QSize(32, 32), 2.0).size(), QSize(64, 64));
+    EXPECT_EQ(cache->imageCount(), 2);
+
+    EXPECT_TRUE(cache->image("missing-icon", QSize(32, 32)).isNull());
+    EXPECT_EQ(cache->imageCount(), 3);
+    EXPECT_TRUE(cache->image("", QSize(32, 32)).isNull());
+    EXPECT_TRUE(cache->image("test-icon-0", QSize()).isNull());
+}
+
+TEST_F(IconCacheTest, Invalidate)
+{
+    auto cache = DIconCache::instance();
+    QSignalSpy spy(cache, &DIconCache::invalidated);
+    const auto image = cache->image("test-icon-0", QSize(32, 32));
+    ASSERT_EQ(cache->imageCount(), 1);
+
+    cache->invalidate();
+    EXPECT_EQ(spy.count(), 1);
+    EXPECT_EQ(cache->imageCount(), 0);
+    EXPECT_NE(cache->image("test-icon-0", QSize(32, 32)).cacheKey(), image.cacheKey());
+}
+
+TEST_F(IconCacheTest, IconName)
+{
+    auto cache = DIconCache::instance();
+    EXPECT_EQ(cache->iconName("test-icon-1"), "test-icon-1");
+    EXPECT_EQ(cache->iconName("missing-icon", "test-icon-1"), "test-icon-1");
+    EXPECT_TRUE(cache->iconName("missing-icon").isEmpty());
+}
+
+TEST_F(IconCacheTest, ImageDataUrl)
+{
+    auto cache = DIconCache::instance();
+    QImage image(16, 16, QImage::Format_ARGB32);
+    image.fill(Qt::red);
+
+    const auto url = cache->imageDataUrl(image);
+    ASSERT_TRUE(url.startsWith("data:image/png;base64,"));
+    EXPECT_EQ(cache->imageDataUrl(image.copy()), url);
+
+    const auto decoded = QImage::fromData(QByteArray::fromBase64(url.mid(url.indexOf(',') + 1).toLatin1()));
+    EXPECT_EQ(decoded.size(), image.size());
+
+    image.fill(Qt::blue);
+    EXPECT_NE(cache->imageDataUrl(image), url);
+    EXPECT_TRUE(cache->imageDataUrl(QImage()).isEmpty());
+}
+
+static QImage requestImage(QQuickAsyncImageProvider *provider, const QString &id, const QSize &requestedSize)
+{
+    std::unique_ptr<QQuickImageResponse> response(provider->requestImageResponse(id, requestedSize));
+    // the response is finished from the event loop of the cache, not within the request.
+    QSignalSpy spy(response.get(), &QQuickImageResponse::finished);
+    EXPECT_EQ(spy.count(), 0);
+    if (!spy.wait())
+        return QImage();
+    std::unique_ptr<QQuickTextureFactory> factory(response->textureFactory());
+    return factory ? factory->image() : QImage();
+}
+
+TEST_F(IconCacheTest, ImageProvider)
+{
+    std::unique_ptr<QQuickAsyncImageProvider> provider(DIconCache::createImageProvider());
+    EXPECT_EQ(requestImage(provider.get(), "test-icon-2", QSize(48, 48)).size(), QSize(48, 48));
+    EXPECT_EQ(requestImage(provider.get(), "test-icon-2", QSize(24, 0)).size(), QSize(24, 24));
+    EXPECT_EQ(requestImage(provider.get(), "test-icon-2", QSize()).size(), QSize(64, 64));
+    // the size of the query is used when no size is requested.
+    EXPECT_EQ(requestImage(provider.get(), "test-icon-2?size=32", QSize()).size(), QSize(32, 32));
+    EXPECT_EQ(requestImage(provider.get(), "test-icon-2?size=32", QSize(16, 16)).size(), QSize(16, 16));
+    EXPECT_TRUE(requestImage(provider.get(), "missing-icon", QSize(48, 48)).isNull());
+}
+
+TEST_F(IconCacheTest, CachedImage)
+{
+    auto cache = DIconCache::instance();
+    QImage image;
+    EXPECT_FALSE(cache->cachedImage("test-icon-3", QSize(32, 32), 1.0, &image));
+    const auto loaded = cache->image("test-icon-3", QSize(32, 32));
+
+    // a lookup from another thread only reads the cache.
+    bool found = false;
+    std::unique_ptr<QThread> thread(QThread::create([&]() {
+        found = cache->cachedImage("test-icon-3", QSize(32, 32), 1.0, &image);
+        EXPECT_TRUE(cache->image("test-icon-4", QSize(32, 32)).isNull());
+    }));
+    thread->start();
+    ASSERT_TRUE(thread->wait(5000));
+    EXPECT_TRUE(found);
+    EXPECT_EQ(image.cacheKey(), loaded.cacheKey());
+    EXPECT_FALSE(cache->cachedImage("test-icon-4", QSize(32, 32), 1.0, nullptr));
+}
+
+TEST_F(IconCacheTest, Benchmark)
+{
+    auto cache = DIconCache::instance();
+    const QSize size(48, 48);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < IconCount; ++i)
+        cache->image(QString("test-icon-%1").arg(i), size);
+    const double coldUs = timer.nsecsElapsed() / 1000.0 / IconCount;
+
+    const int rounds = 100;
+    timer.restart();
+    for (int round = 0; round < rounds; ++round) {
+        for (int i = 0; i < IconCount; ++i)
+            cache->image(QString("test-icon-%1").arg(i), size);
+    }
+    const double warmUs = timer.nsecsElapsed() / 1000.0 / (IconCount * rounds);
+
+    std::cout << "icon lookup, cold: " << coldUs << " us, warm: " << warmUs << " us" << std::endl;
+    RecordProperty("coldUs", QString::number(coldUs, 'f', 1).toStdString());
+    RecordProperty("warmUs", QString::number(warmUs, 'f', 1).toStdString());
+    EXPECT_EQ(cache->imageCount(), IconCount);
+}
+
+int main(int argc, char **argv)
+{
+    QGuiApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
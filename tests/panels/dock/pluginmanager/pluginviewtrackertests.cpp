@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <QGuiApplication>
+#include <QQuickItem>
+
+#include "pluginviewtracker.h"
+
+TEST(PluginViewTracker, HiddenAndShownAgain)
+{
+    QQuickItem parent;
+    auto item = new QQuickItem(&parent);
+    PluginViewTracker tracker;
+
+    // a shown item keeps its view on the output.
+    EXPECT_FALSE(tracker.update(item));
+    EXPECT_FALSE(tracker.isHidden(item));
+
+    // hiding an ancestor hides the item, its view is taken off until it's shown again.
+    parent.setVisible(false);
+    EXPECT_TRUE(tracker.update(item));
+    EXPECT_TRUE(tracker.isHidden(item));
+    EXPECT_FALSE(tracker.update(item));
+    EXPECT_FALSE(tracker.update(item));
+    EXPECT_EQ(tracker.hiddenFrames(item), 2u);
+
+    parent.setVisible(true);
+    EXPECT_TRUE(tracker.update(item));
+    EXPECT_FALSE(tracker.isHidden(item));
+    EXPECT_FALSE(tracker.update(item));
+
+    // a transparent item is hidden as well.
+    item->setOpacity(0);
+    EXPECT_TRUE(tracker.update(item));
+    EXPECT_TRUE(tracker.isHidden(item));
+    item->setOpacity(1);
+    EXPECT_TRUE(tracker.update(item));
+    EXPECT_FALSE(tracker.isHidden(item));
+}
+
+TEST(PluginViewTracker, HiddenWhenTracked)
+{
+    QQuickItem item;
+    item.setVisible(false);
+    PluginViewTracker tracker;
+
+    EXPECT_TRUE(tracker.update(&item));
+    EXPECT_TRUE(tracker.isHidden(&item));
+
+    tracker.remove(&item);
+    EXPECT_FALSE(tracker.isHidden(&item));
+    EXPECT_EQ(tracker.hiddenFrames(&item), 0u);
+}
+
+int main(int argc, char **argv)
+{
+    QGuiApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include "trayitempositionmanager.h"
+
+using docktray::TrayItemPositionManager;
+
+// the default item is 24x24 and the spacing between items is 2.
+static void setupLayout(Qt::Orientation orientation, int visualItemCount, const QList<QSize> &sizes)
+{
+    auto &manager = TrayItemPositionManager::instance();
+    manager.setProperty("orientation", QVariant::fromValue(orientation));
+    manager.setProperty("dockHeight", 40);
+    for (int i = 0; i < sizes.count(); i++) {
+        manager.registerVisualItemSize(i, sizes.at(i));
+    }
+    manager.setProperty("visualItemCount", visualItemCount);
+}
+
+TEST(TrayItemPositionManager, HorizontalVisualSize) {
+    setupLayout(Qt::Horizontal, 3, {QSize(24, 24), QSize(40, 24), QSize(24, 24)});
+    auto &manager = TrayItemPositionManager::instance();
+
+    EXPECT_EQ(manager.visualSize(-1), QSize(0, 40));
+    EXPECT_EQ(manager.visualSize(0), QSize(26, 40));
+    EXPECT_EQ(manager.visualSize(0, false), QSize(26, 40));
+    EXPECT_EQ(manager.visualSize(1), QSize(68, 40));
+    EXPECT_EQ(manager.visualSize(2, false), QSize(92, 40));
+    EXPECT_EQ(manager.property("visualSize").toSize(), QSize(92, 40));
+
+    // the registered size is changed, the cached extents are rebuilt.
+    manager.registerVisualItemSize(0, QSize(30, 24));
+    EXPECT_EQ(manager.visualSize(2, false), QSize(98, 40));
+    EXPECT_EQ(manager.property("visualSize").toSize(), QSize(98, 40));
+    manager.registerVisualItemSize(0, QSize(24, 24));
+}
+
+TEST(TrayItemPositionManager, HorizontalItemIndexByPoint) {
+    setupLayout(Qt::Horizontal, 3, {QSize(24, 24), QSize(40, 24), QSize(24, 24)});
+    auto &manager = TrayItemPositionManager::instance();
+
+    auto dropIndex = manager.itemIndexByPoint(QPoint(0, 0));
+    EXPECT_EQ(dropIndex.index, 0);
+    EXPECT_TRUE(dropIndex.isOnItem);
+    EXPECT_TRUE(dropIndex.isBefore);
+
+    dropIndex = manager.itemIndexByPoint(QPoint(30, 0));
+    EXPECT_EQ(dropIndex.index, 1);
+    EXPECT_TRUE(dropIndex.isOnItem);
+    EXPECT_TRUE(dropIndex.isBefore);
+
+    dropIndex = manager.itemIndexByPoint(QPoint(50, 0));
+    EXPECT_EQ(dropIndex.index, 1);
+    EXPECT_TRUE(dropIndex.isOnItem);
+    EXPECT_FALSE(dropIndex.isBefore);
+
+    // on the spacing after the second item.
+    dropIndex = manager.itemIndexByPoint(QPoint(67, 0));
+    EXPECT_EQ(dropIndex.index, 1);
+    EXPECT_FALSE(dropIndex.isOnItem);
+
+    dropIndex = manager.itemIndexByPoint(QPoint(200, 0));
+    EXPECT_EQ(dropIndex.index, 2);
+}
+
+TEST(TrayItemPositionManager, VerticalVisualSize) {
+    setupLayout(Qt::Vertical, 2, {QSize(24, 30), QSize(24, 24), QSize(24, 24)});
+    auto &manager = TrayItemPositionManager::instance();
+
+    EXPECT_EQ(manager.visualSize(0), QSize(40, 32));
+    EXPECT_EQ(manager.visualSize(1, false), QSize(40, 56));
+    EXPECT_EQ(manager.property("visualSize").toSize(), QSize(40, 56));
+    // the items which aren't registered take the default size.
+    EXPECT_EQ(manager.visualSize(4), QSize(40, 32 + 4 * 26));
+}
+
+TEST(TrayItemPositionManager, VerticalItemIndexByPoint) {
+    setupLayout(Qt::Vertical, 2, {QSize(24, 30), QSize(24, 24), QSize(24, 24)});
+    auto &manager = TrayItemPositionManager::instance();
+
+    auto dropIndex = manager.itemIndexByPoint(QPoint(0, 31));
+    EXPECT_EQ(dropIndex.index, 0);
+    EXPECT_FALSE(dropIndex.isOnItem);
+
+    dropIndex = manager.itemIndexByPoint(QPoint(0, 40));
+    EXPECT_EQ(dropIndex.index, 1);
+    EXPECT_TRUE(dropIndex.isOnItem);
+    EXPECT_TRUE(dropIndex.isBefore);
+
+    // after the last visual item, it mustn't return the index of a registered but invisible item.
+    dropIndex = manager.itemIndexByPoint(QPoint(0, 60));
+    EXPECT_EQ(dropIndex.index, 1);
+}
@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QTemporaryDir>
+
+#include <memory>
+
+#include "dataaccessorproxy.h"
+#include "dbaccessor.h"
+
+using namespace notification;
+
+static NotifyEntity createEntity(uint bubbleId, const QString &appName, int processedType)
+{
+    NotifyEntity entity(appName, 0, QString(), "Summary", "Body", {}, {}, -1);
+    entity.setAppId(appName);
+    entity.setBubbleId(bubbleId);
+    entity.setProcessedType(processedType);
+    return entity;
+}
+
+class DataAccessorProxyTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(m_dir.isValid());
+        qputenv("DS_NOTIFICATION_DB_PATH", m_dir.filePath("data.db").toUtf8());
+        const auto info = testing::UnitTest::GetInstance()->current_test_info();
+        m_db = std::make_unique<DBAccessor>(QString("%1.%2").arg(info->test_suite_name(), info->name()));
+        ASSERT_TRUE(m_db->isValid());
+
+        m_proxy = DataAccessorProxy::instance();
+        m_proxy->setSource(m_db.get());
+    }
+
+    void TearDown() override
+    {
+        m_proxy->clear();
+        m_proxy->setSource(nullptr);
+    }
+
+    // a pending bubble is kept in memory, its id is the bubble id.
+    qint64 addPendingEntity(uint bubbleId, const QString &appName)
+    {
+        auto entity = createEntity(bubbleId, appName, NotifyEntity::NotProcessed);
+        entity.setId(bubbleId);
+        return m_proxy->addEntity(entity);
+    }
+
+    QTemporaryDir m_dir;
+    std::unique_ptr<DBAccessor> m_db;
+    DataAccessorProxy *m_proxy = nullptr;
+};
+
+TEST_F(DataAccessorProxyTest, RemoveProcessedKeepsPendingBubble)
+{
+    const auto rowId = m_proxy->addEntity(createEntity(100, "deepin-mail", NotifyEntity::Processed));
+    ASSERT_GT(rowId, 0);
+    // the pending bubble has the same id as the row of the processed notify.
+    ASSERT_EQ(addPendingEntity(rowId, "deepin-mail"), rowId);
+
+    const auto ids = m_proxy->fetchEntityIds("deepin-mail", NotifyEntity::Processed);
+    ASSERT_EQ(ids, QList<qint64> {rowId});
+    m_proxy->removeEntities(ids, NotifyEntity::Processed);
+
+    EXPECT_EQ(m_proxy->fetchEntityCount("deepin-mail", NotifyEntity::Processed), 0);
+    EXPECT_EQ(m_proxy->fetchEntityCount("deepin-mail", NotifyEntity::NotProcessed), 1);
+    EXPECT_TRUE(m_proxy->fetchLastEntity(rowId).isValid());
+}
+
+TEST_F(DataAccessorProxyTest, RemoveEntitiesRoutesEachId)
+{
+    const auto rowId = m_proxy->addEntity(createEntity(100, "deepin-mail", NotifyEntity::Processed));
+    ASSERT_GT(rowId, 0);
+    ASSERT_EQ(addPendingEntity(rowId, "deepin-terminal"), rowId);
+
+    // the id resolves to the pending bubble, like `fetchEntity` does, the row isn't touched.
+    ASSERT_EQ(m_proxy->fetchEntity(rowId).appName(), "deepin-terminal");
+    m_proxy->removeEntities({rowId});
+
+    EXPECT_EQ(m_proxy->fetchEntityCount("deepin-terminal", NotifyEntity::NotProcessed), 0);
+    EXPECT_EQ(m_proxy->fetchEntityCount("deepin-mail", NotifyEntity::Processed), 1);
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
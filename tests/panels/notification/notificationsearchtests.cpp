@@ -0,0 +1,156 @@
+// SPDX-FileCopyrightText: 2024 UnionTech Software Technology Co., Ltd.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+
+#include "dbaccessor.h"
+#include "memoryaccessor.h"
+
+using namespace notification;
+
+static NotifyEntity createEntity(qint64 id, const QString &appName, const QString &summary, const QString &body)
+{
+    NotifyEntity entity(appName, 0, QString(), summary, body, {}, {}, -1);
+    entity.setId(id);
+    entity.setAppId(appName);
+    entity.setCTime(id);
+    entity.setProcessedType(NotifyEntity::Processed);
+    return entity;
+}
+
+static QList<qint64> entityIds(const QList<NotifySearchHit> &hits)
+{
+    QList<qint64> ids;
+    for (const auto &hit : hits)
+        ids.append(hit.entity.id());
+    return ids;
+}
+
+class NotificationSearchTest : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(m_dir.isValid());
+        qputenv("DS_NOTIFICATION_DB_PATH", m_dir.filePath("data.db").toUtf8());
+        const auto info = testing::UnitTest::GetInstance()->current_test_info();
+        m_db = std::make_unique<DBAccessor>(QString("%1.%2").arg(info->test_suite_name(), info->name()));
+        ASSERT_TRUE(m_db->isValid());
+    }
+
+    void addEntities(const QList<NotifyEntity> &entities)
+    {
+        m_db->addEntities(entities);
+        m_memory.addEntities(entities);
+    }
+
+    QTemporaryDir m_dir;
+    std::unique_ptr<DBAccessor> m_db;
+    MemoryAccessor m_memory;
+};
+
+TEST_F(NotificationSearchTest, Search)
+{
+    addEntities({
+        createEntity(1, "deepin-mail", "New mail", "Meeting at ten tomorrow"),
+        createEntity(2, "deepin-terminal", "Build finished", "The build of dde-shell finished"),
+        createEntity(3, "deepin-mail", "Reminder", "The meeting moved to eleven"),
+    });
+
+    for (DataAccessor *accessor : std::initializer_list<DataAccessor *> {m_db.get(), &m_memory}) {
+        auto ids = entityIds(accessor->searchEntities("meeting", NotifyEntity::Processed, 0, 10));
+        std::sort(ids.begin(), ids.end());
+        EXPECT_EQ(ids, (QList<qint64> {1, 3}));
+        // every term has to match.
+        EXPECT_EQ(entityIds(accessor->searchEntities("meeting eleven", NotifyEntity::Processed, 0, 10)), QList<qint64> {3});
+        EXPECT_EQ(accessor->searchEntities("meeting", NotifyEntity::Processed, 0, 1).size(), 1);
+        EXPECT_EQ(accessor->searchEntities("meeting", NotifyEntity::Processed, 1, 10).size(), 1);
+        EXPECT_TRUE(accessor->searchEntities("meeting", NotifyEntity::NotProcessed, 0, 10).isEmpty());
+        EXPECT_TRUE(accessor->searchEntities("nothing", NotifyEntity::Processed, 0, 10).isEmpty());
+        EXPECT_TRUE(accessor->searchEntities(" ", NotifyEntity::Processed, 0, 10).isEmpty());
+    }
+}
+
+TEST_F(NotificationSearchTest, Snippet)
+{
+    addEntities({
+        createEntity(1, "deepin-terminal", "Build finished", "The build of dde-shell finished without errors"),
+    });
+
+    // the terms are marked the same whichever backend or path answers the search.
+    for (const auto &text : {QString("build"), QString("dde"), QString("bu")}) {
+        const auto hits = m_db->searchEntities(text, NotifyEntity::Processed, 0, 10);
+        const auto memoryHits = m_memory.searchEntities(text, NotifyEntity::Processed, 0, 10);
+        ASSERT_EQ(hits.size(), 1) << text.toStdString();
+        ASSERT_EQ(memoryHits.size(), 1) << text.toStdString();
+        EXPECT_TRUE(hits.first().snippet.contains("<b>")) << hits.first().snippet.toStdString();
+        EXPECT_TRUE(memoryHits.first().snippet.contains("<b>")) << memoryHits.first().snippet.toStdString();
+    }
+
+    const auto entity = createEntity(2, "app", "Summary", QString("word ").repeated(40) + "target " + QString("word ").repeated(40));
+    const auto snippet = DataAccessor::searchSnippet(entity, {"TARGET"});
+    EXPECT_TRUE(snippet.startsWith("...")) << snippet.toStdString();
+    EXPECT_TRUE(snippet.endsWith("...")) << snippet.toStdString();
+    EXPECT_TRUE(snippet.contains("<b>target</b>")) << snippet.toStdString();
+
+    EXPECT_EQ(DataAccessor::searchSnippet(entity, {"word", "or"}).count("<b>"), DataAccessor::searchSnippet(entity, {"word"}).count("<b>"));
+    EXPECT_EQ(DataAccessor::searchSnippet(createEntity(3, "app", "Summary", "Short body"), {"body"}), "Short <b>body</b>");
+}
+
+TEST_F(NotificationSearchTest, Benchmark)
+{
+    static const QStringList Apps {
+        "dde-file-manager", "deepin-music", "deepin-terminal", "deepin-movie", "deepin-editor",
+        "dde-control-center", "deepin-mail", "deepin-calendar", "deepin-screen-recorder", "deepin-system-monitor",
+    };
+    static const QStringList Words {
+        "audio", "browser", "calendar", "disk", "editor", "file", "game", "image", "mail", "manager",
+        "music", "office", "player", "reader", "screen", "system", "terminal", "video", "viewer", "writer",
+    };
+    const int count = 100000;
+
+    QList<NotifyEntity> entities;
+    entities.reserve(count);
+    for (int i = 1; i <= count; ++i) {
+        const auto &word = Words.at(i % Words.size());
+        entities.append(createEntity(i, Apps.at(i % Apps.size()), QString("%1 task %2").arg(word).arg(i),
+                                     QString("The %1 of %2 finished").arg(Words.at(i * 7 % Words.size())).arg(word)));
+    }
+    m_db->addEntities(entities);
+    ASSERT_EQ(m_db->fetchEntityCount(DataAccessor::AllApp(), NotifyEntity::Processed), count);
+
+    // selective terms match a handful of rows, common terms match thousands of rows, and a two
+    // characters prefix is shorter than a trigram.
+    const QStringList queries {"4242", "99999", "12345", "video 7777", "video", "file manager", "vi"};
+    const int rounds = 5;
+    QElapsedTimer timer;
+    qint64 totalNsecs = 0;
+    for (const auto &query : queries) {
+        timer.start();
+        for (int round = 0; round < rounds; ++round)
+            EXPECT_FALSE(m_db->searchEntities(query, NotifyEntity::Processed, 0, 50).isEmpty()) << query.toStdString();
+        const auto nsecs = timer.nsecsElapsed();
+        totalNsecs += nsecs;
+        std::cout << "average search time of \"" << query.toStdString() << "\": " << nsecs / 1000000.0 / rounds << " ms" << std::endl;
+    }
+    const double averageMs = totalNsecs / 1000000.0 / (rounds * queries.size());
+    std::cout << "average search time over " << count << " notifications: " << averageMs << " ms" << std::endl;
+    RecordProperty("averageSearchMs", QString::number(averageMs, 'f', 1).toStdString());
+    EXPECT_LT(averageMs, 10.0);
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}